@@ -8,6 +8,31 @@ import (
 	"strings"
 )
 
+// ISA strings the core can execute; -mabi stays ilp32 for all of them.
+var supportedMarch = map[string]struct{}{
+	"rv32i":   {},
+	"rv32ia":  {},
+	"rv32ic":  {},
+	"rv32iac": {},
+}
+
+// C++ firmware is freestanding: no exceptions, RTTI, thread-safe static
+// guards or libstdc++. The SDK runtime stubs the few ABI hooks left.
+var cxxFlags = []string{
+	"-std=c++17",
+	"-fno-exceptions",
+	"-fno-rtti",
+	"-fno-threadsafe-statics",
+}
+
+func isCxxSource(path string) bool {
+	switch strings.ToLower(filepath.Ext(path)) {
+	case ".cpp", ".cc", ".cxx":
+		return true
+	}
+	return false
+}
+
 func buildFromC(cfg *buildConfig) error {
 	tempDir, err := os.MkdirTemp("", "qar-cbuild")
 	if err != nil {
@@ -38,31 +63,104 @@ func buildFromC(cfg *buildConfig) error {
 	if cfg.ldFlags != "" {
 		ldFlags = append(ldFlags, strings.Fields(cfg.ldFlags)...)
 	}
-	if len(cfg.cPaths) > 0 {
-		fmt.Printf("Compiling %d C source(s): %s\n", len(cfg.cPaths), strings.Join(cfg.cPaths, ", "))
+	march := cfg.march
+	if march == "" {
+		march = "rv32ia"
+	}
+	if _, ok := supportedMarch[march]; !ok {
+		return fmt.Errorf("unsupported --march %q (core implements rv32i, rv32ia, rv32ic, rv32iac)", march)
 	}
-	args := []string{
+	var cSources, cxxSources []string
+	for _, path := range cfg.cPaths {
+		if isCxxSource(path) {
+			cxxSources = append(cxxSources, path)
+		} else {
+			cSources = append(cSources, path)
+		}
+	}
+	if len(cSources) > 0 {
+		fmt.Printf("Compiling %d C source(s): %s\n", len(cSources), strings.Join(cSources, ", "))
+	}
+	if len(cxxSources) > 0 {
+		fmt.Printf("Compiling %d C++ source(s): %s\n", len(cxxSources), strings.Join(cxxSources, ", "))
+	}
+	commonFlags := []string{
 		"-Os",
+		"-march=" + march,
+		"-mabi=ilp32",
+		"-I", "devkit",
+	}
+	if cfg.preloaded {
+		commonFlags = append(commonFlags, "-DQAR_DATA_PRELOADED")
+	}
+	if cfg.layout != "" {
+		if cfg.icacheEntries < 0 || cfg.icacheEntries == 1 || cfg.icacheEntries&(cfg.icacheEntries-1) != 0 {
+			return fmt.Errorf("--icache-entries must be 0 or a power of two >= 2 (as the core's ICACHE_ENTRIES), got %d", cfg.icacheEntries)
+		}
+		// One input section per function, so the layout can move each
+		commonFlags = append(commonFlags, "-ffunction-sections")
+	}
+
+	// C++ sources are compiled to objects first so the C++-only flags
+	// never reach the C and assembly inputs of the link step.
+	var cxxObjects []string
+	for i, src := range cxxSources {
+		obj := filepath.Join(tempDir, fmt.Sprintf("cxx%d_%s.o", i, strings.TrimSuffix(filepath.Base(src), filepath.Ext(src))))
+		cxxArgs := append([]string{"-c", "-x", "c++"}, commonFlags...)
+		cxxArgs = append(cxxArgs, cxxFlags...)
+		cxxArgs = append(cxxArgs, extraFlags...)
+		cxxArgs = append(cxxArgs, src, "-o", obj)
+		cmd := exec.Command(cc, cxxArgs...)
+		cmd.Stdout = os.Stdout
+		cmd.Stderr = os.Stderr
+		if err := cmd.Run(); err != nil {
+			return fmt.Errorf("C++ compilation failed: %w (command: %s %s)", err, cc, strings.Join(cxxArgs, " "))
+		}
+		cxxObjects = append(cxxObjects, obj)
+	}
+
+	const linkerScript = "devkit/cli/linker.ld"
+	args := append([]string{}, commonFlags...)
+	args = append(args,
 		"-nostdlib",
 		"-nostartfiles",
-		"-march=rv32i",
-		"-mabi=ilp32",
-		"-T", "devkit/cli/linker.ld",
+		"-T", linkerScript,
 		"devkit/sdk/crt0.S",
 		"devkit/sdk/runtime.c",
+		"devkit/sdk/string.S",
+		"devkit/sdk/muldiv.S",
 		"devkit/sdk/hal_init.c",
-		"-I", "devkit",
 		"-o", elfPath,
-	}
+	)
 
-	args = append(args, cfg.cPaths...)
+	if cfg.sched {
+		args = append(args, "devkit/sdk/sched.c", "devkit/sdk/sched_switch.S")
+	}
+	if cfg.dsp {
+		args = append(args, "devkit/sdk/dsp.c", "devkit/sdk/dsp.S")
+	}
+	if cfg.periphCfg != "" {
+		table, err := buildInitTable(cfg.periphCfg)
+		if err != nil {
+			return err
+		}
+		tablePath := filepath.Join(tempDir, "qar_init_table.c")
+		if err := writeInitTableSource(tablePath, cfg.periphCfg, table); err != nil {
+			return fmt.Errorf("failed to write init table: %w", err)
+		}
+		fmt.Printf("Peripheral init table: %d entries from %s\n", len(table), cfg.periphCfg)
+		args = append(args, "-DQAR_INIT_TABLE", tablePath)
+	}
+	args = append(args, cSources...)
+	args = append(args, cxxObjects...)
 	args = append(args, extraFlags...)
 	args = append(args, ldFlags...)
-	cmd := exec.Command(cc, args...)
-	cmd.Stdout = os.Stdout
-	cmd.Stderr = os.Stderr
-	if err := cmd.Run(); err != nil {
-		return fmt.Errorf("C compilation failed: %w (command: %s %s)", err, cc, strings.Join(args, " "))
+	if cfg.layout != "" {
+		if err := linkWithLayout(cfg, cc, args, linkerScript, tempDir, elfPath); err != nil {
+			return err
+		}
+	} else if err := runLink(cc, args); err != nil {
+		return err
 	}
 
 	elf2qar := filepath.Join("devkit", "tools", "elf2qar", "elf2qar")
@@ -74,10 +172,16 @@ func buildFromC(cfg *buildConfig) error {
 		"--elf", elfPath,
 		"--program", cfg.programOut,
 		"--data", cfg.dataOut,
-		fmt.Sprintf("--imem=%d", cfg.imemDepth),
-		fmt.Sprintf("--dmem=%d", cfg.dmemDepth),
+		"--imem", fmt.Sprintf("%d", cfg.imemDepth),
+		"--dmem", fmt.Sprintf("%d", cfg.dmemDepth),
+	}
+	if strings.Contains(march, "c") {
+		elfArgs = append(elfArgs, "--rvc")
 	}
-	cmd = exec.Command(elf2qar, elfArgs...)
+	if cfg.symbolsOut != "" {
+		elfArgs = append(elfArgs, "--symbols", cfg.symbolsOut)
+	}
+	cmd := exec.Command(elf2qar, elfArgs...)
 	cmd.Stdout = os.Stdout
 	cmd.Stderr = os.Stderr
 	if err := cmd.Run(); err != nil {
@@ -86,3 +190,64 @@ func buildFromC(cfg *buildConfig) error {
 
 	return nil
 }
+
+func runLink(cc string, args []string) error {
+	cmd := exec.Command(cc, args...)
+	cmd.Stdout = os.Stdout
+	cmd.Stderr = os.Stderr
+	if err := cmd.Run(); err != nil {
+		return fmt.Errorf("C compilation failed: %w (command: %s %s)", err, cc, strings.Join(args, " "))
+	}
+	return nil
+}
+
+// linkWithLayout links once with a map file to learn each function's
+// input section and size, then relinks with the hot sections placed by
+// planLayout (see layout.go).
+func linkWithLayout(cfg *buildConfig, cc string, args []string, linkerScript, tempDir, elfPath string) error {
+	entries, err := parseLayoutProfile(cfg.layout)
+	if err != nil {
+		return err
+	}
+	mapPath := filepath.Join(tempDir, "firmware.map")
+	if err := runLink(cc, append(append([]string{}, args...), "-Wl,-Map="+mapPath)); err != nil {
+		return err
+	}
+	symSection, sectionSize, err := parseLinkMap(mapPath)
+	if err != nil {
+		return fmt.Errorf("failed to read link map: %w", err)
+	}
+	funcSizes, err := elfFunctionSizes(elfPath)
+	if err != nil {
+		return err
+	}
+	plan := planLayout(entries, symSection, sectionSize, funcSizes, cfg.icacheEntries)
+
+	layoutScript := filepath.Join(tempDir, "layout.ld")
+	if err := writeLayoutLinkerScript(linkerScript, layoutScript, plan, filepath.Base(cfg.layout)); err != nil {
+		return err
+	}
+	relink := append([]string{}, args...)
+	for i := range relink {
+		if i > 0 && relink[i-1] == "-T" {
+			relink[i] = layoutScript
+		}
+	}
+	if err := runLink(cc, relink); err != nil {
+		return err
+	}
+
+	fmt.Printf("Layout: %d trap-path sections (%d bytes), %d main-line sections (%d bytes)",
+		len(plan.trap), plan.trapBytes, len(plan.main), plan.mainBytes)
+	if plan.cacheBytes > 0 {
+		fmt.Printf(", %d-byte I-cache", plan.cacheBytes)
+		if plan.pad {
+			fmt.Printf(", main-line code padded past the trap band")
+		}
+	}
+	fmt.Println()
+	if plan.missing > 0 {
+		fmt.Printf("Layout: %d profiled function(s) not found in this build\n", plan.missing)
+	}
+	return nil
+}
@@ -0,0 +1,393 @@
+package main
+
+import "fmt"
+
+// RV32 decoder for the profiler: enough of RV32IMAC, Zicsr and the
+// machine-mode system instructions to print a listing and to find basic
+// block boundaries in program.hex.
+
+type flowKind int
+
+const (
+	flowNone    flowKind = iota
+	flowBranch           // conditional, falls through or goes to target
+	flowJump             // JAL/C.J/C.JAL: always goes to target
+	flowJumpReg          // JALR/C.JR/C.JALR: target unknown
+	flowTrap             // ECALL/EBREAK/MRET: leaves through the trap path
+)
+
+type decodedInst struct {
+	size   uint32
+	text   string
+	flow   flowKind
+	target uint32
+}
+
+var abiRegNames = [32]string{
+	"zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2",
+	"s0", "s1", "a0", "a1", "a2", "a3", "a4", "a5",
+	"a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7",
+	"s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6",
+}
+
+func regName(r uint32) string {
+	return abiRegNames[r&31]
+}
+
+func signExtend(v uint32, bits uint) int32 {
+	shift := 32 - bits
+	return int32(v<<shift) >> shift
+}
+
+// decodeAt decodes the instruction at pc; lo is the halfword at pc and hi
+// the one after it (only used for 32-bit instructions).
+func decodeAt(pc uint32, lo, hi uint16) decodedInst {
+	if lo&3 != 3 {
+		return decodeCompressed(pc, lo)
+	}
+	return decode32(pc, uint32(lo)|uint32(hi)<<16)
+}
+
+func decode32(pc, w uint32) decodedInst {
+	d := decodedInst{size: 4}
+	rd := (w >> 7) & 31
+	rs1 := (w >> 15) & 31
+	rs2 := (w >> 20) & 31
+	funct3 := (w >> 12) & 7
+	funct7 := w >> 25
+	immI := signExtend(w>>20, 12)
+	immS := signExtend((w>>25)<<5|(w>>7)&31, 12)
+
+	switch w & 0x7f {
+	case 0x37:
+		d.text = fmt.Sprintf("lui %s, 0x%x", regName(rd), w>>12)
+	case 0x17:
+		d.text = fmt.Sprintf("auipc %s, 0x%x", regName(rd), w>>12)
+	case 0x6f:
+		imm := (w>>31)<<20 | ((w>>12)&0xff)<<12 | ((w>>20)&1)<<11 | ((w>>21)&0x3ff)<<1
+		d.flow = flowJump
+		d.target = pc + uint32(signExtend(imm, 21))
+		d.text = fmt.Sprintf("jal %s, 0x%x", regName(rd), d.target)
+	case 0x67:
+		d.flow = flowJumpReg
+		d.text = fmt.Sprintf("jalr %s, %d(%s)", regName(rd), immI, regName(rs1))
+	case 0x63:
+		names := [8]string{"beq", "bne", "", "", "blt", "bge", "bltu", "bgeu"}
+		imm := (w>>31)<<12 | ((w>>7)&1)<<11 | ((w>>25)&0x3f)<<5 | ((w>>8)&0xf)<<1
+		if names[funct3] == "" {
+			break
+		}
+		d.flow = flowBranch
+		d.target = pc + uint32(signExtend(imm, 13))
+		d.text = fmt.Sprintf("%s %s, %s, 0x%x", names[funct3], regName(rs1), regName(rs2), d.target)
+	case 0x03:
+		names := [8]string{"lb", "lh", "lw", "", "lbu", "lhu", "", ""}
+		if names[funct3] != "" {
+			d.text = fmt.Sprintf("%s %s, %d(%s)", names[funct3], regName(rd), immI, regName(rs1))
+		}
+	case 0x23:
+		names := [8]string{"sb", "sh", "sw", "", "", "", "", ""}
+		if names[funct3] != "" {
+			d.text = fmt.Sprintf("%s %s, %d(%s)", names[funct3], regName(rs2), immS, regName(rs1))
+		}
+	case 0x13:
+		switch funct3 {
+		case 1:
+			d.text = fmt.Sprintf("slli %s, %s, %d", regName(rd), regName(rs1), rs2)
+		case 5:
+			op := "srli"
+			if funct7 == 0x20 {
+				op = "srai"
+			}
+			d.text = fmt.Sprintf("%s %s, %s, %d", op, regName(rd), regName(rs1), rs2)
+		default:
+			names := [8]string{"addi", "", "slti", "sltiu", "xori", "", "ori", "andi"}
+			if w == 0x00000013 {
+				d.text = "nop"
+			} else {
+				d.text = fmt.Sprintf("%s %s, %s, %d", names[funct3], regName(rd), regName(rs1), immI)
+			}
+		}
+	case 0x33:
+		var names [8]string
+		switch funct7 {
+		case 0x00:
+			names = [8]string{"add", "sll", "slt", "sltu", "xor", "srl", "or", "and"}
+		case 0x20:
+			names = [8]string{"sub", "", "", "", "", "sra", "", ""}
+		case 0x01:
+			names = [8]string{"mul", "mulh", "mulhsu", "mulhu", "div", "divu", "rem", "remu"}
+		}
+		if names[funct3] != "" {
+			d.text = fmt.Sprintf("%s %s, %s, %s", names[funct3], regName(rd), regName(rs1), regName(rs2))
+		}
+	case 0x2f:
+		if funct3 != 2 {
+			break
+		}
+		names := map[uint32]string{
+			0x02: "lr.w", 0x03: "sc.w", 0x01: "amoswap.w", 0x00: "amoadd.w", 0x04: "amoxor.w",
+			0x0c: "amoand.w", 0x08: "amoor.w", 0x10: "amomin.w", 0x14: "amomax.w",
+			0x18: "amominu.w", 0x1c: "amomaxu.w",
+		}
+		name, ok := names[funct7>>2]
+		if !ok {
+			break
+		}
+		if name == "lr.w" {
+			d.text = fmt.Sprintf("%s %s, (%s)", name, regName(rd), regName(rs1))
+		} else {
+			d.text = fmt.Sprintf("%s %s, %s, (%s)", name, regName(rd), regName(rs2), regName(rs1))
+		}
+	case 0x0f:
+		d.text = "fence"
+	case 0x73:
+		switch {
+		case w == 0x00000073:
+			d.text, d.flow = "ecall", flowTrap
+		case w == 0x00100073:
+			d.text, d.flow = "ebreak", flowTrap
+		case w == 0x30200073:
+			d.text, d.flow = "mret", flowTrap
+		case w == 0x10500073:
+			d.text = "wfi"
+		case funct3 != 0 && funct3 != 4:
+			names := [8]string{"", "csrrw", "csrrs", "csrrc", "", "csrrwi", "csrrsi", "csrrci"}
+			src := regName(rs1)
+			if funct3 >= 5 {
+				src = fmt.Sprintf("%d", rs1)
+			}
+			d.text = fmt.Sprintf("%s %s, 0x%03x, %s", names[funct3], regName(rd), w>>20, src)
+		}
+	}
+	if d.text == "" {
+		d.text = fmt.Sprintf(".word 0x%08x", w)
+	}
+	return d
+}
+
+// Compressed instructions print their mnemonic and, for control flow, the
+// target; that is all a profile listing needs.
+func decodeCompressed(pc uint32, h uint16) decodedInst {
+	d := decodedInst{size: 2}
+	w := uint32(h)
+	funct3 := (w >> 13) & 7
+	rs1 := (w >> 7) & 31
+	rs2 := (w >> 2) & 31
+	rs1c := 8 + (w>>7)&7
+
+	jumpImm := func() uint32 {
+		imm := ((w>>12)&1)<<11 | ((w>>11)&1)<<4 | ((w>>9)&3)<<8 | ((w>>8)&1)<<10 |
+			((w>>7)&1)<<6 | ((w>>6)&1)<<7 | ((w>>3)&7)<<1 | ((w>>2)&1)<<5
+		return pc + uint32(signExtend(imm, 12))
+	}
+	branchImm := func() uint32 {
+		imm := ((w>>12)&1)<<8 | ((w>>10)&3)<<3 | ((w>>5)&3)<<6 | ((w>>3)&3)<<1 | ((w>>2)&1)<<5
+		return pc + uint32(signExtend(imm, 9))
+	}
+
+	switch w & 3 {
+	case 0:
+		names := [8]string{"c.addi4spn", "", "c.lw", "", "", "", "c.sw", ""}
+		d.text = names[funct3]
+	case 1:
+		switch funct3 {
+		case 0:
+			d.text = "c.addi"
+			if w == 0x0001 {
+				d.text = "c.nop"
+			}
+		case 1:
+			d.flow, d.target = flowJump, jumpImm()
+			d.text = fmt.Sprintf("c.jal 0x%x", d.target)
+		case 2:
+			d.text = "c.li"
+		case 3:
+			d.text = "c.lui"
+			if rs1 == 2 {
+				d.text = "c.addi16sp"
+			}
+		case 4:
+			switch (w >> 10) & 3 {
+			case 0:
+				d.text = "c.srli"
+			case 1:
+				d.text = "c.srai"
+			case 2:
+				d.text = "c.andi"
+			default:
+				d.text = [4]string{"c.sub", "c.xor", "c.or", "c.and"}[(w>>5)&3]
+			}
+		case 5:
+			d.flow, d.target = flowJump, jumpImm()
+			d.text = fmt.Sprintf("c.j 0x%x", d.target)
+		case 6, 7:
+			op := "c.beqz"
+			if funct3 == 7 {
+				op = "c.bnez"
+			}
+			d.flow, d.target = flowBranch, branchImm()
+			d.text = fmt.Sprintf("%s %s, 0x%x", op, regName(rs1c), d.target)
+		}
+	case 2:
+		switch funct3 {
+		case 0:
+			d.text = "c.slli"
+		case 2:
+			d.text = "c.lwsp"
+		case 6:
+			d.text = "c.swsp"
+		case 4:
+			bit12 := (w >> 12) & 1
+			switch {
+			case bit12 == 0 && rs2 == 0 && rs1 != 0:
+				d.flow = flowJumpReg
+				d.text = fmt.Sprintf("c.jr %s", regName(rs1))
+			case bit12 == 0:
+				d.text = "c.mv"
+			case rs2 == 0 && rs1 == 0:
+				d.text, d.flow = "c.ebreak", flowTrap
+			case rs2 == 0:
+				d.flow = flowJumpReg
+				d.text = fmt.Sprintf("c.jalr %s", regName(rs1))
+			default:
+				d.text = "c.add"
+			}
+		}
+	}
+	if d.text == "" {
+		d.text = fmt.Sprintf(".half 0x%04x", w)
+	}
+	return d
+}
+
+// expandCompressed maps a 16-bit instruction onto its 32-bit equivalent,
+// as qar-core/rtl/rvc_expand.v does; reserved encodings give all ones.
+func expandCompressed(h uint16) uint32 {
+	const illegal = 0xffffffff
+	const (
+		opImm  = 0x13
+		op     = 0x33
+		load   = 0x03
+		store  = 0x23
+		branch = 0x63
+		jal    = 0x6f
+		jalr   = 0x67
+		lui    = 0x37
+	)
+	c := uint32(h)
+	bit := func(i uint) uint32 { return (c >> i) & 1 }
+	bits := func(hi, lo uint) uint32 { return (c >> lo) & (1<<(hi-lo+1) - 1) }
+
+	rd := bits(11, 7)
+	rs2 := bits(6, 2)
+	rdP := 8 + bits(4, 2)
+	rs1P := 8 + bits(9, 7)
+	shamt := bits(6, 2)
+	imm6 := uint32(signExtend(bit(12)<<5|bits(6, 2), 6)) & 0xfff
+	addi4spn := bits(10, 7)<<6 | bits(12, 11)<<4 | bit(5)<<3 | bit(6)<<2
+	addi16sp := uint32(signExtend(bit(12)<<9|bits(4, 3)<<7|bit(5)<<6|bit(2)<<5|bit(6)<<4, 10)) & 0xfff
+	lwImm := bit(5)<<6 | bits(12, 10)<<3 | bit(6)<<2
+	lwspImm := bits(3, 2)<<6 | bit(12)<<5 | bits(6, 4)<<2
+	swspImm := bits(8, 7)<<6 | bits(12, 9)<<2
+	luiImm := uint32(signExtend(bit(12)<<5|bits(6, 2), 6)) & 0xfffff
+	jImm := uint32(signExtend(bit(12)<<11|bit(8)<<10|bits(10, 9)<<8|bit(6)<<7|bit(7)<<6|bit(2)<<5|bit(11)<<4|bits(5, 3)<<1, 12))
+	bImm := uint32(signExtend(bit(12)<<8|bits(6, 5)<<6|bit(2)<<5|bits(11, 10)<<3|bits(4, 3)<<1, 9))
+
+	iType := func(imm, rs1, f3, rd, opc uint32) uint32 { return imm<<20 | rs1<<15 | f3<<12 | rd<<7 | opc }
+	rType := func(f7, rs2, rs1, f3, rd, opc uint32) uint32 {
+		return f7<<25 | rs2<<20 | rs1<<15 | f3<<12 | rd<<7 | opc
+	}
+	sType := func(imm, rs2, rs1 uint32) uint32 {
+		return (imm>>5)<<25 | rs2<<20 | rs1<<15 | 2<<12 | (imm&31)<<7 | store
+	}
+	jWord := func(rd uint32) uint32 {
+		return (jImm>>20&1)<<31 | (jImm>>1&0x3ff)<<21 | (jImm>>11&1)<<20 | (jImm>>12&0xff)<<12 | rd<<7 | jal
+	}
+	bWord := func(f3 uint32) uint32 {
+		return (bImm>>12&1)<<31 | (bImm>>5&0x3f)<<25 | rs1P<<15 | f3<<12 | (bImm>>1&0xf)<<8 | (bImm>>11&1)<<7 | branch
+	}
+
+	switch bits(15, 13)<<2 | bits(1, 0) {
+	case 0b000_00: // C.ADDI4SPN
+		if addi4spn != 0 {
+			return iType(addi4spn, 2, 0, rdP, opImm)
+		}
+	case 0b010_00: // C.LW
+		return iType(lwImm, rs1P, 2, rdP, load)
+	case 0b110_00: // C.SW
+		return sType(lwImm, rdP, rs1P)
+	case 0b000_01: // C.ADDI / C.NOP
+		return iType(imm6, rd, 0, rd, opImm)
+	case 0b001_01: // C.JAL
+		return jWord(1)
+	case 0b010_01: // C.LI
+		return iType(imm6, 0, 0, rd, opImm)
+	case 0b011_01:
+		if rd == 2 { // C.ADDI16SP
+			if addi16sp != 0 {
+				return iType(addi16sp, 2, 0, 2, opImm)
+			}
+		} else if imm6 != 0 { // C.LUI
+			return luiImm<<12 | rd<<7 | lui
+		}
+	case 0b100_01:
+		switch bits(11, 10) {
+		case 0: // C.SRLI
+			if bit(12) == 0 {
+				return iType(shamt, rs1P, 5, rs1P, opImm)
+			}
+		case 1: // C.SRAI
+			if bit(12) == 0 {
+				return iType(0x400|shamt, rs1P, 5, rs1P, opImm)
+			}
+		case 2: // C.ANDI
+			return iType(imm6, rs1P, 7, rs1P, opImm)
+		default:
+			if bit(12) == 0 {
+				switch bits(6, 5) {
+				case 0: // C.SUB
+					return rType(0x20, rdP, rs1P, 0, rs1P, op)
+				case 1: // C.XOR
+					return rType(0, rdP, rs1P, 4, rs1P, op)
+				case 2: // C.OR
+					return rType(0, rdP, rs1P, 6, rs1P, op)
+				default: // C.AND
+					return rType(0, rdP, rs1P, 7, rs1P, op)
+				}
+			}
+		}
+	case 0b101_01: // C.J
+		return jWord(0)
+	case 0b110_01: // C.BEQZ
+		return bWord(0)
+	case 0b111_01: // C.BNEZ
+		return bWord(1)
+	case 0b000_10: // C.SLLI
+		if bit(12) == 0 {
+			return iType(shamt, rd, 1, rd, opImm)
+		}
+	case 0b010_10: // C.LWSP
+		if rd != 0 {
+			return iType(lwspImm, 2, 2, rd, load)
+		}
+	case 0b100_10:
+		switch {
+		case bit(12) == 0 && rs2 == 0: // C.JR
+			if rd != 0 {
+				return iType(0, rd, 0, 0, jalr)
+			}
+		case bit(12) == 0: // C.MV
+			return rType(0, rs2, 0, 0, rd, op)
+		case rs2 == 0 && rd == 0: // C.EBREAK
+			return 0x00100073
+		case rs2 == 0: // C.JALR
+			return iType(0, rd, 0, 1, jalr)
+		default: // C.ADD
+			return rType(0, rs2, rd, 0, rd, op)
+		}
+	case 0b110_10: // C.SWSP
+		return sType(swspImm, rs2, 2)
+	}
+	return illegal
+}
@@ -0,0 +1,313 @@
+package main
+
+import (
+	"bufio"
+	"debug/elf"
+	"fmt"
+	"os"
+	"regexp"
+	"sort"
+	"strconv"
+	"strings"
+)
+
+// Profile-guided code placement for `qarsim build --layout`.
+//
+// The I-cache is direct-mapped with one word per entry, so two code words
+// compete for an entry exactly when they are a multiple of the cache size
+// apart, and any run of code no longer than the cache maps without
+// conflicts. The layout therefore starts with the hot trap-path code
+// (ISRs, the scheduler entry), follows it with the hot main-line code,
+// densest first, and leaves everything else in link order afterwards.
+// When the hot code is larger than the cache, later hot functions are
+// padded past the trap-path band of each cache-sized window, so main-line
+// loops never evict the ISRs.
+//
+// The firmware is linked twice. The first link, with -ffunction-sections
+// and a map file, gives each function's input section and size; the
+// second uses linker.ld with the hot sections listed ahead of *(.text*).
+
+type layoutEntry struct {
+	cycles uint64
+	trap   uint64
+}
+
+// layoutUnit is one input section: the unit the linker can move.
+type layoutUnit struct {
+	section string
+	pattern string
+	names   []string
+	size    uint32
+	cycles  uint64
+	trap    uint64
+}
+
+func (u *layoutUnit) trapPath() bool {
+	return 2*u.trap > u.cycles
+}
+
+func (u *layoutUnit) density() float64 {
+	if u.size == 0 {
+		return float64(u.cycles)
+	}
+	return float64(u.cycles) / float64(u.size)
+}
+
+type layoutPlan struct {
+	trap       []*layoutUnit
+	main       []*layoutUnit
+	trapBytes  uint32
+	mainBytes  uint32
+	cacheBytes uint32
+	pad        bool
+	missing    int
+}
+
+// parseLayoutProfile reads `qarsim profile --layout-out` output:
+// "cycles trap_cycles function" per line.
+func parseLayoutProfile(path string) (map[string]layoutEntry, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer file.Close()
+
+	entries := make(map[string]layoutEntry)
+	scanner := bufio.NewScanner(file)
+	lineNo := 0
+	for scanner.Scan() {
+		lineNo++
+		line := strings.TrimSpace(scanner.Text())
+		if line == "" || strings.HasPrefix(line, "#") {
+			continue
+		}
+		fields := strings.Fields(line)
+		if len(fields) != 3 {
+			return nil, fmt.Errorf("%s:%d: expected cycles trap_cycles function", path, lineNo)
+		}
+		cycles, err := strconv.ParseUint(fields[0], 10, 64)
+		if err != nil {
+			return nil, fmt.Errorf("%s:%d: bad cycle count %q", path, lineNo, fields[0])
+		}
+		trap, err := strconv.ParseUint(fields[1], 10, 64)
+		if err != nil {
+			return nil, fmt.Errorf("%s:%d: bad trap cycle count %q", path, lineNo, fields[1])
+		}
+		e := entries[fields[2]]
+		e.cycles += cycles
+		e.trap += trap
+		entries[fields[2]] = e
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, err
+	}
+	return entries, nil
+}
+
+// elfFunctionSizes returns the size of every sized function in IMEM.
+func elfFunctionSizes(path string) (map[string]uint32, error) {
+	f, err := elf.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer f.Close()
+	syms, err := f.Symbols()
+	if err != nil {
+		return nil, fmt.Errorf("%s: %w", path, err)
+	}
+	sizes := make(map[string]uint32)
+	for _, s := range syms {
+		if elf.ST_TYPE(s.Info) == elf.STT_FUNC && s.Size > 0 && s.Value < dmemBase {
+			sizes[s.Name] = uint32(s.Size)
+		}
+	}
+	return sizes, nil
+}
+
+var (
+	mapSectionRe  = regexp.MustCompile(`^ (\.text[^\s]*)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+\S.*)?$`)
+	mapSizeRe     = regexp.MustCompile(`^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+\S.*$`)
+	mapSymbolRe   = regexp.MustCompile(`^\s+0x[0-9a-fA-F]+\s+([A-Za-z_.$][A-Za-z0-9_.$]*)$`)
+	mapMemoryMark = "Linker script and memory map"
+)
+
+// parseLinkMap reads a GNU ld map file and returns, for every global
+// symbol in a .text* input section, that section's name, plus the total
+// size of each section name. Names can repeat across objects (static
+// functions), so sizes are summed.
+func parseLinkMap(path string) (map[string]string, map[string]uint32, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, nil, err
+	}
+	defer file.Close()
+
+	symSection := make(map[string]string)
+	sectionSize := make(map[string]uint32)
+	inMap := false
+	current := ""
+	pending := false
+	scanner := bufio.NewScanner(file)
+	for scanner.Scan() {
+		line := scanner.Text()
+		if !inMap {
+			inMap = strings.HasPrefix(line, mapMemoryMark)
+			continue
+		}
+		if m := mapSectionRe.FindStringSubmatch(line); m != nil {
+			current = m[1]
+			pending = m[2] == ""
+			if !pending {
+				size, _ := strconv.ParseUint(m[3], 16, 32)
+				sectionSize[current] += uint32(size)
+			}
+			continue
+		}
+		if pending {
+			// Long section names put address and size on the next line
+			pending = false
+			if m := mapSizeRe.FindStringSubmatch(line); m != nil {
+				size, _ := strconv.ParseUint(m[2], 16, 32)
+				sectionSize[current] += uint32(size)
+				continue
+			}
+		}
+		if current == "" {
+			continue
+		}
+		if m := mapSymbolRe.FindStringSubmatch(line); m != nil {
+			if _, seen := symSection[m[1]]; !seen {
+				symSection[m[1]] = current
+			}
+			continue
+		}
+		// Any other input section, rule or output section ends this one
+		if !strings.HasPrefix(line, " ") || strings.HasPrefix(line, " *") || strings.HasPrefix(line, " .") {
+			current = ""
+		}
+	}
+	return symSection, sectionSize, scanner.Err()
+}
+
+// planLayout groups the profiled functions by input section and orders
+// them. Functions from the profile that are not in this build are
+// counted in missing.
+func planLayout(entries map[string]layoutEntry, symSection map[string]string, sectionSize map[string]uint32,
+	funcSizes map[string]uint32, icacheEntries int) *layoutPlan {
+	plan := &layoutPlan{cacheBytes: uint32(icacheEntries) * 4}
+	units := make(map[string]*layoutUnit)
+
+	names := make([]string, 0, len(entries))
+	for name := range entries {
+		names = append(names, name)
+	}
+	sort.Strings(names)
+	for _, name := range names {
+		e := entries[name]
+		if e.cycles == 0 {
+			continue
+		}
+		section, pattern := symSection[name], ""
+		size := sectionSize[section]
+		if section == "" {
+			// Not in the map (static, or another linker): -ffunction-sections
+			// naming, including .text.startup.main and friends.
+			fsize, ok := funcSizes[name]
+			if !ok {
+				plan.missing++
+				continue
+			}
+			section = ".text." + name
+			pattern = fmt.Sprintf("*(%s .text.*.%s)", section, name)
+			size = fsize
+		} else {
+			pattern = fmt.Sprintf("*(%s)", section)
+		}
+		if section == ".text.start" || section == ".text" {
+			// _start is the reset vector and stays first; code in a plain
+			// .text section cannot be moved on its own.
+			continue
+		}
+		u := units[section]
+		if u == nil {
+			u = &layoutUnit{section: section, pattern: pattern, size: size}
+			units[section] = u
+		}
+		u.names = append(u.names, name)
+		u.cycles += e.cycles
+		u.trap += e.trap
+	}
+
+	for _, u := range units {
+		if u.trapPath() {
+			plan.trap = append(plan.trap, u)
+			plan.trapBytes += u.size
+		} else {
+			plan.main = append(plan.main, u)
+			plan.mainBytes += u.size
+		}
+	}
+	byDensity := func(list []*layoutUnit) {
+		sort.Slice(list, func(i, j int) bool {
+			if di, dj := list[i].density(), list[j].density(); di != dj {
+				return di > dj
+			}
+			return list[i].section < list[j].section
+		})
+	}
+	byDensity(plan.trap)
+	byDensity(plan.main)
+
+	// Padding costs up to the trap band per window; only worth it when
+	// the band is small next to the cache and the hot code overflows it.
+	plan.pad = plan.cacheBytes > 0 && plan.trapBytes > 0 && 2*plan.trapBytes <= plan.cacheBytes &&
+		plan.trapBytes+plan.mainBytes > plan.cacheBytes
+	return plan
+}
+
+// layoutScript returns the linker script text that replaces *(.text*).
+func (plan *layoutPlan) layoutScript(source string) string {
+	var b strings.Builder
+	fmt.Fprintf(&b, "        /* qarsim --layout %s: %d trap-path and %d main-line hot sections", source,
+		len(plan.trap), len(plan.main))
+	if plan.cacheBytes > 0 {
+		fmt.Fprintf(&b, ",\n         * %d-byte I-cache window", plan.cacheBytes)
+	}
+	b.WriteString(" */\n")
+	b.WriteString("        . = ALIGN(4);\n")
+	b.WriteString("        __qar_hot_start = .;\n")
+	for _, u := range plan.trap {
+		fmt.Fprintf(&b, "        %s\n", u.pattern)
+	}
+	b.WriteString("        __qar_trap_end = .;\n")
+	for _, u := range plan.main {
+		if plan.pad && u.size <= plan.cacheBytes-plan.trapBytes {
+			// off = offset in the current cache window, band = trap-path bytes
+			off := fmt.Sprintf("((. - __qar_hot_start) %% %d)", plan.cacheBytes)
+			band := "(__qar_trap_end - __qar_hot_start)"
+			fmt.Fprintf(&b, "        . = (%s < %s) ? . + %s - %s :\n", off, band, band, off)
+			fmt.Fprintf(&b, "            ((%s + %d > %d) ? . + %d - %s + %s : .);\n",
+				off, u.size, plan.cacheBytes, plan.cacheBytes, off, band)
+		}
+		fmt.Fprintf(&b, "        %s\n", u.pattern)
+	}
+	b.WriteString("        __qar_hot_end = .;\n")
+	b.WriteString("        *(.text*)\n")
+	return b.String()
+}
+
+// writeLayoutLinkerScript copies base with the hot sections placed ahead
+// of its *(.text*) rule.
+func writeLayoutLinkerScript(base, out string, plan *layoutPlan, source string) error {
+	data, err := os.ReadFile(base)
+	if err != nil {
+		return err
+	}
+	const rule = "        *(.text*)\n"
+	text := string(data)
+	if strings.Count(text, rule) != 1 {
+		return fmt.Errorf("%s: expected exactly one %q rule to place the layout at", base, strings.TrimSpace(rule))
+	}
+	text = strings.Replace(text, rule, plan.layoutScript(source), 1)
+	return os.WriteFile(out, []byte(text), 0o644)
+}
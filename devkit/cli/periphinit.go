@@ -0,0 +1,292 @@
+package main
+
+import (
+	"encoding/json"
+	"flag"
+	"fmt"
+	"os"
+	"sort"
+	"strconv"
+	"strings"
+)
+
+// Peripheral init tables. A per-project JSON config lists the blocks the
+// firmware uses (and any register values that differ from the SDK reset
+// defaults); the build turns it into an address/value table that
+// qar_sdk_init() replays with one store per entry. Blocks that are not
+// listed are not touched at all.
+//
+//	{
+//	  "blocks": {
+//	    "uart0":  { "BAUD": 2604 },
+//	    "timer0": {},
+//	    "evr0":   {}
+//	  },
+//	  "writes": [ { "addr": "0x40001008", "value": "0x10" } ]
+//	}
+//
+// The per-block sequences mirror the hand-written init_*_block() routines
+// in devkit/sdk/hal_init.c. `qarsim periphinit` with no config prints the
+// full sequence, and scripts/check_periphinit.sh diffs it against the
+// stores hal_init.c makes on the host (devkit/tools/initcheck).
+
+type initReg struct {
+	name   string
+	offset uint32
+	value  uint32
+}
+
+type initBlockType struct {
+	regs []initReg // reset sequence, written in this order
+	// Registers that may be overridden but are not part of the reset
+	// sequence; an override appends a write after the sequence.
+	extra map[string]uint32
+}
+
+type initInstance struct {
+	name string
+	kind string
+	base uint32
+}
+
+func indexedRegs(prefix string, first, count int, offset uint32, value uint32) []initReg {
+	regs := make([]initReg, 0, count)
+	for i := first; i < first+count; i++ {
+		regs = append(regs, initReg{fmt.Sprintf("%s%d", prefix, i), offset + uint32(i)*4, value})
+	}
+	return regs
+}
+
+var initBlockTypes = map[string]initBlockType{
+	"gpio": {
+		regs: []initReg{
+			{"DIR", 0x00, 0}, {"OUT", 0x04, 0}, {"ALT_PWM", 0x1C, 0},
+			{"IRQ_EN", 0x14, 0}, {"IRQ_RISE", 0x20, 0}, {"IRQ_FALL", 0x24, 0},
+			{"DB_EN", 0x28, 0}, {"DB_CYCLES", 0x2C, 0},
+			{"IRQ_STATUS", 0x18, 0xFFFFFFFF}, {"SEQ_CTRL", 0x30, 0},
+		},
+		extra: map[string]uint32{"SEQ_DIV": 0x34, "SEQ_MASK": 0x38, "SEQ_LEN": 0x3C},
+	},
+	"timer": {
+		regs: []initReg{
+			{"CTRL", 0x00, 0}, {"IRQ_EN", 0x10, 0}, {"STATUS", 0x0C, 0xFF},
+			{"PRESCALE", 0x04, 0},
+			{"CMP0", 0x14, 0}, {"CMP0_PERIOD", 0x18, 0},
+			{"CMP1", 0x1C, 0}, {"CMP1_PERIOD", 0x20, 0},
+			{"PWM0_PERIOD", 0x30, 0}, {"PWM0_DUTY", 0x34, 0},
+			{"PWM1_PERIOD", 0x38, 0}, {"PWM1_DUTY", 0x3C, 0},
+			{"WDT_LOAD", 0x24, 0}, {"WDT_CTRL", 0x28, 0},
+			{"CAPTURE_CTRL", 0x44, 0},
+			{"ICAP_CFG0", 0x50, 1 << 16}, {"ICAP_CFG1", 0x54, 1 << 16},
+		},
+	},
+	"uart": {
+		regs: []initReg{
+			{"CTRL", 0x08, 0}, {"BAUD", 0x0C, 500}, {"RS485", 0x18, 0},
+			{"IDLE_CFG", 0x1C, 0}, {"LIN_CTRL", 0x20, 13}, {"LIN_SLAVE", 0x30, 0},
+			{"LIN_SCHED_CTRL", 0x34, 0}, {"LIN_SCHED_STATUS", 0x3C, 0xF00},
+			{"IRQ_EN", 0x10, 0}, {"IRQ_STATUS", 0x14, 0x1FF}, {"LIN_CMD", 0x24, 0x2},
+		},
+	},
+	"can": {
+		regs: []initReg{
+			{"CTRL", 0x00, 0}, {"BITTIME", 0x08, 0x13},
+			{"FILTER_ID", 0x18, 0}, {"FILTER_MASK", 0x1C, 0},
+			{"IRQ_EN", 0x10, 0}, {"IRQ_STATUS", 0x14, 0x7}, {"RX_FIFO", 0x44, 0x2},
+		},
+	},
+	"spi": {
+		regs: []initReg{
+			{"CTRL", 0x00, 0}, {"CLKDIV", 0x08, 4}, {"CS", 0x14, 0xFFFFFFFF},
+			{"IRQ_EN", 0x18, 0}, {"IRQ_STATUS", 0x1C, 0x3F},
+		},
+	},
+	"i2c": {
+		regs: []initReg{
+			{"CTRL", 0x00, 0}, {"CLKDIV", 0x04, 64}, {"IRQ_EN", 0x0C, 0},
+			{"SEQ_CTRL", 0x28, 0x6}, {"IRQ_STATUS", 0x10, 0x7F},
+		},
+	},
+	"adc": {
+		regs: []initReg{
+			{"CTRL", 0x00, 0}, {"SEQ_MASK", 0x14, 0}, {"SAMPLE_DIV", 0x18, 0},
+			{"FIFO_CTRL", 0x20, 0x2}, {"OVERSAMPLE", 0x28, 0}, {"WIN_EN", 0x2C, 0},
+			{"WIN_STATUS", 0x30, 0xFF}, {"IRQ_EN", 0x0C, 0}, {"IRQ_STATUS", 0x10, 0x1F},
+		},
+	},
+	"evr": {
+		regs: append(append([]initReg{{"CTRL", 0x00, 0}},
+			indexedRegs("ROUTE", 0, 6, 0x20, 0)...),
+			initReg{"GPIO_SEL", 0x04, 0},
+			initReg{"SRC_FLAGS", 0x0C, 0x1FF},
+			initReg{"ACT_FLAGS", 0x10, 0x3F}),
+	},
+	"plic": {
+		regs: append([]initReg{{"CTRL", 0x00, 0}, {"ENABLE", 0x08, 0}, {"THRESHOLD", 0x0C, 0}},
+			indexedRegs("PRIORITY", 1, 15, 0x40, 0)...),
+	},
+	"crc": {
+		// CRC-32 (IEEE) model; CTRL last so the reset picks up INIT
+		regs: []initReg{
+			{"POLY", 0x04, 0x04C11DB7}, {"INIT", 0x08, 0xFFFFFFFF},
+			{"XOROUT", 0x0C, 0xFFFFFFFF}, {"CTRL", 0x00, 0x1E},
+		},
+	},
+}
+
+// Same order as qar_sdk_init() in devkit/sdk/hal_init.c.
+var initInstances = []initInstance{
+	{"gpio0", "gpio", 0x40000000},
+	{"timer0", "timer", 0x40005000},
+	{"uart0", "uart", 0x40001000},
+	{"uart1", "uart", 0x40002000},
+	{"can0", "can", 0x40003000},
+	{"can1", "can", 0x40003100},
+	{"spi0", "spi", 0x40004000},
+	{"spi1", "spi", 0x40004100},
+	{"i2c0", "i2c", 0x40004400},
+	{"i2c1", "i2c", 0x40004500},
+	{"adc0", "adc", 0x40006000},
+	{"evr0", "evr", 0x40007000},
+	{"plic0", "plic", 0x40008000},
+	{"crc0", "crc", 0x40009000},
+}
+
+// initValue accepts a JSON number or a string such as "0x1F".
+type initValue uint32
+
+func (v *initValue) UnmarshalJSON(data []byte) error {
+	text := strings.Trim(string(data), `"`)
+	parsed, err := strconv.ParseUint(text, 0, 32)
+	if err != nil {
+		return fmt.Errorf("invalid register value %s", string(data))
+	}
+	*v = initValue(parsed)
+	return nil
+}
+
+type initConfig struct {
+	Blocks map[string]map[string]initValue `json:"blocks"`
+	Writes []struct {
+		Addr  initValue `json:"addr"`
+		Value initValue `json:"value"`
+	} `json:"writes"`
+}
+
+type initEntry struct {
+	addr    uint32
+	value   uint32
+	comment string
+}
+
+// buildInitTable reads a config; an empty path selects every block with
+// its defaults, which is what qar_sdk_init() does without a table.
+func buildInitTable(path string) ([]initEntry, error) {
+	var cfg initConfig
+	if path == "" {
+		cfg.Blocks = map[string]map[string]initValue{}
+		for _, inst := range initInstances {
+			cfg.Blocks[inst.name] = nil
+		}
+		return initTableFromConfig(cfg, "defaults")
+	}
+	raw, err := os.ReadFile(path)
+	if err != nil {
+		return nil, fmt.Errorf("failed to read peripheral config: %w", err)
+	}
+	if err := json.Unmarshal(raw, &cfg); err != nil {
+		return nil, fmt.Errorf("%s: %w", path, err)
+	}
+	return initTableFromConfig(cfg, path)
+}
+
+func initTableFromConfig(cfg initConfig, path string) ([]initEntry, error) {
+
+	known := map[string]bool{}
+	for _, inst := range initInstances {
+		known[inst.name] = true
+	}
+	for name := range cfg.Blocks {
+		if !known[name] {
+			return nil, fmt.Errorf("%s: unknown peripheral block %q", path, name)
+		}
+	}
+
+	var table []initEntry
+	for _, inst := range initInstances {
+		overrides, used := cfg.Blocks[inst.name]
+		if !used {
+			continue
+		}
+		kind := initBlockTypes[inst.kind]
+		pending := map[string]bool{}
+		for reg := range overrides {
+			pending[reg] = true
+		}
+		for _, reg := range kind.regs {
+			value := reg.value
+			if v, ok := overrides[reg.name]; ok {
+				value = uint32(v)
+				delete(pending, reg.name)
+			}
+			table = append(table, initEntry{inst.base + reg.offset, value, inst.name + "." + reg.name})
+		}
+		// Remaining overrides are registers outside the reset sequence;
+		// emit them in a stable order.
+		names := make([]string, 0, len(pending))
+		for reg := range pending {
+			names = append(names, reg)
+		}
+		sort.Strings(names)
+		for _, reg := range names {
+			offset, ok := kind.extra[reg]
+			if !ok {
+				return nil, fmt.Errorf("%s: %s has no register %q", path, inst.name, reg)
+			}
+			table = append(table, initEntry{inst.base + offset, uint32(overrides[reg]), inst.name + "." + reg})
+		}
+	}
+	for _, w := range cfg.Writes {
+		if uint32(w.Addr)&3 != 0 {
+			return nil, fmt.Errorf("%s: write address 0x%08x is not word aligned", path, uint32(w.Addr))
+		}
+		table = append(table, initEntry{uint32(w.Addr), uint32(w.Value), "raw write"})
+	}
+	return table, nil
+}
+
+// writeInitTableSource emits the C definition of qar_init_table for
+// devkit/sdk/init_table.h.
+func writeInitTableSource(path, configPath string, table []initEntry) error {
+	var b strings.Builder
+	fmt.Fprintf(&b, "/* Generated by qarsim from %s; do not edit. */\n", configPath)
+	b.WriteString("#include \"sdk/init_table.h\"\n\n")
+	if len(table) == 0 {
+		b.WriteString("const qar_init_entry_t qar_init_table[1] = { { 0u, 0u } };\n")
+	} else {
+		b.WriteString("const qar_init_entry_t qar_init_table[] = {\n")
+		for _, e := range table {
+			fmt.Fprintf(&b, "    { 0x%08Xu, 0x%08Xu }, /* %s */\n", e.addr, e.value, e.comment)
+		}
+		b.WriteString("};\n")
+	}
+	fmt.Fprintf(&b, "const uint32_t qar_init_table_len = %du;\n", len(table))
+	return os.WriteFile(path, []byte(b.String()), 0o644)
+}
+
+// runPeriphInit prints the init table for a config (or the full default
+// sequence) as "addr value  # register" lines.
+func runPeriphInit(args []string) {
+	fs := flag.NewFlagSet("periphinit", flag.ExitOnError)
+	configPath := fs.String("config", "", "Peripheral config JSON (default: every block, SDK defaults)")
+	if err := fs.Parse(args); err != nil {
+		exitErr(err)
+	}
+	table, err := buildInitTable(*configPath)
+	if err != nil {
+		exitErr(err)
+	}
+	for _, e := range table {
+		fmt.Printf("0x%08X 0x%08X  # %s\n", e.addr, e.value, e.comment)
+	}
+}
@@ -0,0 +1,355 @@
+package main
+
+import "fmt"
+
+// Cycle model of the three-stage core (PIPELINE_STAGES=3) for `qarsim
+// wcet`. It follows the register updates in qar_core.v for the fetch unit
+// (one IMEM request in flight, a prefetch slot, the direct-mapped I-cache),
+// the RVC aligner, the single ID slot and EX with its DMEM, peripheral-bus
+// and IMEM data-load handshakes. Operand values are not modelled: the
+// caller supplies the path through the program, which decides branches,
+// and the memory region each load or store reaches. Interrupts are not
+// modelled.
+
+type memClass int
+
+const (
+	memNone    memClass = iota
+	memDMEM             // DMEM handshake, dmemWait wait states
+	memPbus             // peripheral bus: loads take two cycles, stores are posted
+	memIMEM             // IMEM_DATA_LOADS: the load owns the fetch port
+	memUnknown          // address not known statically
+)
+
+// pipeInst is one instruction on a simulated path.
+type pipeInst struct {
+	pc    uint32
+	size  uint32
+	instr uint32 // 32-bit form; RVC instructions are expanded
+	mem   memClass
+}
+
+type pipeConfig struct {
+	imemWait      int  // cycles imem_ready stays low after a request
+	dmemWait      int  // cycles mem_ready stays low after a request
+	icacheHit     bool // every fetch hits the I-cache (false: no cache, or all misses)
+	imemDataLoads bool // the core's IMEM_DATA_LOADS
+	worst         bool // unknown addresses and SC outcomes take the slower path
+}
+
+const (
+	amoIdle = iota
+	amoRead
+	amoWrite
+	amoDone
+)
+
+// memClassFor resolves memUnknown: the worst case is the DMEM handshake
+// (or an IMEM load when those are slower), the best a peripheral access.
+func (cfg *pipeConfig) memClassFor(c memClass) memClass {
+	if c != memUnknown {
+		return c
+	}
+	if !cfg.worst {
+		return memPbus
+	}
+	if cfg.imemDataLoads && cfg.imemWait > cfg.dmemWait {
+		return memIMEM
+	}
+	return memDMEM
+}
+
+func readsRs1(w uint32) bool {
+	switch w & 0x7f {
+	case 0x33, 0x13, 0x03, 0x23, 0x2f, 0x63, 0x67:
+		return true
+	case 0x73:
+		return (w>>12)&7 != 0
+	}
+	return false
+}
+
+func readsRs2(w uint32) bool {
+	switch w & 0x7f {
+	case 0x33, 0x23, 0x2f, 0x63:
+		return true
+	}
+	return false
+}
+
+// simulatePath starts with the pipeline empty and pc_fetch at path[0], as
+// after a taken branch, jump or trap, and returns the cycle (counting from
+// 1) in which each path instruction leaves EX. A path instruction whose
+// successor on the path is not the next address redirects fetch there.
+func simulatePath(img programImage, path []pipeInst, cfg *pipeConfig) ([]int, error) {
+	retired := make([]int, len(path))
+	if len(path) == 0 {
+		return retired, nil
+	}
+	word := func(addr uint32) uint32 {
+		i := int(addr / 2)
+		var lo, hi uint16
+		if i < len(img) {
+			lo = img[i]
+		}
+		if i+1 < len(img) {
+			hi = img[i+1]
+		}
+		return uint32(lo) | uint32(hi)<<16
+	}
+
+	var (
+		pcFetch  = path[0].pc &^ 3
+		alignOff = path[0].pc&2 != 0
+
+		fetchPending bool
+		fetchAddr    uint32
+		imemLeft     int
+		iloadPending bool
+
+		ifValid, slotValid bool
+		ifWord, slotWord   uint32
+		ifPC, slotPC       uint32
+
+		idValid bool
+		idIdx   int
+		nextID  int
+
+		exValid bool
+		exIdx   int
+
+		dmemPending bool
+		dmemLeft    int
+		dmemLoad    bool
+		dmemRd      uint32
+		amoState    = amoIdle
+
+		pbValid, pbWrite bool
+	)
+
+	limit := 64 + len(path)*(16+4*(cfg.imemWait+cfg.dmemWait))
+	for cycle := 1; cycle <= limit; cycle++ {
+		imemReady := (fetchPending || iloadPending) && imemLeft == 0
+		dmemReady := dmemPending && dmemLeft == 0
+		pbReadStrobe := pbValid && !pbWrite
+		pbWriteStrobe := pbValid && pbWrite
+
+		// EX
+		stall := dmemPending && !dmemReady
+		startMem, startLoad := false, false
+		var startRd uint32
+		pbusReq, pbusWrite := false, false
+		iloadStart := false
+		flush, trap := false, false
+		var target uint32
+		amoNext := amoState
+		if exValid {
+			in := path[exIdx]
+			w := in.instr
+			rd := (w >> 7) & 31
+			redirect := exIdx+1 < len(path) && path[exIdx+1].pc != in.pc+in.size
+			if redirect {
+				target = path[exIdx+1].pc
+			}
+			switch w & 0x7f {
+			case 0x03: // LOAD
+				switch cfg.memClassFor(in.mem) {
+				case memPbus:
+					if !pbReadStrobe {
+						pbusReq = true
+						stall = true
+					}
+				case memIMEM:
+					if !(iloadPending && imemReady) {
+						iloadStart = !iloadPending && !fetchPending
+						stall = true
+					}
+				default:
+					if !dmemPending {
+						startMem, startLoad, startRd = true, true, rd
+					}
+					stall = (dmemPending && !dmemReady) || startMem
+				}
+			case 0x23: // STORE
+				if cfg.memClassFor(in.mem) == memPbus {
+					pbusReq, pbusWrite = true, true
+				} else {
+					if !dmemPending {
+						startMem = true
+					}
+					stall = (dmemPending && !dmemReady) || startMem
+				}
+			case 0x2f: // AMO
+				funct5 := w >> 27
+				isLR, isSC := funct5 == 0x02, funct5 == 0x03
+				switch amoState {
+				case amoIdle:
+					if dmemPending {
+						stall = true
+					} else if !(isSC && !cfg.worst) {
+						// LR, the RMW read or a successful SC write
+						startMem, startLoad, startRd = true, !isSC, rd
+						stall = true
+						amoNext = amoRead
+						if isLR || isSC {
+							amoNext = amoDone
+						}
+					}
+				case amoRead:
+					stall = true
+					if dmemReady {
+						amoNext = amoWrite
+					}
+				case amoWrite:
+					startMem = true
+					stall = true
+					amoNext = amoDone
+				default:
+					stall = dmemPending && !dmemReady
+					if !stall {
+						amoNext = amoIdle
+					}
+				}
+			case 0x63: // BRANCH
+				flush = redirect
+			case 0x6f, 0x67: // JAL, JALR
+				flush = true
+			case 0x73: // SYSTEM
+				switch {
+				case w == 0x30200073: // MRET drains a posted store first
+					if pbWriteStrobe {
+						stall = true
+					} else {
+						flush = true
+					}
+				case w == 0x00000073 || w == 0x00100073: // ECALL, EBREAK
+					flush, trap = true, true
+				}
+			case 0x0f: // FENCE
+				stall = pbValid
+			}
+			if flush || !stall {
+				retired[exIdx] = cycle
+				if exIdx == len(path)-1 {
+					return retired, nil
+				}
+			}
+		}
+
+		loadUse := false
+		if idValid && dmemPending && dmemLoad && dmemRd != 0 {
+			w := path[idIdx].instr
+			loadUse = (readsRs1(w) && (w>>15)&31 == dmemRd) || (readsRs2(w) && (w>>20)&31 == dmemRd)
+		}
+		exCanAccept := !exValid || !stall
+		idStall := loadUse || (!exCanAccept && idValid)
+
+		// Aligner
+		half := ifWord & 0xffff
+		if alignOff {
+			half = ifWord >> 16
+		}
+		isRVC := half&3 != 3
+		split := alignOff && !isRVC
+		alignReady := ifValid && (!split || slotValid)
+		alignPop := !isRVC || alignOff
+		alignPC := ifPC &^ 3
+		if alignOff {
+			alignPC |= 2
+		}
+		idAccept := alignReady && !idValid && !idStall && nextID < len(path)
+		ifPop := idAccept && alignPop
+		occupancy := 0
+		if ifValid {
+			occupancy++
+		}
+		if slotValid {
+			occupancy++
+		}
+		slotToIF := slotValid && (!ifValid || ifPop)
+		ifFetchTarget := (!ifValid || ifPop) && !slotToIF
+
+		// Register updates, in qar_core.v order
+		if fetchPending || iloadPending {
+			if imemLeft > 0 {
+				imemLeft--
+			}
+		}
+		if dmemPending && dmemLeft > 0 {
+			dmemLeft--
+		}
+
+		if flush {
+			pcFetch = target &^ 3
+			alignOff = target&2 != 0
+			fetchPending = false
+			ifValid, slotValid, idValid, exValid = false, false, false, false
+			nextID = exIdx + 1
+		} else {
+			if idAccept {
+				if path[nextID].pc != alignPC {
+					return nil, fmt.Errorf("wcet: path expects 0x%08x at 0x%08x", path[nextID].pc, alignPC)
+				}
+				idValid, idIdx = true, nextID
+				nextID++
+				if alignPop {
+					ifValid = false
+				}
+				if isRVC {
+					alignOff = !alignOff
+				}
+			}
+			if slotToIF {
+				ifValid, ifWord, ifPC = true, slotWord, slotPC
+				slotValid = false
+			}
+			if !fetchPending && !iloadPending && !iloadStart && occupancy < 2 {
+				if cfg.icacheHit {
+					if ifFetchTarget {
+						ifValid, ifWord, ifPC = true, word(pcFetch), pcFetch
+					} else {
+						slotValid, slotWord, slotPC = true, word(pcFetch), pcFetch
+					}
+				} else {
+					fetchPending, fetchAddr, imemLeft = true, pcFetch, cfg.imemWait
+				}
+				pcFetch += 4
+			}
+			if fetchPending && imemReady {
+				fetchPending = false
+				if ifFetchTarget {
+					ifValid, ifWord, ifPC = true, word(fetchAddr), fetchAddr
+				} else {
+					slotValid, slotWord, slotPC = true, word(fetchAddr), fetchAddr
+				}
+			}
+			if idValid && !idStall && exCanAccept && !idAccept {
+				exValid, exIdx = true, idIdx
+				idValid = false
+			} else if exValid && !stall {
+				exValid = false
+			}
+		}
+
+		pbValid = pbusReq && !trap
+		if pbValid {
+			pbWrite = pbusWrite
+		}
+
+		if trap {
+			iloadPending = false
+		} else if iloadStart {
+			iloadPending, imemLeft = true, cfg.imemWait
+		} else if iloadPending && imemReady {
+			iloadPending = false
+		}
+
+		if startMem && !dmemPending {
+			dmemPending, dmemLeft, dmemLoad, dmemRd = true, cfg.dmemWait, startLoad, startRd
+		} else if dmemReady {
+			dmemPending = false
+		}
+		amoState = amoNext
+	}
+	return nil, fmt.Errorf("wcet: pipeline model did not retire the path at 0x%08x", path[0].pc)
+}
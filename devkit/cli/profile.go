@@ -0,0 +1,580 @@
+package main
+
+import (
+	"bufio"
+	"errors"
+	"flag"
+	"fmt"
+	"os"
+	"sort"
+	"strconv"
+	"strings"
+)
+
+// Cycle causes, in the column order of the testbench profile dump
+// (qar_core_bench_tb.v, QAR_PROFILE).
+const (
+	causeRetired = iota
+	causeMem
+	causeLoadUse
+	causeBranch
+	causeFetch
+	causeSleep
+	causeOther
+	numCauses
+)
+
+var causeNames = [numCauses]string{"retired", "mem", "loaduse", "branch", "fetch", "sleep", "other"}
+
+var causeHelp = [numCauses]string{
+	"instructions leaving EX (one cycle each)",
+	"EX waiting on a load, store or AMO",
+	"EX empty behind a load-use hazard (charged to the consumer)",
+	"pipeline refill after a taken branch, jump or trap",
+	"EX empty because fetch fell behind",
+	"WFI sleep",
+	"EX held for another reason",
+}
+
+// Code lives below DMEM; elf2qar splits images at the same address.
+const dmemBase = 0x20000000
+
+type causeCounts [numCauses]uint64
+
+func (c causeCounts) total() uint64 {
+	var sum uint64
+	for _, v := range c {
+		sum += v
+	}
+	return sum
+}
+
+func (c *causeCounts) add(o causeCounts) {
+	for i := range c {
+		c[i] += o[i]
+	}
+}
+
+type symbolEntry struct {
+	addr uint32
+	size uint32
+	kind string
+	name string
+}
+
+// funcRange is the address range charged to one function: a sized symbol
+// covers [addr, addr+size), a bare assembly label runs to the next symbol.
+type funcRange struct {
+	name  string
+	start uint32
+	end   uint32
+}
+
+type profileConfig struct {
+	profilePath string
+	symbolsPath string
+	programPath string
+	top         int
+	blocks      int
+	annotate    string
+	layoutOut   string
+}
+
+// profileData is one QAR_PROFILE dump. trap holds, per PC, the cycles
+// spent between a trap and its MRET (already included in samples).
+type profileData struct {
+	samples map[uint32]causeCounts
+	trap    map[uint32]uint64
+	cycles  uint64
+	fetches uint64
+}
+
+type funcStat struct {
+	name   string
+	counts causeCounts
+	trap   uint64
+}
+
+func runProfile(args []string) {
+	cfg := &profileConfig{}
+	fs := flag.NewFlagSet("profile", flag.ExitOnError)
+	fs.StringVar(&cfg.profilePath, "profile", "profile_bench.txt", "Per-PC cycle profile written by the QAR_PROFILE testbench")
+	fs.StringVar(&cfg.symbolsPath, "symbols", "", "Symbol map from `qarsim build --symbols` or `elf2qar --symbols`")
+	fs.StringVar(&cfg.programPath, "program", "", "program.hex of the profiled firmware (enables basic blocks and --annotate)")
+	fs.IntVar(&cfg.top, "top", 20, "Functions to list in the flat profile (0 lists all)")
+	fs.IntVar(&cfg.blocks, "blocks", 10, "Hottest basic blocks to list (needs --program)")
+	fs.StringVar(&cfg.annotate, "annotate", "", "Print a per-instruction listing of this function (needs --program)")
+	fs.StringVar(&cfg.layoutOut, "layout-out", "", "Write per-function cycles for `qarsim build --layout`")
+	if err := fs.Parse(args); err != nil {
+		exitErr(err)
+	}
+	if err := doProfile(cfg); err != nil {
+		exitErr(err)
+	}
+}
+
+func doProfile(cfg *profileConfig) error {
+	if cfg.symbolsPath == "" {
+		return errors.New("--symbols is required")
+	}
+	data, err := parseProfile(cfg.profilePath)
+	if err != nil {
+		return err
+	}
+	samples, cycles := data.samples, data.cycles
+	syms, err := parseSymbolMap(cfg.symbolsPath)
+	if err != nil {
+		return err
+	}
+	ranges := buildFuncRanges(syms)
+
+	pcs := make([]uint32, 0, len(samples))
+	var totals causeCounts
+	for pc, counts := range samples {
+		pcs = append(pcs, pc)
+		totals.add(counts)
+	}
+	sort.Slice(pcs, func(i, j int) bool { return pcs[i] < pcs[j] })
+	if cycles == 0 {
+		cycles = totals.total()
+	}
+
+	fmt.Printf("%d cycles, %d instructions retired", cycles, totals[causeRetired])
+	if totals[causeRetired] > 0 {
+		fmt.Printf(" (CPI %.2f)", float64(cycles)/float64(totals[causeRetired]))
+	}
+	fmt.Printf("\n%d IMEM instruction fetches", data.fetches)
+	if totals[causeRetired] > 0 {
+		fmt.Printf(" (%.2f per instruction)", float64(data.fetches)/float64(totals[causeRetired]))
+	}
+	fmt.Printf("\n\n")
+
+	stats := functionStats(pcs, data, ranges)
+	printFlatProfile(cfg, stats, cycles)
+	printStallCauses(totals, cycles)
+	if cfg.layoutOut != "" {
+		if err := writeLayoutProfile(cfg.layoutOut, stats); err != nil {
+			return err
+		}
+		fmt.Printf("Layout profile: %s\n\n", cfg.layoutOut)
+	}
+
+	if cfg.programPath == "" {
+		if cfg.annotate != "" {
+			return errors.New("--annotate needs --program")
+		}
+		return nil
+	}
+	image, err := readProgramHex(cfg.programPath)
+	if err != nil {
+		return err
+	}
+	if cfg.blocks > 0 {
+		printHotBlocks(cfg, image, samples, ranges, cycles)
+	}
+	if cfg.annotate != "" {
+		return printAnnotated(cfg.annotate, image, samples, ranges)
+	}
+	return nil
+}
+
+// parseProfile reads "pc retired mem loaduse branch fetch sleep other trap"
+// rows; the "# qar profile: N cycles, F imem fetches" header gives the run
+// length.
+func parseProfile(path string) (*profileData, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer file.Close()
+
+	data := &profileData{samples: make(map[uint32]causeCounts), trap: make(map[uint32]uint64)}
+	scanner := bufio.NewScanner(file)
+	lineNo := 0
+	for scanner.Scan() {
+		lineNo++
+		line := strings.TrimSpace(scanner.Text())
+		if line == "" {
+			continue
+		}
+		if strings.HasPrefix(line, "#") {
+			fmt.Sscanf(line, "# qar profile: %d cycles, %d imem fetches", &data.cycles, &data.fetches)
+			continue
+		}
+		fields := strings.Fields(line)
+		if len(fields) != 2+numCauses {
+			return nil, fmt.Errorf("%s:%d: expected pc, %d counts and trap cycles", path, lineNo, numCauses)
+		}
+		pc, err := strconv.ParseUint(fields[0], 16, 32)
+		if err != nil {
+			return nil, fmt.Errorf("%s:%d: bad pc %q", path, lineNo, fields[0])
+		}
+		var values [numCauses + 1]uint64
+		for i := range values {
+			v, err := strconv.ParseUint(fields[1+i], 10, 64)
+			if err != nil {
+				return nil, fmt.Errorf("%s:%d: bad count %q", path, lineNo, fields[1+i])
+			}
+			values[i] = v
+		}
+		var counts causeCounts
+		copy(counts[:], values[:numCauses])
+		prev := data.samples[uint32(pc)]
+		prev.add(counts)
+		data.samples[uint32(pc)] = prev
+		data.trap[uint32(pc)] += values[numCauses]
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, err
+	}
+	if len(data.samples) == 0 {
+		return nil, fmt.Errorf("%s: no samples (was the testbench built with -DQAR_PROFILE?)", path)
+	}
+	return data, nil
+}
+
+// parseSymbolMap reads "addr size type name" lines (see elf2qar --symbols).
+func parseSymbolMap(path string) ([]symbolEntry, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer file.Close()
+
+	var syms []symbolEntry
+	scanner := bufio.NewScanner(file)
+	lineNo := 0
+	for scanner.Scan() {
+		lineNo++
+		line := strings.TrimSpace(scanner.Text())
+		if line == "" || strings.HasPrefix(line, "#") {
+			continue
+		}
+		fields := strings.Fields(line)
+		if len(fields) != 4 {
+			return nil, fmt.Errorf("%s:%d: expected addr size type name", path, lineNo)
+		}
+		addr, err := strconv.ParseUint(fields[0], 16, 32)
+		if err != nil {
+			return nil, fmt.Errorf("%s:%d: bad address %q", path, lineNo, fields[0])
+		}
+		size, err := strconv.ParseUint(fields[1], 10, 32)
+		if err != nil {
+			return nil, fmt.Errorf("%s:%d: bad size %q", path, lineNo, fields[1])
+		}
+		syms = append(syms, symbolEntry{addr: uint32(addr), size: uint32(size), kind: fields[2], name: fields[3]})
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, err
+	}
+	return syms, nil
+}
+
+// buildFuncRanges keeps code symbols (functions and untyped labels below
+// DMEM) and turns them into non-overlapping ranges. Labels inside a sized
+// function and aliases at the same address are folded into the first one.
+func buildFuncRanges(syms []symbolEntry) []funcRange {
+	var code []symbolEntry
+	for _, s := range syms {
+		if s.addr < dmemBase && (s.kind == "F" || s.kind == "N") {
+			code = append(code, s)
+		}
+	}
+	sort.SliceStable(code, func(i, j int) bool {
+		if code[i].addr != code[j].addr {
+			return code[i].addr < code[j].addr
+		}
+		return code[i].size > code[j].size
+	})
+
+	var ranges []funcRange
+	for _, s := range code {
+		if n := len(ranges); n > 0 {
+			last := &ranges[n-1]
+			if s.addr < last.end || s.addr == last.start {
+				continue
+			}
+			if last.end == 0 {
+				last.end = s.addr
+			}
+		}
+		r := funcRange{name: s.name, start: s.addr}
+		if s.size > 0 {
+			r.end = s.addr + s.size
+		}
+		ranges = append(ranges, r)
+	}
+	if n := len(ranges); n > 0 && ranges[n-1].end == 0 {
+		ranges[n-1].end = dmemBase
+	}
+	return ranges
+}
+
+func findRange(ranges []funcRange, pc uint32) (funcRange, bool) {
+	i := sort.Search(len(ranges), func(i int) bool { return ranges[i].start > pc }) - 1
+	if i < 0 || pc >= ranges[i].end {
+		return funcRange{}, false
+	}
+	return ranges[i], true
+}
+
+func symbolize(ranges []funcRange, pc uint32) string {
+	r, ok := findRange(ranges, pc)
+	if !ok {
+		return fmt.Sprintf("0x%08x", pc)
+	}
+	if pc == r.start {
+		return r.name
+	}
+	return fmt.Sprintf("%s+0x%x", r.name, pc-r.start)
+}
+
+func percent(part, whole uint64) float64 {
+	if whole == 0 {
+		return 0
+	}
+	return 100 * float64(part) / float64(whole)
+}
+
+// functionStats sums the samples per function, hottest first.
+func functionStats(pcs []uint32, data *profileData, ranges []funcRange) []*funcStat {
+	stats := make(map[string]*funcStat)
+	for _, pc := range pcs {
+		name := "(unknown)"
+		if r, ok := findRange(ranges, pc); ok {
+			name = r.name
+		}
+		st := stats[name]
+		if st == nil {
+			st = &funcStat{name: name}
+			stats[name] = st
+		}
+		st.counts.add(data.samples[pc])
+		st.trap += data.trap[pc]
+	}
+	list := make([]*funcStat, 0, len(stats))
+	for _, st := range stats {
+		list = append(list, st)
+	}
+	sort.Slice(list, func(i, j int) bool {
+		ti, tj := list[i].counts.total(), list[j].counts.total()
+		if ti != tj {
+			return ti > tj
+		}
+		return list[i].name < list[j].name
+	})
+	return list
+}
+
+func printFlatProfile(cfg *profileConfig, list []*funcStat, cycles uint64) {
+	fmt.Println("Flat profile:")
+	fmt.Printf("%10s %6s %6s %9s", "cycles", "%", "cum%", "retired")
+	for _, name := range causeNames[causeMem:] {
+		fmt.Printf(" %8s", name)
+	}
+	fmt.Printf(" %8s  function\n", "in-trap")
+	var cum uint64
+	for i, st := range list {
+		if cfg.top > 0 && i >= cfg.top {
+			fmt.Printf("  ... %d more\n", len(list)-i)
+			break
+		}
+		total := st.counts.total()
+		cum += total
+		fmt.Printf("%10d %6.2f %6.2f %9d", total, percent(total, cycles), percent(cum, cycles), st.counts[causeRetired])
+		for _, v := range st.counts[causeMem:] {
+			fmt.Printf(" %8d", v)
+		}
+		fmt.Printf(" %8d  %s\n", st.trap, st.name)
+	}
+	fmt.Println()
+}
+
+// writeLayoutProfile writes "cycles trap_cycles function" lines for
+// `qarsim build --layout`; see layout.go.
+func writeLayoutProfile(path string, stats []*funcStat) error {
+	var b strings.Builder
+	b.WriteString("# qar layout profile: cycles trap_cycles function\n")
+	for _, st := range stats {
+		if st.name == "(unknown)" {
+			continue
+		}
+		fmt.Fprintf(&b, "%d %d %s\n", st.counts.total(), st.trap, st.name)
+	}
+	return os.WriteFile(path, []byte(b.String()), 0o644)
+}
+
+func printStallCauses(totals causeCounts, cycles uint64) {
+	fmt.Println("Cycle causes:")
+	for i, name := range causeNames {
+		fmt.Printf("  %-8s %10d %6.2f%%  %s\n", name, totals[i], percent(totals[i], cycles), causeHelp[i])
+	}
+	fmt.Println()
+}
+
+// programImage is program.hex as halfwords, the granularity of RVC code.
+type programImage []uint16
+
+func readProgramHex(path string) (programImage, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer file.Close()
+
+	var image programImage
+	scanner := bufio.NewScanner(file)
+	lineNo := 0
+	for scanner.Scan() {
+		lineNo++
+		line := strings.TrimSpace(scanner.Text())
+		if line == "" {
+			continue
+		}
+		w, err := strconv.ParseUint(line, 16, 32)
+		if err != nil {
+			return nil, fmt.Errorf("%s:%d: bad hex word %q", path, lineNo, line)
+		}
+		image = append(image, uint16(w), uint16(w>>16))
+	}
+	return image, scanner.Err()
+}
+
+func (img programImage) decode(pc uint32) (decodedInst, bool) {
+	idx := pc / 2
+	if pc%2 != 0 || int(idx) >= len(img) {
+		return decodedInst{}, false
+	}
+	var hi uint16
+	if int(idx)+1 < len(img) {
+		hi = img[idx+1]
+	}
+	return decodeAt(pc, img[idx], hi), true
+}
+
+type basicBlock struct {
+	start  uint32
+	end    uint32 // address after the last instruction
+	insts  int
+	execs  uint64
+	counts causeCounts
+	last   decodedInst
+}
+
+// functionBlocks splits a function into basic blocks: a block starts at
+// the function entry, at every branch or jump target inside it and after
+// every control-flow instruction.
+func functionBlocks(img programImage, r funcRange, samples map[uint32]causeCounts) []basicBlock {
+	end := r.end
+	if limit := uint32(len(img)) * 2; end > limit {
+		end = limit
+	}
+	type instAt struct {
+		pc uint32
+		d  decodedInst
+	}
+	var insts []instAt
+	leaders := map[uint32]bool{r.start: true}
+	for pc := r.start; pc < end; {
+		d, ok := img.decode(pc)
+		if !ok {
+			break
+		}
+		insts = append(insts, instAt{pc, d})
+		if d.flow != flowNone {
+			leaders[pc+d.size] = true
+		}
+		if (d.flow == flowBranch || d.flow == flowJump) && d.target >= r.start && d.target < end {
+			leaders[d.target] = true
+		}
+		pc += d.size
+	}
+
+	var blocks []basicBlock
+	for _, in := range insts {
+		if leaders[in.pc] || len(blocks) == 0 {
+			blocks = append(blocks, basicBlock{start: in.pc, execs: samples[in.pc][causeRetired]})
+		}
+		b := &blocks[len(blocks)-1]
+		b.end = in.pc + in.d.size
+		b.insts++
+		b.counts.add(samples[in.pc])
+		b.last = in.d
+	}
+	return blocks
+}
+
+func printHotBlocks(cfg *profileConfig, img programImage, samples map[uint32]causeCounts, ranges []funcRange, cycles uint64) {
+	seen := make(map[uint32]bool)
+	var blocks []basicBlock
+	for pc := range samples {
+		r, ok := findRange(ranges, pc)
+		if !ok || seen[r.start] {
+			continue
+		}
+		seen[r.start] = true
+		for _, b := range functionBlocks(img, r, samples) {
+			if b.counts.total() > 0 {
+				blocks = append(blocks, b)
+			}
+		}
+	}
+	sort.Slice(blocks, func(i, j int) bool {
+		ti, tj := blocks[i].counts.total(), blocks[j].counts.total()
+		if ti != tj {
+			return ti > tj
+		}
+		return blocks[i].start < blocks[j].start
+	})
+
+	fmt.Println("Hot basic blocks:")
+	fmt.Printf("%10s %6s %8s %9s %6s  %-28s %s\n", "cycles", "%", "execs", "cyc/exec", "insts", "block", "ends with")
+	for i, b := range blocks {
+		if i >= cfg.blocks {
+			break
+		}
+		total := b.counts.total()
+		perExec := "-"
+		if b.execs > 0 {
+			perExec = fmt.Sprintf("%.1f", float64(total)/float64(b.execs))
+		}
+		fmt.Printf("%10d %6.2f %8d %9s %6d  %-28s %s\n", total, percent(total, cycles), b.execs, perExec,
+			b.insts, symbolize(ranges, b.start), b.last.text)
+	}
+	fmt.Println()
+}
+
+func printAnnotated(name string, img programImage, samples map[uint32]causeCounts, ranges []funcRange) error {
+	var r funcRange
+	found := false
+	for _, fr := range ranges {
+		if fr.name == name {
+			r, found = fr, true
+			break
+		}
+	}
+	if !found {
+		return fmt.Errorf("function %q not in the symbol map", name)
+	}
+
+	fmt.Printf("%s:\n", name)
+	fmt.Printf("%8s %8s", "pc", "cycles")
+	for _, cause := range causeNames {
+		fmt.Printf(" %7s", cause)
+	}
+	fmt.Printf("  instruction\n")
+	for _, b := range functionBlocks(img, r, samples) {
+		fmt.Printf("%s: %d execs\n", symbolize(ranges, b.start), b.execs)
+		for pc := b.start; pc < b.end; {
+			d, _ := img.decode(pc)
+			c := samples[pc]
+			fmt.Printf("%08x %8d", pc, c.total())
+			for _, v := range c {
+				fmt.Printf(" %7d", v)
+			}
+			fmt.Printf("  %s\n", d.text)
+			pc += d.size
+		}
+	}
+	return nil
+}
@@ -9,6 +9,7 @@ import (
 	"os"
 	"os/exec"
 	"path/filepath"
+	"sort"
 	"strconv"
 	"strings"
 )
@@ -19,19 +20,28 @@ type asmLine struct {
 	line int
 	raw  string
 	pc   uint32
+	size uint32 // bytes: 2 for C.* (RV32C), 4 otherwise
 }
 
 type buildConfig struct {
-	asmPaths   []string
-	cPaths     []string
-	cCompiler  string
-	cFlags     string
-	ldFlags    string
-	dataPath   string
-	programOut string
-	dataOut    string
-	imemDepth  int
-	dmemDepth  int
+	asmPaths      []string
+	cPaths        []string
+	cCompiler     string
+	cFlags        string
+	ldFlags       string
+	march         string
+	preloaded     bool
+	sched         bool
+	dsp           bool
+	periphCfg     string
+	symbolsOut    string
+	layout        string
+	icacheEntries int
+	dataPath      string
+	programOut    string
+	dataOut       string
+	imemDepth     int
+	dmemDepth     int
 }
 
 type sourceLine struct {
@@ -149,15 +159,39 @@ func main() {
 		runBuild(os.Args[2:])
 	case "run":
 		runRun(os.Args[2:])
+	case "profile":
+		runProfile(os.Args[2:])
+	case "wcet":
+		runWCET(os.Args[2:])
+	case "trace":
+		runTrace(os.Args[2:])
+	case "periphinit":
+		runPeriphInit(os.Args[2:])
 	default:
 		usage()
 	}
 }
 
 func usage() {
-	fmt.Fprintf(os.Stderr, "Usage: qarsim <build|run> [options]\n")
-	fmt.Fprintf(os.Stderr, "Use --asm <file> to point at the .qar assembly, or --c <file> to point at a C source.\n")
+	fmt.Fprintf(os.Stderr, "Usage: qarsim <build|run|profile|wcet|trace|periphinit> [options]\n")
+	fmt.Fprintf(os.Stderr, "Use --asm <file> to point at the .qar assembly, or --c <file> to point at a C or C++ (.cpp) source.\n")
 	fmt.Fprintf(os.Stderr, "Use --cc to override the C compiler, --cflags for extra compile flags, and --ldflags for linker flags.\n")
+	fmt.Fprintf(os.Stderr, "Use --march rv32i to build C firmware without the atomic (A) extension.\n")
+	fmt.Fprintf(os.Stderr, "Use --march rv32iac (or rv32ic) to emit compressed code; the core needs RVC_ENABLE=1.\n")
+	fmt.Fprintf(os.Stderr, "Use --periph-config board.json to initialise only the listed peripherals from a generated table.\n")
+	fmt.Fprintf(os.Stderr, "Use --sched to link the preemptive task scheduler (devkit/sdk/sched.h).\n")
+	fmt.Fprintf(os.Stderr, "Use --dsp to link the fixed-point filter library (devkit/sdk/dsp.h).\n")
+	fmt.Fprintf(os.Stderr, "Use --data-preloaded to skip the crt0 .data copy when data.hex is reloaded on every reset.\n")
+	fmt.Fprintf(os.Stderr, "Use --symbols firmware.sym to also write the symbol map for `qarsim profile`.\n")
+	fmt.Fprintf(os.Stderr, "Use --layout hot.layout [--icache-entries N] to place profiled hot functions together, I-cache aware.\n")
+	fmt.Fprintf(os.Stderr, "qarsim profile --profile profile_bench.txt --symbols firmware.sym [--program program.hex] reports\n")
+	fmt.Fprintf(os.Stderr, "  per-function and per-basic-block cycles and stall causes from a QAR_PROFILE simulation.\n")
+	fmt.Fprintf(os.Stderr, "qarsim wcet --program program.hex --symbols firmware.sym [--function f] [--budget f=N] reports\n")
+	fmt.Fprintf(os.Stderr, "  static best/worst-case cycles per function, using QAR_LOOP_BOUND annotations (devkit/sdk/wcet.h).\n")
+	fmt.Fprintf(os.Stderr, "qarsim trace --trace dump.txt --program program.hex [--symbols firmware.sym] rebuilds the executed\n")
+	fmt.Fprintf(os.Stderr, "  path from a dump of the on-chip branch/exception trace buffer (TRACE_DEPTH, devkit/hal/trace.h).\n")
+	fmt.Fprintf(os.Stderr, "qarsim periphinit [--config board.json] prints the generated init table, or with no config the\n")
+	fmt.Fprintf(os.Stderr, "  full qar_sdk_init() sequence (compared with hal_init.c by scripts/check_periphinit.sh).\n")
 	os.Exit(1)
 }
 
@@ -168,13 +202,21 @@ func defaultBuildFlagSet(name string) (*flag.FlagSet, *buildConfig) {
 		cfg.asmPaths = append(cfg.asmPaths, value)
 		return nil
 	})
-	fs.Func("c", "Path to C source file (repeatable)", func(value string) error {
+	fs.Func("c", "Path to C or C++ (.cpp/.cc/.cxx) source file (repeatable)", func(value string) error {
 		cfg.cPaths = append(cfg.cPaths, value)
 		return nil
 	})
 	fs.StringVar(&cfg.cCompiler, "cc", "", "C compiler for --c (default riscv32-unknown-elf-gcc or QAR_CC env)")
 	fs.StringVar(&cfg.cFlags, "cflags", "", "Extra C compiler flags (appended after QAR_CFLAGS)")
 	fs.StringVar(&cfg.ldFlags, "ldflags", "", "Extra linker flags (appended after QAR_LDFLAGS)")
+	fs.StringVar(&cfg.march, "march", "rv32ia", "Target ISA for --c (rv32i, rv32ia, rv32ic or rv32iac)")
+	fs.BoolVar(&cfg.preloaded, "data-preloaded", false, "C only: skip the crt0 .data copy because data.hex is reloaded on every reset")
+	fs.BoolVar(&cfg.sched, "sched", false, "C only: link the SDK task scheduler (devkit/sdk/sched.c, sched_switch.S)")
+	fs.BoolVar(&cfg.dsp, "dsp", false, "C only: link the SDK DSP filters (devkit/sdk/dsp.c, dsp.S)")
+	fs.StringVar(&cfg.periphCfg, "periph-config", "", "C only: JSON peripheral config; qar_sdk_init() replays the generated init table")
+	fs.StringVar(&cfg.layout, "layout", "", "C only: order hot functions from a `qarsim profile --layout-out` file")
+	fs.IntVar(&cfg.icacheEntries, "icache-entries", 0, "C only, with --layout: the core's ICACHE_ENTRIES, to keep hot code conflict-free")
+	fs.StringVar(&cfg.symbolsOut, "symbols", "", "Write a symbol map (functions and labels) for qarsim profile")
 	fs.StringVar(&cfg.dataPath, "data", "", "Path to data description file (optional)")
 	fs.StringVar(&cfg.programOut, "program", "program.hex", "Output path for program hex")
 	fs.StringVar(&cfg.dataOut, "data-out", "data.hex", "Output path for data hex")
@@ -234,24 +276,45 @@ func doBuild(cfg *buildConfig) error {
 		return err
 	}
 	labelTable = labels
-	if len(insts) > cfg.imemDepth {
-		return fmt.Errorf("program has %d instructions but imem depth is %d", len(insts), cfg.imemDepth)
+	var progBytes uint32
+	if len(insts) > 0 {
+		last := insts[len(insts)-1]
+		progBytes = last.pc + last.size
+	}
+	if progBytes > uint32(cfg.imemDepth)*4 {
+		return fmt.Errorf("program needs %d bytes but imem depth is %d words", progBytes, cfg.imemDepth)
 	}
 
-	words := make([]uint32, cfg.imemDepth)
-	for i := range words {
-		words[i] = 0x00000013 // NOP
+	// Lay the image out in halfwords so C.* instructions pack two per word.
+	halves := make([]uint16, cfg.imemDepth*2)
+	for i := 0; i < len(halves); i += 2 {
+		halves[i] = 0x0013 // NOP (low half of addi x0, x0, 0)
 	}
-	for i, inst := range insts {
+	for _, inst := range insts {
 		encoded, err := encodeInstruction(inst, labels)
 		if err != nil {
 			return err
 		}
-		words[i] = encoded
+		halves[inst.pc/2] = uint16(encoded)
+		if inst.size == 4 {
+			halves[inst.pc/2+1] = uint16(encoded >> 16)
+		}
+	}
+	if progBytes%4 == 2 {
+		halves[progBytes/2] = 0x0001 // C.NOP realigns the padding to a word
+	}
+	words := make([]uint32, cfg.imemDepth)
+	for i := range words {
+		words[i] = uint32(halves[2*i]) | uint32(halves[2*i+1])<<16
 	}
 	if err := writeHexFile(cfg.programOut, words); err != nil {
 		return err
 	}
+	if cfg.symbolsOut != "" {
+		if err := writeLabelSymbols(cfg.symbolsOut, labels); err != nil {
+			return err
+		}
+	}
 
 	dataWords := make([]uint32, cfg.dmemDepth)
 	if cfg.dataPath != "" {
@@ -272,6 +335,28 @@ func doBuild(cfg *buildConfig) error {
 	return nil
 }
 
+// writeLabelSymbols writes assembly labels in the elf2qar --symbols format.
+// Labels carry no size, so each one runs to the next.
+func writeLabelSymbols(path string, labels map[string]uint32) error {
+	names := make([]string, 0, len(labels))
+	for name := range labels {
+		names = append(names, name)
+	}
+	sort.Slice(names, func(i, j int) bool {
+		if labels[names[i]] != labels[names[j]] {
+			return labels[names[i]] < labels[names[j]]
+		}
+		return names[i] < names[j]
+	})
+
+	var b strings.Builder
+	b.WriteString("# qar symbols: addr size type name\n")
+	for _, name := range names {
+		fmt.Fprintf(&b, "%08x 0 N %s\n", labels[name], name)
+	}
+	return os.WriteFile(path, []byte(b.String()), 0o644)
+}
+
 func exitErr(err error) {
 	fmt.Fprintln(os.Stderr, err)
 	os.Exit(1)
@@ -325,8 +410,12 @@ func parseAssemblies(paths []string) ([]asmLine, map[string]uint32, error) {
 		}
 		op := strings.ToUpper(fields[0])
 		args := parseArgs(strings.Join(fields[1:], " "))
-		insts = append(insts, asmLine{op: op, args: args, line: src.line, raw: src.text, pc: pc})
-		pc += 4
+		size := uint32(4)
+		if isCompressedOp(op) {
+			size = 2
+		}
+		insts = append(insts, asmLine{op: op, args: args, line: src.line, raw: src.text, pc: pc, size: size})
+		pc += size
 	}
 	macroTable = parser.macros
 	return insts, labels, nil
@@ -336,12 +425,32 @@ func encodeInstruction(inst asmLine, labels map[string]uint32) (uint32, error) {
 	switch inst.op {
 	case "NOP":
 		return 0x00000013, nil
-	case "ADDI":
+	case "ADDI", "XORI", "ORI", "ANDI", "SLLI", "SRLI":
 		rd, rs1, imm, err := parseRRI(inst)
 		if err != nil {
 			return 0, err
 		}
-		word, err := encodeI(rd, rs1, imm, 0b000, 0x13)
+		var funct3 uint32
+		switch inst.op {
+		case "ADDI":
+			funct3 = 0b000
+		case "XORI":
+			funct3 = 0b100
+		case "ORI":
+			funct3 = 0b110
+		case "ANDI":
+			funct3 = 0b111
+		case "SLLI":
+			funct3 = 0b001
+		case "SRLI":
+			funct3 = 0b101
+		default:
+			return 0, fmt.Errorf("line %d: unsupported I-type %s", inst.line, inst.op)
+		}
+		if (inst.op == "SLLI" || inst.op == "SRLI") && (imm < 0 || imm > 31) {
+			return 0, fmt.Errorf("line %d: shift amount %d out of range", inst.line, imm)
+		}
+		word, err := encodeI(rd, rs1, imm, funct3, 0x13)
 		if err != nil {
 			return 0, fmt.Errorf("line %d: %w", inst.line, err)
 		}
@@ -436,14 +545,106 @@ func encodeInstruction(inst asmLine, labels map[string]uint32) (uint32, error) {
 			return 0, fmt.Errorf("line %d: ECALL takes no operands", inst.line)
 		}
 		return 0x00000073, nil
+	case "WFI":
+		if len(inst.args) != 0 {
+			return 0, fmt.Errorf("line %d: WFI takes no operands", inst.line)
+		}
+		return 0x10500073, nil
 	case "MRET":
 		if len(inst.args) != 0 {
 			return 0, fmt.Errorf("line %d: MRET takes no operands", inst.line)
 		}
 		return 0x30200073, nil
+	case "FENCE":
+		if len(inst.args) != 0 {
+			return 0, fmt.Errorf("line %d: FENCE takes no operands", inst.line)
+		}
+		return 0x0FF0000F, nil // fence iorw, iorw
+	case ".WORD":
+		// Constant data in program.hex; a core built with IMEM_DATA_LOADS=1
+		// reads it with LW, so it must be word-aligned.
+		if len(inst.args) != 1 {
+			return 0, fmt.Errorf("line %d: .WORD expects one value", inst.line)
+		}
+		if inst.pc%4 != 0 {
+			return 0, fmt.Errorf("line %d: .WORD at 0x%x is not word-aligned", inst.line, inst.pc)
+		}
+		if addr, ok := labels[strings.TrimSpace(inst.args[0])]; ok {
+			return addr, nil
+		}
+		val, err := parseImmediate(inst.args[0])
+		if err != nil {
+			return 0, fmt.Errorf("line %d: %w", inst.line, err)
+		}
+		return uint32(val), nil
 	default:
+		if isCompressedOp(inst.op) {
+			return encodeCompressed(inst, labels)
+		}
+		if strings.HasPrefix(inst.op, "LR.W") || strings.HasPrefix(inst.op, "SC.W") || strings.HasPrefix(inst.op, "AMO") {
+			return encodeAtomic(inst)
+		}
+		return 0, fmt.Errorf("line %d: unsupported opcode %s", inst.line, inst.op)
+	}
+}
+
+var amoFunct5 = map[string]uint32{
+	"LR.W":      0b00010,
+	"SC.W":      0b00011,
+	"AMOSWAP.W": 0b00001,
+	"AMOADD.W":  0b00000,
+	"AMOXOR.W":  0b00100,
+	"AMOAND.W":  0b01100,
+	"AMOOR.W":   0b01000,
+	"AMOMIN.W":  0b10000,
+	"AMOMAX.W":  0b10100,
+	"AMOMINU.W": 0b11000,
+	"AMOMAXU.W": 0b11100,
+}
+
+// encodeAtomic handles RV32A: "LR.W rd, (rs1)", "SC.W rd, rs2, (rs1)" and
+// "AMO<op>.W rd, rs2, (rs1)", each with an optional .AQ/.RL/.AQRL suffix.
+func encodeAtomic(inst asmLine) (uint32, error) {
+	base := inst.op
+	var ordering uint32
+	switch {
+	case strings.HasSuffix(base, ".AQRL"):
+		base, ordering = strings.TrimSuffix(base, ".AQRL"), 0b11
+	case strings.HasSuffix(base, ".AQ"):
+		base, ordering = strings.TrimSuffix(base, ".AQ"), 0b10
+	case strings.HasSuffix(base, ".RL"):
+		base, ordering = strings.TrimSuffix(base, ".RL"), 0b01
+	}
+	funct5, ok := amoFunct5[base]
+	if !ok {
 		return 0, fmt.Errorf("line %d: unsupported opcode %s", inst.line, inst.op)
 	}
+	wantArgs := 3
+	if base == "LR.W" {
+		wantArgs = 2
+	}
+	if len(inst.args) != wantArgs {
+		return 0, fmt.Errorf("line %d: %s expects %d operands", inst.line, inst.op, wantArgs)
+	}
+	rd, err := parseRegister(inst.args[0])
+	if err != nil {
+		return 0, fmt.Errorf("line %d: %w", inst.line, err)
+	}
+	rs2 := 0
+	if wantArgs == 3 {
+		if rs2, err = parseRegister(inst.args[1]); err != nil {
+			return 0, fmt.Errorf("line %d: %w", inst.line, err)
+		}
+	}
+	offset, rs1, err := parseOffsetArg(inst.args[wantArgs-1])
+	if err != nil {
+		return 0, fmt.Errorf("line %d: %w", inst.line, err)
+	}
+	if offset != 0 {
+		return 0, fmt.Errorf("line %d: %s takes no address offset", inst.line, inst.op)
+	}
+	return (funct5 << 27) | (ordering << 25) | (uint32(rs2) << 20) | (uint32(rs1) << 15) |
+		(0b010 << 12) | (uint32(rd) << 7) | 0x2F, nil
 }
 
 func encodeRType(inst asmLine) (uint32, error) {
@@ -877,6 +1078,7 @@ var csrNameMap = map[string]int{
 	"MTIMECMP": 0x720,
 	"IRQPRIO":  0xBC0,
 	"IRQACK":   0xBC1,
+	"IDLE":     0xBC2,
 }
 
 var registerMap = map[string]int{
@@ -0,0 +1,342 @@
+package main
+
+import (
+	"fmt"
+	"strings"
+)
+
+// RV32C (compressed) encoders. Mnemonics carry an explicit "C." prefix so a
+// listing shows exactly which instructions occupy a halfword; the assembler
+// never compresses a 32-bit mnemonic on its own.
+
+func isCompressedOp(op string) bool {
+	return strings.HasPrefix(op, "C.")
+}
+
+func encodeCompressed(inst asmLine, labels map[string]uint32) (uint32, error) {
+	half, err := encodeCompressedHalf(inst, labels)
+	if err != nil {
+		return 0, fmt.Errorf("line %d: %w", inst.line, err)
+	}
+	return uint32(half), nil
+}
+
+func encodeCompressedHalf(inst asmLine, labels map[string]uint32) (uint16, error) {
+	args := inst.args
+	switch inst.op {
+	case "C.NOP":
+		if len(args) != 0 {
+			return 0, fmt.Errorf("%s takes no operands", inst.op)
+		}
+		return 0x0001, nil
+	case "C.EBREAK":
+		if len(args) != 0 {
+			return 0, fmt.Errorf("%s takes no operands", inst.op)
+		}
+		return 0x9002, nil
+	case "C.ADDI", "C.LI":
+		rd, imm, err := parseCRegImm(inst)
+		if err != nil {
+			return 0, err
+		}
+		if rd == 0 {
+			return 0, fmt.Errorf("%s needs rd != x0", inst.op)
+		}
+		if imm < -32 || imm > 31 {
+			return 0, fmt.Errorf("%s immediate %d out of range [-32, 31]", inst.op, imm)
+		}
+		if inst.op == "C.ADDI" && imm == 0 {
+			return 0, fmt.Errorf("C.ADDI immediate must be non-zero")
+		}
+		funct3 := uint16(0b000)
+		if inst.op == "C.LI" {
+			funct3 = 0b010
+		}
+		return cImm6(funct3, rd, imm, 0b01), nil
+	case "C.LUI":
+		rd, imm, err := parseCRegImm(inst)
+		if err != nil {
+			return 0, err
+		}
+		if rd == 0 || rd == 2 {
+			return 0, fmt.Errorf("C.LUI needs rd other than x0/sp")
+		}
+		// Accept the 20-bit LUI operand; it must sign-extend from 6 bits.
+		if imm >= 0xFFFE0 && imm <= 0xFFFFF {
+			imm -= 1 << 20
+		}
+		if imm == 0 || imm < -32 || imm > 31 {
+			return 0, fmt.Errorf("C.LUI immediate %d out of range", imm)
+		}
+		return cImm6(0b011, rd, imm, 0b01), nil
+	case "C.ADDI16SP":
+		if len(args) == 2 {
+			if rd, err := parseRegister(args[0]); err != nil || rd != 2 {
+				return 0, fmt.Errorf("C.ADDI16SP destination must be sp")
+			}
+			args = args[1:]
+		}
+		if len(args) != 1 {
+			return 0, fmt.Errorf("C.ADDI16SP expects sp, imm")
+		}
+		imm, err := parseImmediate(args[0])
+		if err != nil {
+			return 0, err
+		}
+		if imm == 0 || imm%16 != 0 || imm < -512 || imm > 496 {
+			return 0, fmt.Errorf("C.ADDI16SP immediate %d must be a non-zero multiple of 16 in [-512, 496]", imm)
+		}
+		u := uint16(imm)
+		return 0b011<<13 | bit(u, 9)<<12 | 2<<7 | bit(u, 4)<<6 | bit(u, 6)<<5 |
+			bits(u, 8, 7)<<3 | bit(u, 5)<<2 | 0b01, nil
+	case "C.ADDI4SPN":
+		if len(args) != 3 {
+			return 0, fmt.Errorf("C.ADDI4SPN expects rd', sp, imm")
+		}
+		rd, err := parseCRegPrime(args[0])
+		if err != nil {
+			return 0, err
+		}
+		if sp, err := parseRegister(args[1]); err != nil || sp != 2 {
+			return 0, fmt.Errorf("C.ADDI4SPN source must be sp")
+		}
+		imm, err := parseImmediate(args[2])
+		if err != nil {
+			return 0, err
+		}
+		if imm <= 0 || imm%4 != 0 || imm > 1020 {
+			return 0, fmt.Errorf("C.ADDI4SPN immediate %d must be a non-zero multiple of 4 up to 1020", imm)
+		}
+		u := uint16(imm)
+		return bits(u, 5, 4)<<11 | bits(u, 9, 6)<<7 | bit(u, 2)<<6 | bit(u, 3)<<5 | rd<<2, nil
+	case "C.LW", "C.SW":
+		if len(args) != 2 {
+			return 0, fmt.Errorf("%s expects reg', offset(base')", inst.op)
+		}
+		reg, err := parseCRegPrime(args[0])
+		if err != nil {
+			return 0, err
+		}
+		offset, base, err := parseOffsetArg(args[1])
+		if err != nil {
+			return 0, err
+		}
+		if base < 8 || base > 15 {
+			return 0, fmt.Errorf("%s base must be one of x8-x15", inst.op)
+		}
+		if offset < 0 || offset > 124 || offset%4 != 0 {
+			return 0, fmt.Errorf("%s offset %d must be a multiple of 4 in [0, 124]", inst.op, offset)
+		}
+		funct3 := uint16(0b010)
+		if inst.op == "C.SW" {
+			funct3 = 0b110
+		}
+		u := uint16(offset)
+		return funct3<<13 | bits(u, 5, 3)<<10 | uint16(base-8)<<7 | bit(u, 2)<<6 | bit(u, 6)<<5 | reg<<2, nil
+	case "C.LWSP", "C.SWSP":
+		if len(args) != 2 {
+			return 0, fmt.Errorf("%s expects reg, offset(sp)", inst.op)
+		}
+		reg, err := parseRegister(args[0])
+		if err != nil {
+			return 0, err
+		}
+		offset, base, err := parseOffsetArg(args[1])
+		if err != nil {
+			return 0, err
+		}
+		if base != 2 {
+			return 0, fmt.Errorf("%s base must be sp", inst.op)
+		}
+		if offset < 0 || offset > 252 || offset%4 != 0 {
+			return 0, fmt.Errorf("%s offset %d must be a multiple of 4 in [0, 252]", inst.op, offset)
+		}
+		u := uint16(offset)
+		if inst.op == "C.LWSP" {
+			if reg == 0 {
+				return 0, fmt.Errorf("C.LWSP needs rd != x0")
+			}
+			return 0b010<<13 | bit(u, 5)<<12 | uint16(reg)<<7 | bits(u, 4, 2)<<4 | bits(u, 7, 6)<<2 | 0b10, nil
+		}
+		return 0b110<<13 | bits(u, 5, 2)<<9 | bits(u, 7, 6)<<7 | uint16(reg)<<2 | 0b10, nil
+	case "C.MV", "C.ADD":
+		if len(args) != 2 {
+			return 0, fmt.Errorf("%s expects rd, rs2", inst.op)
+		}
+		rd, err := parseRegister(args[0])
+		if err != nil {
+			return 0, err
+		}
+		rs2, err := parseRegister(args[1])
+		if err != nil {
+			return 0, err
+		}
+		if rd == 0 || rs2 == 0 {
+			return 0, fmt.Errorf("%s needs rd and rs2 != x0", inst.op)
+		}
+		word := uint16(0b1000<<12) | uint16(rd)<<7 | uint16(rs2)<<2 | 0b10
+		if inst.op == "C.ADD" {
+			word |= 1 << 12
+		}
+		return word, nil
+	case "C.JR", "C.JALR":
+		if len(args) != 1 {
+			return 0, fmt.Errorf("%s expects rs1", inst.op)
+		}
+		rs1, err := parseRegister(args[0])
+		if err != nil {
+			return 0, err
+		}
+		if rs1 == 0 {
+			return 0, fmt.Errorf("%s needs rs1 != x0", inst.op)
+		}
+		word := uint16(0b1000<<12) | uint16(rs1)<<7 | 0b10
+		if inst.op == "C.JALR" {
+			word |= 1 << 12
+		}
+		return word, nil
+	case "C.SUB", "C.XOR", "C.OR", "C.AND":
+		if len(args) != 2 {
+			return 0, fmt.Errorf("%s expects rd', rs2'", inst.op)
+		}
+		rd, err := parseCRegPrime(args[0])
+		if err != nil {
+			return 0, err
+		}
+		rs2, err := parseCRegPrime(args[1])
+		if err != nil {
+			return 0, err
+		}
+		funct2 := map[string]uint16{"C.SUB": 0, "C.XOR": 1, "C.OR": 2, "C.AND": 3}[inst.op]
+		return 0x8C01 | rd<<7 | funct2<<5 | rs2<<2, nil
+	case "C.ANDI":
+		if len(args) != 2 {
+			return 0, fmt.Errorf("C.ANDI expects rd', imm")
+		}
+		rd, err := parseCRegPrime(args[0])
+		if err != nil {
+			return 0, err
+		}
+		imm, err := parseImmediate(args[1])
+		if err != nil {
+			return 0, err
+		}
+		if imm < -32 || imm > 31 {
+			return 0, fmt.Errorf("C.ANDI immediate %d out of range [-32, 31]", imm)
+		}
+		return cImm6(0b100, int(rd), imm, 0b01) | 0b10<<10, nil
+	case "C.SRLI", "C.SRAI", "C.SLLI":
+		if len(args) != 2 {
+			return 0, fmt.Errorf("%s expects rd, shamt", inst.op)
+		}
+		shamt, err := parseImmediate(args[1])
+		if err != nil {
+			return 0, err
+		}
+		if shamt <= 0 || shamt > 31 {
+			return 0, fmt.Errorf("%s shift amount %d out of range [1, 31]", inst.op, shamt)
+		}
+		if inst.op == "C.SLLI" {
+			rd, err := parseRegister(args[0])
+			if err != nil {
+				return 0, err
+			}
+			if rd == 0 {
+				return 0, fmt.Errorf("C.SLLI needs rd != x0")
+			}
+			return uint16(rd)<<7 | uint16(shamt)<<2 | 0b10, nil
+		}
+		rd, err := parseCRegPrime(args[0])
+		if err != nil {
+			return 0, err
+		}
+		word := uint16(0b100<<13) | rd<<7 | uint16(shamt)<<2 | 0b01
+		if inst.op == "C.SRAI" {
+			word |= 0b01 << 10
+		}
+		return word, nil
+	case "C.J", "C.JAL":
+		if len(args) != 1 {
+			return 0, fmt.Errorf("%s expects a target", inst.op)
+		}
+		offset, err := resolveLabelOrImmediate(args[0], inst.pc, labels)
+		if err != nil {
+			return 0, err
+		}
+		if offset%2 != 0 || offset < -2048 || offset > 2046 {
+			return 0, fmt.Errorf("%s offset %d out of range", inst.op, offset)
+		}
+		funct3 := uint16(0b101)
+		if inst.op == "C.JAL" {
+			funct3 = 0b001
+		}
+		u := uint16(offset)
+		return funct3<<13 | bit(u, 11)<<12 | bit(u, 4)<<11 | bits(u, 9, 8)<<9 | bit(u, 10)<<8 |
+			bit(u, 6)<<7 | bit(u, 7)<<6 | bits(u, 3, 1)<<3 | bit(u, 5)<<2 | 0b01, nil
+	case "C.BEQZ", "C.BNEZ":
+		if len(args) != 2 {
+			return 0, fmt.Errorf("%s expects rs1', target", inst.op)
+		}
+		rs1, err := parseCRegPrime(args[0])
+		if err != nil {
+			return 0, err
+		}
+		offset, err := resolveLabelOrImmediate(args[1], inst.pc, labels)
+		if err != nil {
+			return 0, err
+		}
+		if offset%2 != 0 || offset < -256 || offset > 254 {
+			return 0, fmt.Errorf("%s offset %d out of range", inst.op, offset)
+		}
+		funct3 := uint16(0b110)
+		if inst.op == "C.BNEZ" {
+			funct3 = 0b111
+		}
+		u := uint16(offset)
+		return funct3<<13 | bit(u, 8)<<12 | bits(u, 4, 3)<<10 | rs1<<7 |
+			bits(u, 7, 6)<<5 | bits(u, 2, 1)<<3 | bit(u, 5)<<2 | 0b01, nil
+	default:
+		return 0, fmt.Errorf("unsupported opcode %s", inst.op)
+	}
+}
+
+// cImm6 builds the CI format shared by C.ADDI/C.LI/C.LUI/C.ANDI.
+func cImm6(funct3 uint16, rd int, imm int32, quadrant uint16) uint16 {
+	u := uint16(imm)
+	return funct3<<13 | bit(u, 5)<<12 | uint16(rd)<<7 | bits(u, 4, 0)<<2 | quadrant
+}
+
+func parseCRegImm(inst asmLine) (int, int32, error) {
+	if len(inst.args) != 2 {
+		return 0, 0, fmt.Errorf("%s expects rd, imm", inst.op)
+	}
+	rd, err := parseRegister(inst.args[0])
+	if err != nil {
+		return 0, 0, err
+	}
+	imm, err := parseImmediate(inst.args[1])
+	if err != nil {
+		return 0, 0, err
+	}
+	return rd, imm, nil
+}
+
+// parseCRegPrime accepts x8-x15 (s0, s1, a0-a5) and returns the 3-bit field.
+func parseCRegPrime(token string) (uint16, error) {
+	reg, err := parseRegister(token)
+	if err != nil {
+		return 0, err
+	}
+	if reg < 8 || reg > 15 {
+		return 0, fmt.Errorf("register %s not encodable in a compressed instruction (x8-x15 only)", token)
+	}
+	return uint16(reg - 8), nil
+}
+
+func bit(v uint16, n uint) uint16 {
+	return (v >> n) & 1
+}
+
+func bits(v uint16, hi, lo uint) uint16 {
+	return (v >> lo) & (1<<(hi-lo+1) - 1)
+}
@@ -0,0 +1,401 @@
+package main
+
+import (
+	"bufio"
+	"errors"
+	"flag"
+	"fmt"
+	"os"
+	"strconv"
+	"strings"
+)
+
+// `qarsim trace` rebuilds the executed path from a dump of the on-chip
+// trace buffer (qar-core/rtl/trace.v) and the program image. The buffer
+// only records what the image cannot tell: one bit per conditional branch,
+// JALR/MRET targets, traps and sync points. Everything else (straight-line
+// code, JAL) is replayed from program.hex.
+
+// Entry kinds, word0[31:30].
+const (
+	traceHist = iota // 20 branch bits; address = the last of those branches
+	traceJump        // JALR or MRET; address = target
+	traceTrap        // exception or interrupt; address = mepc
+	traceSync        // first instruction after enable or a trap; address = its pc
+)
+
+const traceHistBits = 20
+
+type traceEntry struct {
+	line  int
+	kind  int
+	count int    // branch bits in history, oldest in bit 0
+	hist  uint32 // 1 = taken
+	cause uint32 // mcause (interrupt bit and 4-bit code) for traceTrap
+	addr  uint32
+	time  uint32
+}
+
+type traceConfig struct {
+	tracePath   string
+	programPath string
+	symbolsPath string
+	quiet       bool
+	limit       int
+}
+
+// traceWalker follows the program image from pc, consuming branch bits.
+// Between two entries at most limit instructions are replayed, so a wrong
+// image or a corrupt dump ends in an error instead of a loop.
+type traceWalker struct {
+	img    programImage
+	ranges []funcRange
+	quiet  bool
+	limit  int
+
+	synced   bool
+	pc       uint32
+	runStart uint32
+	lastPC   uint32
+	runLen   int
+	// The last finished run, held back so a tight loop prints once
+	shown     [2]uint32
+	shownLen  int
+	shownReps int
+
+	insts    uint64
+	branches uint64
+	taken    uint64
+	jumps    uint64
+	traps    uint64
+	lost     uint64 // branch bits recorded while the decoder had no pc
+}
+
+func runTrace(args []string) {
+	cfg := &traceConfig{}
+	fs := flag.NewFlagSet("trace", flag.ExitOnError)
+	fs.StringVar(&cfg.tracePath, "trace", "trace_demo.txt", "Trace buffer dump: three hex words per entry, oldest first")
+	fs.StringVar(&cfg.programPath, "program", "", "program.hex of the traced firmware")
+	fs.StringVar(&cfg.symbolsPath, "symbols", "", "Symbol map from `qarsim build --symbols` (optional)")
+	fs.BoolVar(&cfg.quiet, "quiet", false, "Print only the summary")
+	fs.IntVar(&cfg.limit, "limit", 100000, "Instructions to replay between two entries before giving up")
+	if err := fs.Parse(args); err != nil {
+		exitErr(err)
+	}
+	if err := doTrace(cfg); err != nil {
+		exitErr(err)
+	}
+}
+
+func doTrace(cfg *traceConfig) error {
+	if cfg.programPath == "" {
+		return errors.New("--program is required")
+	}
+	img, err := readProgramHex(cfg.programPath)
+	if err != nil {
+		return err
+	}
+	var ranges []funcRange
+	if cfg.symbolsPath != "" {
+		syms, err := parseSymbolMap(cfg.symbolsPath)
+		if err != nil {
+			return err
+		}
+		ranges = buildFuncRanges(syms)
+	}
+	entries, err := parseTrace(cfg.tracePath)
+	if err != nil {
+		return err
+	}
+
+	w := &traceWalker{img: img, ranges: ranges, quiet: cfg.quiet, limit: cfg.limit}
+	if !cfg.quiet {
+		fmt.Printf("%10s  event\n", "mtime")
+	}
+	for _, e := range entries {
+		if err := w.apply(e); err != nil {
+			w.endRun()
+			w.flushRuns()
+			return fmt.Errorf("%s:%d: %w", cfg.tracePath, e.line, err)
+		}
+	}
+	w.endRun()
+	w.flushRuns()
+
+	first, last := entries[0].time, entries[len(entries)-1].time
+	if !cfg.quiet {
+		fmt.Println()
+	}
+	fmt.Printf("%d entries over %d cycles (mtime %d..%d)\n", len(entries), last-first, first, last)
+	fmt.Printf("%d instructions replayed: %d conditional branches (%d taken), %d indirect jumps, %d traps\n",
+		w.insts, w.branches, w.taken, w.jumps, w.traps)
+	if w.lost > 0 {
+		fmt.Printf("%d branch bits recorded before the first sync point were skipped\n", w.lost)
+	}
+	return nil
+}
+
+// parseTrace reads "word0 word1 word2" hex lines; '#' starts a comment.
+func parseTrace(path string) ([]traceEntry, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer file.Close()
+
+	var entries []traceEntry
+	scanner := bufio.NewScanner(file)
+	lineNo := 0
+	for scanner.Scan() {
+		lineNo++
+		line := scanner.Text()
+		if i := strings.IndexByte(line, '#'); i >= 0 {
+			line = line[:i]
+		}
+		fields := strings.Fields(line)
+		if len(fields) == 0 {
+			continue
+		}
+		if len(fields) != 3 {
+			return nil, fmt.Errorf("%s:%d: expected three hex words", path, lineNo)
+		}
+		var words [3]uint32
+		for i, f := range fields {
+			v, err := strconv.ParseUint(strings.TrimPrefix(f, "0x"), 16, 32)
+			if err != nil {
+				return nil, fmt.Errorf("%s:%d: bad hex word %q", path, lineNo, f)
+			}
+			words[i] = uint32(v)
+		}
+		e := traceEntry{
+			line:  lineNo,
+			kind:  int(words[0] >> 30),
+			count: int(words[0]>>25) & 31,
+			hist:  (words[0] >> 5) & (1<<traceHistBits - 1),
+			addr:  words[1],
+			time:  words[2],
+		}
+		if e.kind == traceTrap {
+			e.cause = (words[0]>>4&1)<<31 | words[0]&15
+		}
+		if e.count > traceHistBits {
+			return nil, fmt.Errorf("%s:%d: history count %d exceeds %d", path, lineNo, e.count, traceHistBits)
+		}
+		entries = append(entries, e)
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, err
+	}
+	if len(entries) == 0 {
+		return nil, fmt.Errorf("%s: no trace entries", path)
+	}
+	return entries, nil
+}
+
+func traceCauseName(cause uint32) string {
+	if cause>>31 != 0 {
+		switch cause & 15 {
+		case 7:
+			return "timer interrupt"
+		case 11:
+			return "external interrupt"
+		}
+		return fmt.Sprintf("interrupt %d", cause&15)
+	}
+	switch cause {
+	case 2:
+		return "illegal instruction"
+	case 4:
+		return "load misaligned"
+	case 5:
+		return "load fault"
+	case 6:
+		return "store misaligned"
+	case 7:
+		return "store fault"
+	case 11:
+		return "ecall"
+	}
+	return fmt.Sprintf("exception %d", cause)
+}
+
+func (w *traceWalker) sym(pc uint32) string {
+	if _, ok := findRange(w.ranges, pc); !ok {
+		return fmt.Sprintf("0x%08x", pc)
+	}
+	return fmt.Sprintf("0x%08x %s", pc, symbolize(w.ranges, pc))
+}
+
+func (w *traceWalker) event(time uint32, format string, args ...interface{}) {
+	w.endRun()
+	w.flushRuns()
+	if !w.quiet {
+		fmt.Printf("%10d  %s\n", time, fmt.Sprintf(format, args...))
+	}
+}
+
+// endRun closes the straight-line instructions replayed since the last
+// transfer of control; back-to-back repeats of one run are counted.
+func (w *traceWalker) endRun() {
+	if w.runLen == 0 {
+		return
+	}
+	run := [2]uint32{w.runStart, w.lastPC}
+	if w.shownReps > 0 && run == w.shown {
+		w.shownReps++
+	} else {
+		w.flushRuns()
+		w.shown, w.shownLen, w.shownReps = run, w.runLen, 1
+	}
+	w.runLen = 0
+}
+
+func (w *traceWalker) flushRuns() {
+	if w.shownReps == 0 {
+		return
+	}
+	if !w.quiet {
+		fmt.Printf("%10s    %s .. 0x%08x (%d instructions)", "", w.sym(w.shown[0]), w.shown[1], w.shownLen)
+		if w.shownReps > 1 {
+			fmt.Printf(" x%d", w.shownReps)
+		}
+		fmt.Println()
+	}
+	w.shownReps = 0
+}
+
+// retire counts the instruction at pc and moves to next.
+func (w *traceWalker) retire(pc, next, size uint32) {
+	if w.runLen == 0 {
+		w.runStart = pc
+	}
+	w.runLen++
+	w.lastPC = pc
+	w.insts++
+	w.pc = next
+	if next != pc+size {
+		w.endRun()
+	}
+}
+
+// walk replays instructions from pc. Conditional branches take their
+// direction from hist; it stops before a branch with no bits left, before
+// a JALR, MRET, ECALL or EBREAK (an error while bits remain), or once
+// stop(pc) holds with every bit used. It returns the pc of the last branch
+// it replayed.
+func (w *traceWalker) walk(hist uint32, count int, stop func(pc uint32) bool) (uint32, error) {
+	var lastBranch uint32
+	for steps := 0; ; steps++ {
+		if count == 0 && stop != nil && stop(w.pc) {
+			return lastBranch, nil
+		}
+		if steps == w.limit {
+			return 0, fmt.Errorf("replayed %d instructions from %s without finding the next event", steps, w.sym(w.pc))
+		}
+		d, ok := w.img.decode(w.pc)
+		if !ok {
+			return 0, fmt.Errorf("path leaves program.hex at 0x%08x", w.pc)
+		}
+		switch d.flow {
+		case flowBranch:
+			if count == 0 {
+				return lastBranch, nil
+			}
+			taken := hist&1 != 0
+			hist >>= 1
+			count--
+			lastBranch = w.pc
+			w.branches++
+			next := w.pc + d.size
+			if taken {
+				w.taken++
+				next = d.target
+			}
+			w.retire(w.pc, next, d.size)
+		case flowJump:
+			w.retire(w.pc, d.target, d.size)
+		case flowJumpReg, flowTrap:
+			if count > 0 {
+				return 0, fmt.Errorf("%d branch bits left over at %s (%s)", count, w.sym(w.pc), d.text)
+			}
+			return lastBranch, nil
+		default:
+			w.retire(w.pc, w.pc+d.size, d.size)
+		}
+	}
+}
+
+func (w *traceWalker) apply(e traceEntry) error {
+	if !w.synced {
+		w.lost += uint64(e.count)
+		switch e.kind {
+		case traceHist:
+			// The last bit belongs to the branch at addr: resume after it.
+			d, ok := w.img.decode(e.addr)
+			if !ok || d.flow != flowBranch || e.count == 0 {
+				return fmt.Errorf("history entry ends at 0x%08x, which is not a conditional branch", e.addr)
+			}
+			w.lost--
+			next := e.addr + d.size
+			if e.hist>>(e.count-1)&1 != 0 {
+				next = d.target
+			}
+			w.pc, w.synced = next, true
+			w.event(e.time, "sync   %s (after a branch)", w.sym(next))
+		case traceJump:
+			w.jumps++
+			w.pc, w.synced = e.addr, true
+			w.event(e.time, "jump   -> %s", w.sym(e.addr))
+		case traceTrap:
+			w.traps++
+			w.event(e.time, "trap   %s at %s", traceCauseName(e.cause), w.sym(e.addr))
+		case traceSync:
+			w.pc, w.synced = e.addr, true
+			w.event(e.time, "sync   %s", w.sym(e.addr))
+		}
+		return nil
+	}
+
+	switch e.kind {
+	case traceHist:
+		last, err := w.walk(e.hist, e.count, func(uint32) bool { return true })
+		if err != nil {
+			return err
+		}
+		if last != e.addr {
+			return fmt.Errorf("history ends at the branch at 0x%08x, the trace says 0x%08x", last, e.addr)
+		}
+	case traceJump:
+		if _, err := w.walk(e.hist, e.count, nil); err != nil {
+			return err
+		}
+		d, ok := w.img.decode(w.pc)
+		if !ok || (d.flow != flowJumpReg && d.text != "mret") {
+			return fmt.Errorf("expected a JALR or MRET at %s for the jump to 0x%08x", w.sym(w.pc), e.addr)
+		}
+		w.jumps++
+		from := w.pc
+		w.retire(w.pc, e.addr, d.size)
+		w.event(e.time, "jump   %s -> %s", w.sym(from), w.sym(e.addr))
+	case traceTrap:
+		if _, err := w.walk(e.hist, e.count, func(pc uint32) bool { return pc == e.addr }); err != nil {
+			return err
+		}
+		if w.pc != e.addr {
+			return fmt.Errorf("path stops at %s, the trap was taken at 0x%08x", w.sym(w.pc), e.addr)
+		}
+		w.traps++
+		w.event(e.time, "trap   %s at %s", traceCauseName(e.cause), w.sym(e.addr))
+		w.synced = false
+	case traceSync:
+		// After a disable/enable gap the path is unknown: take the new pc.
+		if e.count > 0 {
+			if _, err := w.walk(e.hist, e.count, func(uint32) bool { return true }); err != nil {
+				return err
+			}
+		}
+		w.pc = e.addr
+		w.event(e.time, "sync   %s", w.sym(e.addr))
+	}
+	return nil
+}
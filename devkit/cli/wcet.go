@@ -0,0 +1,1318 @@
+package main
+
+import (
+	"bufio"
+	"debug/elf"
+	"encoding/binary"
+	"errors"
+	"flag"
+	"fmt"
+	"math"
+	"os"
+	"sort"
+	"strconv"
+	"strings"
+)
+
+// Static best/worst-case cycle counts for `qarsim wcet`.
+//
+// Each function is split into basic blocks. A block's cost depends on how
+// it is entered: after a taken branch, jump, call, return or trap the
+// pipeline is empty, so the block is timed alone from a flush; on a
+// fall-through it is timed behind its predecessor. Both come from the
+// cycle model in pipeline.go, so the costs sit on CFG edges. Natural loops
+// are collapsed innermost first using their bounds, then the longest
+// (worst) and shortest (best) paths from the entry to a return are taken.
+// Calls add the callee's own bounds. A loop bound n allows n passes back
+// to the loop head per entry into the loop, so a loop whose test sits at
+// the bottom is charged one spare iteration.
+//
+// Worst case: every fetch misses the I-cache and loads/stores whose
+// address is not a known constant take the DMEM handshake. Inside a loop
+// whose code, callees included, maps onto the I-cache without index
+// conflicts, each word misses at most once per loop entry, which gives a
+// tighter bound when the cache is enabled. Best case: every fetch hits an
+// enabled I-cache and unknown accesses go to the peripheral bus.
+
+const cyclesInf = math.MaxUint64
+
+func satAdd(a, b uint64) uint64 {
+	if a == cyclesInf || b == cyclesInf || a+b < a {
+		return cyclesInf
+	}
+	return a + b
+}
+
+func satMul(a, b uint64) uint64 {
+	if a == 0 || b == 0 {
+		return 0
+	}
+	if a == cyclesInf || b == cyclesInf || a > cyclesInf/b {
+		return cyclesInf
+	}
+	return a * b
+}
+
+func formatCycles(v uint64) string {
+	if v == cyclesInf {
+		return "unbounded"
+	}
+	return strconv.FormatUint(v, 10)
+}
+
+type wcetConfig struct {
+	programPath   string
+	symbolsPath   string
+	elfPath       string
+	boundsPath    string
+	functions     string
+	budgets       string
+	icacheEntries int
+	imemWait      int
+	dmemWait      int
+	imemDataLoads bool
+}
+
+// wcetTimes holds one cost per analysis mode.
+type wcetTimes struct {
+	best uint64 // shortest path, warm I-cache, fast accesses
+	cold uint64 // longest path, cold I-cache
+	warm uint64 // longest path, every fetch hits the I-cache
+}
+
+type wcetBlock struct {
+	start, end uint32
+	insts      []pipeInst
+}
+
+type wcetEdge struct {
+	from, to int // to < 0: the function returns
+	cost     wcetTimes
+	callees  []*wcetFunc // called or tail-called on this edge
+	dead     bool
+}
+
+type wcetLoop struct {
+	header  int
+	body    map[int]bool
+	bound   uint64 // back edges taken per entry into the loop
+	bounded bool
+	source  string
+}
+
+type wcetFunc struct {
+	name    string
+	entry   uint32
+	times   wcetTimes
+	returns bool
+	loops   []*wcetLoop
+	blocks  []wcetBlock
+	notes   []string
+	words   map[uint32]bool // code footprint, callees included
+}
+
+type wcetBound struct {
+	n      uint64
+	source string
+}
+
+type wcetAnalyzer struct {
+	cfg        *wcetConfig
+	img        programImage
+	ranges     []funcRange
+	bounds     map[uint32]wcetBound // address in a loop -> its bound
+	funcBounds map[string]uint64    // --bounds entries naming a function
+	done       map[uint32]*wcetFunc
+	active     map[uint32]bool
+	modes      [3]pipeConfig // best, cold, warm
+}
+
+func runWCET(args []string) {
+	cfg := &wcetConfig{}
+	fs := flag.NewFlagSet("wcet", flag.ExitOnError)
+	fs.StringVar(&cfg.programPath, "program", "", "program.hex to analyse (with --symbols)")
+	fs.StringVar(&cfg.symbolsPath, "symbols", "", "Symbol map from `qarsim build --symbols`; B lines carry loop bounds")
+	fs.StringVar(&cfg.elfPath, "elf", "", "Firmware ELF to analyse instead of --program/--symbols")
+	fs.StringVar(&cfg.boundsPath, "bounds", "", "Extra loop bounds: \"0xADDR n\" (loop containing ADDR) or \"function n\" (its other loops)")
+	fs.StringVar(&cfg.functions, "function", "", "Comma-separated functions to report (default: all)")
+	fs.StringVar(&cfg.budgets, "budget", "", "Comma-separated function=cycles limits; exit 1 if a worst case exceeds one")
+	fs.IntVar(&cfg.icacheEntries, "icache-entries", 0, "The core's ICACHE_ENTRIES (0: no I-cache)")
+	fs.IntVar(&cfg.imemWait, "imem-wait", 0, "IMEM wait states per fetch")
+	fs.IntVar(&cfg.dmemWait, "dmem-wait", 0, "DMEM wait states per access")
+	fs.BoolVar(&cfg.imemDataLoads, "imem-data-loads", false, "The core's IMEM_DATA_LOADS: LW below 0x2000_0000 reads IMEM")
+	if err := fs.Parse(args); err != nil {
+		exitErr(err)
+	}
+	ok, err := doWCET(cfg)
+	if err != nil {
+		exitErr(err)
+	}
+	if !ok {
+		os.Exit(1)
+	}
+}
+
+func doWCET(cfg *wcetConfig) (bool, error) {
+	if cfg.icacheEntries < 0 || cfg.icacheEntries == 1 || cfg.icacheEntries&(cfg.icacheEntries-1) != 0 {
+		return false, fmt.Errorf("--icache-entries must be 0 or a power of two >= 2, got %d", cfg.icacheEntries)
+	}
+	if cfg.imemWait < 0 || cfg.dmemWait < 0 {
+		return false, errors.New("wait states cannot be negative")
+	}
+	var img programImage
+	var syms []symbolEntry
+	var err error
+	switch {
+	case cfg.elfPath != "":
+		img, syms, err = readWCETElf(cfg.elfPath)
+	case cfg.programPath != "" && cfg.symbolsPath != "":
+		if img, err = readProgramHex(cfg.programPath); err == nil {
+			syms, err = parseSymbolMap(cfg.symbolsPath)
+		}
+	default:
+		err = errors.New("need --elf, or --program with --symbols")
+	}
+	if err != nil {
+		return false, err
+	}
+
+	a := &wcetAnalyzer{
+		cfg:        cfg,
+		img:        img,
+		ranges:     buildFuncRanges(syms),
+		bounds:     make(map[uint32]wcetBound),
+		funcBounds: make(map[string]uint64),
+		done:       make(map[uint32]*wcetFunc),
+		active:     make(map[uint32]bool),
+	}
+	for _, s := range syms {
+		if s.kind == "B" {
+			a.addBound(s.addr, uint64(s.size), "annotation")
+		}
+	}
+	if cfg.boundsPath != "" {
+		if err := a.readBounds(cfg.boundsPath); err != nil {
+			return false, err
+		}
+	}
+	cache := cfg.icacheEntries > 0
+	base := pipeConfig{imemWait: cfg.imemWait, dmemWait: cfg.dmemWait, imemDataLoads: cfg.imemDataLoads}
+	a.modes[0], a.modes[1], a.modes[2] = base, base, base
+	a.modes[0].icacheHit = cache
+	a.modes[1].worst = true
+	a.modes[2].icacheHit, a.modes[2].worst = cache, true
+
+	var targets []funcRange
+	if cfg.functions == "" {
+		targets = a.ranges
+	} else {
+		for _, name := range strings.Split(cfg.functions, ",") {
+			r, ok := a.rangeByName(strings.TrimSpace(name))
+			if !ok {
+				return false, fmt.Errorf("function %q not found in the symbol table", name)
+			}
+			targets = append(targets, r)
+		}
+	}
+
+	cacheText := "no I-cache"
+	if cache {
+		cacheText = fmt.Sprintf("%d-entry I-cache", cfg.icacheEntries)
+	}
+	fmt.Printf("Three-stage core, IMEM wait %d, DMEM wait %d, %s; cycles from entry to the return leaving EX.\n\n",
+		cfg.imemWait, cfg.dmemWait, cacheText)
+	fmt.Printf("%10s %10s %6s  function\n", "best", "worst", "loops")
+	results := make(map[string]*wcetFunc)
+	for _, r := range targets {
+		f, err := a.analyze(r.start)
+		if err != nil {
+			return false, err
+		}
+		results[r.name] = f
+		best, worst := formatCycles(f.times.best), formatCycles(f.times.cold)
+		if !f.returns {
+			best, worst = "-", "no return"
+		}
+		fmt.Printf("%10s %10s %6d  %s\n", best, worst, len(f.loops), r.name)
+		loops := append([]*wcetLoop(nil), f.loops...)
+		sort.Slice(loops, func(i, j int) bool { return loops[i].header < loops[j].header })
+		for _, l := range loops {
+			pc := f.blocks[l.header].start
+			if l.bounded {
+				fmt.Printf("%28s loop at %s: at most %d iterations (%s)\n", "", symbolize(a.ranges, pc), l.bound, l.source)
+			} else {
+				fmt.Printf("%28s loop at %s: no bound; add QAR_LOOP_BOUND(n) or a --bounds entry\n", "", symbolize(a.ranges, pc))
+			}
+		}
+		for _, n := range f.notes {
+			fmt.Printf("%28s %s\n", "", n)
+		}
+	}
+	return checkBudgets(cfg.budgets, results)
+}
+
+// checkBudgets reports each function=cycles limit against the worst case.
+func checkBudgets(spec string, results map[string]*wcetFunc) (bool, error) {
+	if spec == "" {
+		return true, nil
+	}
+	fmt.Println()
+	ok := true
+	for _, item := range strings.Split(spec, ",") {
+		name, limitText, found := strings.Cut(strings.TrimSpace(item), "=")
+		limit, err := strconv.ParseUint(limitText, 10, 64)
+		if !found || err != nil {
+			return false, fmt.Errorf("bad --budget entry %q (want function=cycles)", item)
+		}
+		f := results[name]
+		if f == nil {
+			return false, fmt.Errorf("--budget names %q, which was not analysed", name)
+		}
+		worst := f.times.cold
+		if !f.returns {
+			worst = cyclesInf
+		}
+		status := "ok"
+		if worst > limit {
+			status = "OVER BUDGET"
+			ok = false
+		}
+		fmt.Printf("budget %s: worst %s of %d cycles: %s\n", name, formatCycles(worst), limit, status)
+	}
+	return ok, nil
+}
+
+func (a *wcetAnalyzer) rangeByName(name string) (funcRange, bool) {
+	for _, r := range a.ranges {
+		if r.name == name {
+			return r, true
+		}
+	}
+	return funcRange{}, false
+}
+
+func (a *wcetAnalyzer) addBound(addr uint32, n uint64, source string) {
+	// Duplicated annotations (an unrolled or inlined body) keep the largest
+	if old, ok := a.bounds[addr]; !ok || n > old.n {
+		a.bounds[addr] = wcetBound{n, source}
+	}
+}
+
+func (a *wcetAnalyzer) readBounds(path string) error {
+	file, err := os.Open(path)
+	if err != nil {
+		return err
+	}
+	defer file.Close()
+	scanner := bufio.NewScanner(file)
+	lineNo := 0
+	for scanner.Scan() {
+		lineNo++
+		line := strings.TrimSpace(scanner.Text())
+		if i := strings.IndexByte(line, '#'); i >= 0 {
+			line = strings.TrimSpace(line[:i])
+		}
+		if line == "" {
+			continue
+		}
+		fields := strings.Fields(line)
+		if len(fields) != 2 {
+			return fmt.Errorf("%s:%d: expected \"location bound\"", path, lineNo)
+		}
+		n, err := strconv.ParseUint(fields[1], 0, 32)
+		if err != nil {
+			return fmt.Errorf("%s:%d: bad bound %q", path, lineNo, fields[1])
+		}
+		if strings.HasPrefix(fields[0], "0x") {
+			addr, err := strconv.ParseUint(fields[0][2:], 16, 32)
+			if err != nil {
+				return fmt.Errorf("%s:%d: bad address %q", path, lineNo, fields[0])
+			}
+			a.addBound(uint32(addr), n, "--bounds "+fields[0])
+		} else {
+			a.funcBounds[fields[0]] = n
+		}
+	}
+	return scanner.Err()
+}
+
+// readWCETElf loads the IMEM image, symbols and .qar.wcet loop bounds
+// straight from the firmware ELF.
+func readWCETElf(path string) (programImage, []symbolEntry, error) {
+	f, err := elf.Open(path)
+	if err != nil {
+		return nil, nil, err
+	}
+	defer f.Close()
+
+	var img programImage
+	for _, p := range f.Progs {
+		if p.Type != elf.PT_LOAD || p.Filesz == 0 || p.Paddr >= dmemBase {
+			continue
+		}
+		data := make([]byte, p.Filesz)
+		if _, err := p.ReadAt(data, 0); err != nil {
+			return nil, nil, fmt.Errorf("%s: %w", path, err)
+		}
+		end := int(p.Paddr+p.Filesz+1) / 2
+		for len(img) < end {
+			img = append(img, 0)
+		}
+		for i := 0; i+1 < len(data); i += 2 {
+			img[(int(p.Paddr)+i)/2] = binary.LittleEndian.Uint16(data[i:])
+		}
+	}
+
+	elfSyms, err := f.Symbols()
+	if err != nil {
+		return nil, nil, fmt.Errorf("%s: %w", path, err)
+	}
+	var syms []symbolEntry
+	for _, s := range elfSyms {
+		if s.Name == "" || s.Name[0] == '$' || strings.HasPrefix(s.Name, ".L") || s.Section == elf.SHN_UNDEF {
+			continue
+		}
+		kind := ""
+		switch elf.ST_TYPE(s.Info) {
+		case elf.STT_FUNC:
+			kind = "F"
+		case elf.STT_OBJECT:
+			kind = "O"
+		case elf.STT_NOTYPE:
+			if s.Section != elf.SHN_ABS {
+				kind = "N"
+			}
+		}
+		if kind != "" {
+			syms = append(syms, symbolEntry{addr: uint32(s.Value), size: uint32(s.Size), kind: kind, name: s.Name})
+		}
+	}
+	if sec := f.Section(".qar.wcet"); sec != nil {
+		data, err := sec.Data()
+		if err != nil {
+			return nil, nil, fmt.Errorf("%s: %w", path, err)
+		}
+		for i := 0; i+8 <= len(data); i += 8 {
+			syms = append(syms, symbolEntry{
+				addr: binary.LittleEndian.Uint32(data[i:]),
+				size: binary.LittleEndian.Uint32(data[i+4:]),
+				kind: "B",
+				name: "loop_bound",
+			})
+		}
+	}
+	return img, syms, nil
+}
+
+func (img programImage) word32(pc uint32) uint32 {
+	i := int(pc / 2)
+	if i >= len(img) {
+		return 0
+	}
+	lo := uint32(img[i])
+	if lo&3 != 3 {
+		return expandCompressed(uint16(lo))
+	}
+	var hi uint32
+	if i+1 < len(img) {
+		hi = uint32(img[i+1])
+	}
+	return lo | hi<<16
+}
+
+func (a *wcetAnalyzer) note(f *wcetFunc, pc uint32, format string, args ...interface{}) {
+	f.addNote(fmt.Sprintf("%s: ", symbolize(a.ranges, pc)) + fmt.Sprintf(format, args...))
+}
+
+func (f *wcetFunc) addNote(text string) {
+	for _, n := range f.notes {
+		if n == text {
+			return
+		}
+	}
+	f.notes = append(f.notes, text)
+}
+
+// analyze returns the bounds of the code entered at entry: a function, or
+// the part of one that another function branches or falls into.
+func (a *wcetAnalyzer) analyze(entry uint32) (*wcetFunc, error) {
+	if f := a.done[entry]; f != nil {
+		return f, nil
+	}
+	f := &wcetFunc{name: symbolize(a.ranges, entry), entry: entry, words: make(map[uint32]bool)}
+	r, ok := findRange(a.ranges, entry)
+	if !ok {
+		f.times = wcetTimes{0, cyclesInf, cyclesInf}
+		f.returns = true
+		a.note(f, entry, "no code symbol")
+		return f, nil
+	}
+	if a.active[entry] {
+		f.times = wcetTimes{0, cyclesInf, cyclesInf}
+		f.returns = true
+		a.note(f, entry, "recursive call")
+		return f, nil
+	}
+	a.active[entry] = true
+	defer delete(a.active, entry)
+
+	if err := a.buildBlocks(f, r); err != nil {
+		return nil, err
+	}
+	edges, err := a.buildEdges(f, r)
+	if err != nil {
+		return nil, err
+	}
+	if err := a.solve(f, r, edges); err != nil {
+		return nil, err
+	}
+	a.done[entry] = f
+	return f, nil
+}
+
+// callee analyses code that f calls or continues into, carrying over why
+// its bound is missing.
+func (a *wcetAnalyzer) callee(f *wcetFunc, entry uint32) (*wcetFunc, error) {
+	c, err := a.analyze(entry)
+	if err != nil {
+		return nil, err
+	}
+	if a.done[entry] != c {
+		for _, n := range c.notes {
+			f.addNote(n)
+		}
+	} else if c.returns && c.times.cold == cyclesInf {
+		a.note(f, entry, "unbounded callee")
+	}
+	return c, nil
+}
+
+// buildBlocks decodes the function from r.start and splits the blocks
+// reachable from f.entry.
+func (a *wcetAnalyzer) buildBlocks(f *wcetFunc, r funcRange) error {
+	end := r.end
+	if limit := uint32(len(a.img)) * 2; end > limit {
+		end = limit
+	}
+	leaders := map[uint32]bool{f.entry: true}
+	var pcs []uint32
+	decoded := make(map[uint32]decodedInst)
+	for pc := r.start; pc < end; {
+		d, ok := a.img.decode(pc)
+		if !ok {
+			break
+		}
+		pcs = append(pcs, pc)
+		decoded[pc] = d
+		if d.flow != flowNone {
+			leaders[pc+d.size] = true
+		}
+		if (d.flow == flowBranch || d.flow == flowJump) && d.target >= r.start && d.target < end {
+			leaders[d.target] = true
+		}
+		pc += d.size
+	}
+
+	var blocks []wcetBlock
+	for _, pc := range pcs {
+		if leaders[pc] || len(blocks) == 0 {
+			blocks = append(blocks, wcetBlock{start: pc})
+		}
+		b := &blocks[len(blocks)-1]
+		d := decoded[pc]
+		b.insts = append(b.insts, pipeInst{pc: pc, size: d.size, instr: a.img.word32(pc)})
+		b.end = pc + d.size
+	}
+	f.blocks = blocks
+	for _, b := range blocks {
+		if b.start == f.entry {
+			return nil
+		}
+	}
+	return fmt.Errorf("wcet: %s does not start an instruction", f.name)
+}
+
+func (f *wcetFunc) blockAt(pc uint32) int {
+	i := sort.Search(len(f.blocks), func(i int) bool { return f.blocks[i].end > pc })
+	if i < len(f.blocks) && f.blocks[i].start <= pc {
+		return i
+	}
+	return -1
+}
+
+// Caller-saved registers: ra, t0-t2, a0-a7, t3-t6
+const callClobbered = 1<<1 | 7<<5 | 0xff<<10 | 0xf<<28
+
+type regValue struct {
+	kind uint8 // 0 unknown, 1 constant, 2 pointer into DMEM (sp), 3 register v as passed in
+	v    uint32
+}
+
+type regState [32]regValue
+
+func (s *regState) meet(o *regState) bool {
+	changed := false
+	for i := range s {
+		if s[i].kind != 0 && s[i] != o[i] {
+			s[i] = regValue{}
+			changed = true
+		}
+	}
+	return changed
+}
+
+func (a *wcetAnalyzer) classify(addr uint32) memClass {
+	switch {
+	case addr&0xffff0000 == 0x40000000:
+		return memPbus
+	case a.cfg.imemDataLoads && addr < dmemBase:
+		return memIMEM
+	}
+	return memDMEM
+}
+
+// step applies one instruction to s and sets the memory class of a load
+// or store from the tracked base register.
+func (a *wcetAnalyzer) step(s *regState, in *pipeInst) {
+	w := in.instr
+	rd := (w >> 7) & 31
+	rs1 := (w >> 15) & 31
+	rs2 := (w >> 20) & 31
+	immI := uint32(signExtend(w>>20, 12))
+	immS := uint32(signExtend((w>>25)<<5|(w>>7)&31, 12))
+	var out regValue
+	writes := true
+	switch w & 0x7f {
+	case 0x37: // LUI
+		out = regValue{1, w &^ 0xfff}
+	case 0x17: // AUIPC
+		out = regValue{1, in.pc + w&^0xfff}
+	case 0x13: // OP-IMM
+		switch {
+		case (w>>12)&7 != 0:
+		case s[rs1].kind == 1 || s[rs1].kind == 2:
+			out = regValue{s[rs1].kind, s[rs1].v + immI}
+		case immI == 0:
+			out = s[rs1]
+		}
+	case 0x33: // ADD with x0 is a move
+		if (w>>12)&7 == 0 && w>>25 == 0 {
+			switch {
+			case rs2 == 0:
+				out = s[rs1]
+			case rs1 == 0:
+				out = s[rs2]
+			case s[rs1].kind == 1 && s[rs2].kind == 1:
+				out = regValue{1, s[rs1].v + s[rs2].v}
+			}
+		}
+	case 0x03, 0x23:
+		imm := immI
+		if w&0x7f == 0x23 {
+			imm, writes = immS, false
+		}
+		switch s[rs1].kind {
+		case 1:
+			in.mem = a.classify(s[rs1].v + imm)
+		case 2:
+			in.mem = memDMEM
+		default:
+			in.mem = memUnknown
+		}
+	case 0x2f:
+		in.mem = memDMEM
+	case 0x63, 0x0f:
+		writes = false
+	case 0x73:
+		writes = (w>>12)&7 != 0
+	}
+	if writes && rd != 0 {
+		s[rd] = out
+	}
+	s[0] = regValue{1, 0}
+}
+
+// successor kinds of a block's last instruction
+const (
+	succFall = iota
+	succBranch
+	succJump
+	succCall
+	succReturn
+	succIndirect
+	succIndirectCall
+	succTrap
+)
+
+func blockExit(last pipeInst) (kind int, target uint32) {
+	w := last.instr
+	rd := (w >> 7) & 31
+	rs1 := (w >> 15) & 31
+	switch w & 0x7f {
+	case 0x63:
+		imm := (w>>31)<<12 | ((w>>7)&1)<<11 | ((w>>25)&0x3f)<<5 | ((w>>8)&0xf)<<1
+		return succBranch, last.pc + uint32(signExtend(imm, 13))
+	case 0x6f:
+		imm := (w>>31)<<20 | ((w>>12)&0xff)<<12 | ((w>>20)&1)<<11 | ((w>>21)&0x3ff)<<1
+		target = last.pc + uint32(signExtend(imm, 21))
+		if rd == 0 {
+			return succJump, target
+		}
+		return succCall, target
+	case 0x67:
+		switch {
+		case rd == 0 && rs1 == 1 && w>>20 == 0:
+			return succReturn, 0
+		case rd == 0:
+			return succIndirect, 0
+		}
+		return succIndirectCall, 0
+	case 0x73:
+		switch w {
+		case 0x30200073:
+			return succReturn, 0
+		case 0x00000073, 0x00100073:
+			return succTrap, 0
+		}
+	}
+	return succFall, 0
+}
+
+// jalrTarget resolves a block-ending JALR whose base register is set to a
+// constant earlier in the block.
+func (a *wcetAnalyzer) jalrTarget(b *wcetBlock) (uint32, bool) {
+	var s regState
+	s[0] = regValue{1, 0}
+	for _, in := range b.insts[:len(b.insts)-1] {
+		a.step(&s, &in)
+	}
+	w := b.insts[len(b.insts)-1].instr
+	base := s[(w>>15)&31]
+	if base.kind != 1 {
+		return 0, false
+	}
+	return (base.v + uint32(signExtend(w>>20, 12))) &^ 1, true
+}
+
+// buildEdges tracks constant registers through the blocks, then times
+// every edge in the three modes.
+func (a *wcetAnalyzer) buildEdges(f *wcetFunc, r funcRange) ([]wcetEdge, error) {
+	n := len(f.blocks)
+	type succ struct {
+		to       int
+		tail     uint32 // target outside the function (to < 0)
+		call     uint32
+		kind     int
+		hasCall  bool
+		isReturn bool
+	}
+	succs := make([][]succ, n)
+	entryBlock := f.blockAt(f.entry)
+	for i := range f.blocks {
+		b := &f.blocks[i]
+		last := b.insts[len(b.insts)-1]
+		kind, target := blockExit(last)
+		if kind == succIndirect || kind == succIndirectCall {
+			// auipc+jalr from `call`/`tail` without linker relaxation
+			if t, ok := a.jalrTarget(b); ok {
+				target = t
+				if kind == succIndirect {
+					kind = succJump
+				} else {
+					kind = succCall
+				}
+			}
+		}
+		local := func(pc uint32) int {
+			if pc < r.start || pc >= r.end {
+				return -1
+			}
+			return f.blockAt(pc)
+		}
+		fall := func() succ {
+			if j := local(b.end); j >= 0 {
+				return succ{to: j, kind: succFall}
+			}
+			return succ{to: -1, tail: b.end, kind: succFall}
+		}
+		switch kind {
+		case succFall, succTrap:
+			if kind == succTrap {
+				a.note(f, last.pc, "trap: handler not counted")
+			}
+			s := fall()
+			if kind == succTrap {
+				s.kind = succTrap
+			}
+			succs[i] = append(succs[i], s)
+		case succBranch:
+			if j := local(target); j >= 0 {
+				succs[i] = append(succs[i], succ{to: j, kind: succJump})
+			} else {
+				succs[i] = append(succs[i], succ{to: -1, tail: target, kind: succJump})
+			}
+			succs[i] = append(succs[i], fall())
+		case succJump:
+			if j := local(target); j >= 0 {
+				succs[i] = append(succs[i], succ{to: j, kind: succJump})
+			} else {
+				succs[i] = append(succs[i], succ{to: -1, tail: target, kind: succJump})
+			}
+		case succCall, succIndirectCall:
+			s := fall()
+			s.kind, s.call, s.hasCall = kind, target, true
+			succs[i] = append(succs[i], s)
+		case succReturn:
+			succs[i] = append(succs[i], succ{to: -1, isReturn: true})
+		case succIndirect:
+			succs[i] = append(succs[i], succ{to: -1, kind: succIndirect})
+		}
+	}
+
+	// Constant registers at block entry, for the memory class of each access
+	states := make([]*regState, n)
+	states[entryBlock] = &regState{}
+	for reg := range states[entryBlock] {
+		states[entryBlock][reg] = regValue{3, uint32(reg)}
+	}
+	states[entryBlock][0] = regValue{1, 0}
+	states[entryBlock][2] = regValue{2, 0}
+	work := []int{entryBlock}
+	for len(work) > 0 {
+		i := work[0]
+		work = work[1:]
+		s := *states[i]
+		for k := range f.blocks[i].insts {
+			a.step(&s, &f.blocks[i].insts[k])
+		}
+		for _, sc := range succs[i] {
+			if sc.to < 0 {
+				continue
+			}
+			out := s
+			if sc.hasCall {
+				for reg := 0; reg < 32; reg++ {
+					if callClobbered&(1<<reg) != 0 {
+						out[reg] = regValue{}
+					}
+				}
+			}
+			if states[sc.to] == nil {
+				states[sc.to] = &out
+				work = append(work, sc.to)
+			} else if states[sc.to].meet(&out) {
+				work = append(work, sc.to)
+			}
+		}
+	}
+
+	flushCost := make([]*wcetTimes, n)
+	timeFlush := func(j int) (wcetTimes, error) {
+		if flushCost[j] == nil {
+			t, err := a.timePath(f.blocks[j].insts, 0)
+			if err != nil {
+				return t, err
+			}
+			flushCost[j] = &t
+		}
+		return *flushCost[j], nil
+	}
+
+	var edges []wcetEdge
+	for i := range f.blocks {
+		if states[i] == nil {
+			continue // unreachable from the entry
+		}
+		for _, b := range f.blocks[i].insts {
+			f.words[b.pc&^3] = true
+			f.words[(b.pc+b.size-1)&^3] = true
+		}
+		for _, sc := range succs[i] {
+			e := wcetEdge{from: i, to: sc.to}
+			var err error
+			switch {
+			case sc.isReturn:
+			case sc.kind == succIndirect:
+				// Jumping to a register still holding the caller's value is a
+				// return (`jr t6` after `jal t6, f`)
+				s := *states[i]
+				last := f.blocks[i].insts[len(f.blocks[i].insts)-1]
+				for k := range f.blocks[i].insts[:len(f.blocks[i].insts)-1] {
+					in := f.blocks[i].insts[k]
+					a.step(&s, &in)
+				}
+				if base := s[(last.instr>>15)&31]; base.kind != 3 || last.instr>>20 != 0 {
+					a.note(f, last.pc, "indirect jump: not bounded")
+					e.cost = wcetTimes{0, cyclesInf, cyclesInf}
+				}
+			case sc.to < 0:
+				// Tail call, or a branch or fall-through into other code
+				if sc.hasCall {
+					// A call at the very end: only a callee that returns matters
+					if sc.kind == succIndirectCall {
+						a.note(f, f.blocks[i].insts[len(f.blocks[i].insts)-1].pc, "indirect call: not bounded")
+						e.cost = wcetTimes{0, cyclesInf, cyclesInf}
+					} else {
+						callee, cerr := a.callee(f, sc.call)
+						if cerr != nil {
+							return nil, cerr
+						}
+						if !callee.returns {
+							continue
+						}
+						e.cost = callee.times
+						e.callees = append(e.callees, callee)
+					}
+				}
+				callee, cerr := a.callee(f, sc.tail)
+				if cerr != nil {
+					return nil, cerr
+				}
+				if !callee.returns {
+					continue
+				}
+				e.cost = wcetTimes{
+					best: satAdd(e.cost.best, callee.times.best),
+					cold: satAdd(e.cost.cold, callee.times.cold),
+					warm: satAdd(e.cost.warm, callee.times.warm),
+				}
+				e.callees = append(e.callees, callee)
+			case sc.hasCall || sc.kind == succTrap:
+				ret, terr := timeFlush(sc.to)
+				if terr != nil {
+					return nil, terr
+				}
+				e.cost = ret
+				if sc.kind == succIndirectCall {
+					a.note(f, f.blocks[i].insts[len(f.blocks[i].insts)-1].pc, "indirect call: not bounded")
+					e.cost.cold, e.cost.warm = cyclesInf, cyclesInf
+				} else if sc.kind == succCall {
+					callee, cerr := a.callee(f, sc.call)
+					if cerr != nil {
+						return nil, cerr
+					}
+					if !callee.returns {
+						continue
+					}
+					e.cost = wcetTimes{
+						best: satAdd(callee.times.best, ret.best),
+						cold: satAdd(callee.times.cold, ret.cold),
+						warm: satAdd(callee.times.warm, ret.warm),
+					}
+					e.callees = append(e.callees, callee)
+				}
+			case sc.kind == succJump:
+				e.cost, err = timeFlush(sc.to)
+			default:
+				path := append(append([]pipeInst{}, f.blocks[i].insts...), f.blocks[sc.to].insts...)
+				e.cost, err = a.timePath(path, len(f.blocks[i].insts))
+			}
+			if err != nil {
+				return nil, err
+			}
+			for _, callee := range e.callees {
+				for w := range callee.words {
+					f.words[w] = true
+				}
+			}
+			edges = append(edges, e)
+		}
+	}
+	entry, err := timeFlush(entryBlock)
+	if err != nil {
+		return nil, err
+	}
+	// The entry cost rides on a virtual edge into the entry block
+	edges = append(edges, wcetEdge{from: -1, to: entryBlock, cost: entry})
+	return edges, nil
+}
+
+// timePath returns, per mode, the cycles from the retirement of path[split-1]
+// (or from the flush when split is 0) to the retirement of the last
+// instruction.
+func (a *wcetAnalyzer) timePath(path []pipeInst, split int) (wcetTimes, error) {
+	var out [3]uint64
+	for m := range a.modes {
+		retired, err := simulatePath(a.img, path, &a.modes[m])
+		if err != nil {
+			return wcetTimes{}, err
+		}
+		t := retired[len(retired)-1]
+		if split > 0 {
+			t -= retired[split-1]
+		}
+		out[m] = uint64(t)
+	}
+	return wcetTimes{best: out[0], cold: out[1], warm: out[2]}, nil
+}
+
+// solve finds the natural loops, attaches their bounds, collapses them
+// innermost first and takes the paths from the entry to a return.
+func (a *wcetAnalyzer) solve(f *wcetFunc, r funcRange, edges []wcetEdge) error {
+	n := len(f.blocks)
+	entryBlock := f.blockAt(f.entry)
+	preds := make([][]int, n)
+	succs := make([][]int, n)
+	reach := make([]bool, n)
+	for _, e := range edges {
+		if e.from >= 0 && e.to >= 0 {
+			succs[e.from] = append(succs[e.from], e.to)
+			preds[e.to] = append(preds[e.to], e.from)
+		}
+	}
+
+	// Reverse postorder and dominators (iterative, Cooper et al.)
+	var order []int
+	var dfs func(int)
+	dfs = func(b int) {
+		reach[b] = true
+		for _, s := range succs[b] {
+			if !reach[s] {
+				dfs(s)
+			}
+		}
+		order = append(order, b)
+	}
+	dfs(entryBlock)
+	rpo := make([]int, n)
+	for i := range rpo {
+		rpo[i] = -1
+	}
+	for i, b := range order {
+		rpo[b] = len(order) - 1 - i
+	}
+	idom := make([]int, n)
+	for i := range idom {
+		idom[i] = -1
+	}
+	idom[entryBlock] = entryBlock
+	intersect := func(x, y int) int {
+		for x != y {
+			for rpo[x] > rpo[y] {
+				x = idom[x]
+			}
+			for rpo[y] > rpo[x] {
+				y = idom[y]
+			}
+		}
+		return x
+	}
+	for changed := true; changed; {
+		changed = false
+		for i := len(order) - 1; i >= 0; i-- {
+			b := order[i]
+			if b == entryBlock {
+				continue
+			}
+			nd := -1
+			for _, p := range preds[b] {
+				if idom[p] < 0 {
+					continue
+				}
+				if nd < 0 {
+					nd = p
+				} else {
+					nd = intersect(p, nd)
+				}
+			}
+			if nd != idom[b] {
+				idom[b], changed = nd, true
+			}
+		}
+	}
+	dominates := func(h, b int) bool {
+		for {
+			if b == h {
+				return true
+			}
+			if b == entryBlock || idom[b] < 0 {
+				return false
+			}
+			b = idom[b]
+		}
+	}
+
+	// Natural loops; back edges to one header share a loop
+	loops := make(map[int]*wcetLoop)
+	for _, e := range edges {
+		if e.from < 0 || e.to < 0 || !reach[e.from] || !dominates(e.to, e.from) {
+			continue
+		}
+		l := loops[e.to]
+		if l == nil {
+			l = &wcetLoop{header: e.to, body: map[int]bool{e.to: true}}
+			loops[e.to] = l
+		}
+		stack := []int{e.from}
+		for len(stack) > 0 {
+			b := stack[len(stack)-1]
+			stack = stack[:len(stack)-1]
+			if l.body[b] {
+				continue
+			}
+			l.body[b] = true
+			stack = append(stack, preds[b]...)
+		}
+	}
+	for _, l := range loops {
+		f.loops = append(f.loops, l)
+	}
+	sort.Slice(f.loops, func(i, j int) bool {
+		if len(f.loops[i].body) != len(f.loops[j].body) {
+			return len(f.loops[i].body) < len(f.loops[j].body)
+		}
+		return f.loops[i].header < f.loops[j].header
+	})
+
+	// Bounds: an annotation belongs to the innermost loop around it
+	for addr, bound := range a.bounds {
+		b := f.blockAt(addr)
+		if b < 0 || addr < r.start || addr >= r.end {
+			continue
+		}
+		for _, l := range f.loops {
+			if l.body[b] {
+				if !l.bounded || bound.n > l.bound {
+					l.bound, l.bounded, l.source = bound.n, true, bound.source
+				}
+				break
+			}
+		}
+	}
+	if bound, ok := a.funcBounds[r.name]; ok {
+		for _, l := range f.loops {
+			if !l.bounded {
+				l.bound, l.bounded, l.source = bound, true, "--bounds "+r.name
+			}
+		}
+	}
+
+	rep := make([]int, n)
+	for i := range rep {
+		rep[i] = i
+	}
+	find := func(b int) int {
+		for rep[b] != b {
+			b = rep[b]
+		}
+		return b
+	}
+	penalty := uint64(1 + a.cfg.imemWait)
+	for _, l := range f.loops {
+		h := l.header
+		nodes := make(map[int]bool)
+		for b := range l.body {
+			nodes[find(b)] = true
+		}
+		var internal, back, exits []int
+		for i, e := range edges {
+			if e.dead || e.from < 0 || !nodes[find(e.from)] {
+				continue
+			}
+			switch {
+			case e.to >= 0 && find(e.to) == h:
+				back = append(back, i)
+			case e.to >= 0 && nodes[find(e.to)]:
+				if find(e.from) != find(e.to) {
+					internal = append(internal, i)
+				}
+			default:
+				exits = append(exits, i)
+			}
+		}
+		dist, err := dagDistances(h, internal, edges, find)
+		if err != nil {
+			return fmt.Errorf("%s: %w", symbolize(a.ranges, f.blocks[h].start), err)
+		}
+		var cycCold, cycWarm uint64
+		for _, i := range back {
+			d, ok := dist[find(edges[i].from)]
+			if !ok {
+				continue
+			}
+			cycCold = max(cycCold, satAdd(d.cold, edges[i].cost.cold))
+			cycWarm = max(cycWarm, satAdd(d.warm, edges[i].cost.warm))
+		}
+		iters := l.bound
+		if !l.bounded {
+			iters = cyclesInf
+		}
+		var words map[uint32]bool
+		if a.cfg.icacheEntries > 0 {
+			words = a.loopWords(f, l, edges)
+		}
+		persistent := words != nil
+		footprint := uint64(len(words))
+		for _, i := range exits {
+			d, ok := dist[find(edges[i].from)]
+			if !ok {
+				continue
+			}
+			e := &edges[i]
+			cold := satAdd(satAdd(satMul(iters, cycCold), d.cold), e.cost.cold)
+			warm := satAdd(satAdd(satMul(iters, cycWarm), d.warm), e.cost.warm)
+			if persistent {
+				cold = min(cold, satAdd(warm, footprint*penalty))
+			}
+			e.cost = wcetTimes{best: satAdd(d.best, e.cost.best), cold: cold, warm: warm}
+		}
+		for _, i := range append(internal, back...) {
+			edges[i].dead = true
+		}
+		for nd := range nodes {
+			rep[nd] = h
+		}
+	}
+
+	// Remaining graph is acyclic: paths from the entry to a return
+	var top []int
+	for i, e := range edges {
+		if !e.dead && e.from >= 0 && reach[e.from] && (e.to < 0 || find(e.from) != find(e.to)) {
+			top = append(top, i)
+		}
+	}
+	entry := edges[len(edges)-1].cost
+	toExit, err := exitDistances(find(entryBlock), top, edges, find)
+	if err != nil {
+		return fmt.Errorf("%s: %w", f.name, err)
+	}
+	if d, ok := toExit[find(entryBlock)]; ok {
+		f.returns = true
+		f.times = wcetTimes{
+			best: satAdd(entry.best, d.best),
+			cold: satAdd(entry.cold, d.cold),
+			warm: satAdd(entry.warm, d.warm),
+		}
+	}
+	return nil
+}
+
+// loopWords is the loop's code footprint including the functions it
+// calls; it returns nil when two of those words share an I-cache index.
+func (a *wcetAnalyzer) loopWords(f *wcetFunc, l *wcetLoop, edges []wcetEdge) map[uint32]bool {
+	words := make(map[uint32]bool)
+	for b := range l.body {
+		for _, in := range f.blocks[b].insts {
+			words[in.pc&^3] = true
+			words[(in.pc+in.size-1)&^3] = true
+		}
+	}
+	for _, e := range edges {
+		if e.from >= 0 && l.body[e.from] {
+			for _, callee := range e.callees {
+				for w := range callee.words {
+					words[w] = true
+				}
+			}
+		}
+	}
+	seen := make(map[uint32]uint32)
+	for w := range words {
+		idx := (w / 4) % uint32(a.cfg.icacheEntries)
+		if old, ok := seen[idx]; ok && old != w {
+			return nil
+		}
+		seen[idx] = w
+	}
+	return words
+}
+
+// dagDistances returns, for every node reachable from start over the
+// given acyclic edges, the longest (cold, warm) and shortest (best) cost.
+func dagDistances(start int, list []int, edges []wcetEdge, find func(int) int) (map[int]wcetTimes, error) {
+	out := make(map[int][]int)
+	for _, i := range list {
+		f := find(edges[i].from)
+		out[f] = append(out[f], i)
+	}
+	var order []int
+	state := make(map[int]int)
+	var visit func(int) error
+	visit = func(nd int) error {
+		state[nd] = 1
+		for _, i := range out[nd] {
+			to := find(edges[i].to)
+			switch state[to] {
+			case 1:
+				return errors.New("irreducible control flow")
+			case 0:
+				if err := visit(to); err != nil {
+					return err
+				}
+			}
+		}
+		state[nd] = 2
+		order = append(order, nd)
+		return nil
+	}
+	if err := visit(start); err != nil {
+		return nil, err
+	}
+	dist := map[int]wcetTimes{start: {}}
+	for k := len(order) - 1; k >= 0; k-- {
+		nd := order[k]
+		d := dist[nd]
+		for _, i := range out[nd] {
+			to := find(edges[i].to)
+			c := edges[i].cost
+			next := wcetTimes{satAdd(d.best, c.best), satAdd(d.cold, c.cold), satAdd(d.warm, c.warm)}
+			if old, ok := dist[to]; ok {
+				next = wcetTimes{min(old.best, next.best), max(old.cold, next.cold), max(old.warm, next.warm)}
+			}
+			dist[to] = next
+		}
+	}
+	return dist, nil
+}
+
+// exitDistances returns, for every node that can reach a return, the
+// longest (cold, warm) and shortest (best) cost to it.
+func exitDistances(start int, list []int, edges []wcetEdge, find func(int) int) (map[int]wcetTimes, error) {
+	out := make(map[int][]int)
+	for _, i := range list {
+		f := find(edges[i].from)
+		out[f] = append(out[f], i)
+	}
+	dist := make(map[int]wcetTimes)
+	state := make(map[int]int)
+	var visit func(int) error
+	visit = func(nd int) error {
+		state[nd] = 1
+		var best wcetTimes
+		found := false
+		for _, i := range out[nd] {
+			var rest wcetTimes
+			if to := edges[i].to; to >= 0 {
+				to = find(to)
+				switch state[to] {
+				case 1:
+					return errors.New("irreducible control flow")
+				case 0:
+					if err := visit(to); err != nil {
+						return err
+					}
+				}
+				d, ok := dist[to]
+				if !ok {
+					continue
+				}
+				rest = d
+			}
+			c := edges[i].cost
+			next := wcetTimes{satAdd(rest.best, c.best), satAdd(rest.cold, c.cold), satAdd(rest.warm, c.warm)}
+			if found {
+				next = wcetTimes{min(best.best, next.best), max(best.cold, next.cold), max(best.warm, next.warm)}
+			}
+			best, found = next, true
+		}
+		if found {
+			dist[nd] = best
+		}
+		state[nd] = 2
+		return nil
+	}
+	if err := visit(start); err != nil {
+		return nil, err
+	}
+	return dist, nil
+}
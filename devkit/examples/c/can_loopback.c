@@ -1,6 +1,7 @@
 #include <stdint.h>
 
 #include "hal/can.h"
+#include "hal/cpu.h"
 
 #define CAN_BASE QAR_CAN0_BASE
 
@@ -55,6 +56,7 @@ int main(void)
     send_frame(0x200u, 0x11111111u, 0u, 4); /* observed on bus only */
 
     while (1) {
-        /* Idle loop where firmware could enter low power or process other tasks */
+        /* Nothing left to do: stop fetching until an interrupt arrives */
+        qar_wait_for_interrupt();
     }
 }
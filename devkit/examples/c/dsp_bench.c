@@ -0,0 +1,209 @@
+#include <stdint.h>
+
+#include "hal/timer.h"
+#include "sdk/dsp.h"
+
+#define TIMER_BASE QAR_TIMER0_BASE
+
+/* Same mailbox protocol as runtime_bench.c (qar_core_bench_tb); the low
+ * half of a header is the sample count. */
+#define BENCH_MAILBOX (*(volatile uint32_t *)0x2FFFFFF0u)
+#define BENCH_DONE    0xFFFFFFFFu
+#define BENCH_FAIL    0xFFFFFFFDu
+
+enum {
+    BENCH_FIR_GENERIC = 14,
+    BENCH_FIR_Q15     = 15,
+    BENCH_FIR_Q31     = 16,
+    BENCH_BIQUAD_Q15  = 17,
+    BENCH_BIQUAD_Q31  = 18,
+    BENCH_MAVG_Q15    = 19,
+    BENCH_DECIM4_Q15  = 20,
+};
+
+#define BLOCK  64u
+#define TAPS   16u
+#define STAGES 2u
+#define DECIM  4u
+
+/* Hamming-windowed low-pass, cut-off 0.08 fs, unity DC gain in Q15 */
+static const int32_t fir_coefs[TAPS] = {
+    -71, -26, 177, 774, 1876, 3329, 4730, 5595,
+    5595, 4730, 3329, 1876, 774, 177, -26, -71,
+};
+
+/* 4th-order Butterworth low-pass, cut-off 0.05 fs: b0 b1 b2 a1 a2 in Q14 */
+static const int32_t biquad_coefs[5 * STAGES] = {
+    312, 624, 312, -24243, 9107,
+    359, 717, 359, -27869, 12919,
+};
+
+static int32_t in_q15[BLOCK];
+static int32_t in_q31[BLOCK];
+static int32_t out_q15[BLOCK];
+static int32_t out_q31[BLOCK];
+static int32_t ref_q15[BLOCK];
+static int32_t generic_hist[TAPS - 1u + BLOCK];
+
+static uint32_t fir_words[QAR_DSP_COEF_WORDS(TAPS)];
+static uint32_t fir31_words[QAR_DSP_COEF_WORDS(TAPS)];
+static uint32_t decim_words[QAR_DSP_COEF_WORDS(TAPS)];
+static uint32_t bq_words[QAR_DSP_BIQUAD_COEF_WORDS(STAGES)];
+static uint32_t bq31_words[QAR_DSP_BIQUAD_COEF_WORDS(STAGES)];
+static int32_t fir_state[QAR_DSP_FIR_STATE_WORDS(TAPS, BLOCK)];
+static int32_t fir31_state[QAR_DSP_FIR_STATE_WORDS(TAPS, BLOCK)];
+static int32_t decim_state[QAR_DSP_FIR_STATE_WORDS(TAPS, BLOCK)];
+static int32_t bq_state[QAR_DSP_BIQUAD_STATE_WORDS(STAGES)];
+static int32_t bq31_state[QAR_DSP_BIQUAD_STATE_WORDS(STAGES)];
+static int32_t mavg_window[16];
+
+static qar_dsp_fir_t fir;
+static qar_dsp_fir_t fir31;
+static qar_dsp_fir_t decim;
+static qar_dsp_biquad_t bq;
+static qar_dsp_biquad_t bq31;
+static qar_dsp_mavg_t mavg;
+
+static uint32_t timer_overhead;
+
+static inline uint32_t bench_now(void)
+{
+    return qar_timer_counter(TIMER_BASE);
+}
+
+static void bench_report(uint32_t id, uint32_t samples, uint32_t start, uint32_t end)
+{
+    BENCH_MAILBOX = (id << 16) | samples;
+    BENCH_MAILBOX = end - start - timer_overhead;
+}
+
+/* The plain C filter this library replaces: every tap is a __mulsi3 call.
+ * The final shift is unsigned (the core has no SRA). */
+__attribute__((noinline)) static void fir_generic(const int32_t *coefs, const int32_t *hist,
+                                                  int32_t *out, uint32_t count)
+{
+    for (uint32_t n = 0; n < count; n++) {
+        int32_t acc = 0;
+
+        for (uint32_t k = 0; k < TAPS; k++)
+            acc += coefs[k] * hist[n + TAPS - 1u - k];
+        out[n] = (int32_t)(((uint32_t)acc + 0x40004000u) >> 15) - 0x8000;
+    }
+}
+
+static int32_t to_q31(int32_t q15)
+{
+    return (int32_t)((uint32_t)q15 << 16);
+}
+
+/* 12-bit ADC codes (a triangle plus LFSR noise) centred and scaled to Q15 */
+static void make_input(void)
+{
+    uint32_t lfsr = 0xACE1u;
+    uint32_t code = 0;
+    uint32_t step = 97;
+
+    for (uint32_t i = 0; i < BLOCK; i++) {
+        lfsr ^= lfsr << 13;
+        lfsr ^= lfsr >> 17;
+        lfsr ^= lfsr << 5;
+        code += step;
+        if (code > 4000u) {
+            code = 4000u;
+            step = 0u - step;
+        } else if (code < 100u) {
+            code = 100u;
+            step = 0u - step;
+        }
+        in_q15[i] = ((int32_t)(code + (lfsr & 63u)) - 2048) << 3;
+        in_q31[i] = to_q31(in_q15[i]);
+        generic_hist[TAPS - 1u + i] = in_q15[i];
+    }
+}
+
+/* |a - b| <= limit without a signed compare */
+static int near(int32_t a, int32_t b, uint32_t limit)
+{
+    return (uint32_t)a - (uint32_t)b + limit <= 2u * limit;
+}
+
+int main(void)
+{
+    uint32_t t0;
+    uint32_t t1;
+    uint32_t errors = 0;
+
+    qar_timer_init(TIMER_BASE, 0, 0);
+
+    t0 = bench_now();
+    t1 = bench_now();
+    timer_overhead = t1 - t0;
+
+    make_input();
+    qar_dsp_fir_init_q15(&fir, fir_coefs, TAPS, fir_words, fir_state, BLOCK);
+    qar_dsp_fir_init_q31(&fir31, fir_coefs, TAPS, fir31_words, fir31_state, BLOCK);
+    qar_dsp_fir_init_q15(&decim, fir_coefs, TAPS, decim_words, decim_state, BLOCK);
+    qar_dsp_biquad_init_q15(&bq, biquad_coefs, STAGES, bq_words, bq_state);
+    qar_dsp_biquad_init_q31(&bq31, biquad_coefs, STAGES, bq31_words, bq31_state);
+    qar_dsp_mavg_init(&mavg, mavg_window, 4);
+
+    t0 = bench_now();
+    fir_generic(fir_coefs, generic_hist, ref_q15, BLOCK);
+    t1 = bench_now();
+    bench_report(BENCH_FIR_GENERIC, BLOCK, t0, t1);
+
+    t0 = bench_now();
+    qar_dsp_fir_q15(&fir, in_q15, out_q15, BLOCK);
+    t1 = bench_now();
+    bench_report(BENCH_FIR_Q15, BLOCK, t0, t1);
+
+    t0 = bench_now();
+    qar_dsp_fir_q31(&fir31, in_q31, out_q31, BLOCK);
+    t1 = bench_now();
+    bench_report(BENCH_FIR_Q31, BLOCK, t0, t1);
+
+    /* Shift-add must match the multiply exactly; Q31 within rounding */
+    for (uint32_t i = 0; i < BLOCK; i++) {
+        if (out_q15[i] != ref_q15[i])
+            errors++;
+        if (!near(out_q31[i], to_q31(out_q15[i]), 1u << 16))
+            errors++;
+    }
+
+    t0 = bench_now();
+    qar_dsp_biquad_q15(&bq, in_q15, out_q15, BLOCK);
+    t1 = bench_now();
+    bench_report(BENCH_BIQUAD_Q15, BLOCK, t0, t1);
+
+    t0 = bench_now();
+    qar_dsp_biquad_q31(&bq31, in_q31, out_q31, BLOCK);
+    t1 = bench_now();
+    bench_report(BENCH_BIQUAD_Q31, BLOCK, t0, t1);
+
+    for (uint32_t i = 0; i < BLOCK; i++) {
+        if (!near(out_q31[i], to_q31(out_q15[i]), 4u << 16))
+            errors++;
+    }
+
+    t0 = bench_now();
+    qar_dsp_mavg_q15(&mavg, in_q15, out_q15, BLOCK);
+    t1 = bench_now();
+    bench_report(BENCH_MAVG_Q15, BLOCK, t0, t1);
+
+    t0 = bench_now();
+    uint32_t produced = qar_dsp_fir_decimate_q15(&decim, in_q15, out_q15, BLOCK, DECIM);
+    t1 = bench_now();
+    bench_report(BENCH_DECIM4_Q15, BLOCK, t0, t1);
+
+    /* Decimated outputs are every DECIM-th full-rate output */
+    if (produced != BLOCK / DECIM)
+        errors++;
+    for (uint32_t i = 0; i < produced; i++) {
+        if (out_q15[i] != ref_q15[i * DECIM + DECIM - 1u])
+            errors++;
+    }
+
+    BENCH_MAILBOX = errors ? BENCH_FAIL : BENCH_DONE;
+    while (1)
+        ;
+}
@@ -0,0 +1,52 @@
+#include <stdint.h>
+
+#include "hal/evr.h"
+#include "hal/gpio.h"
+#include "hal/timer.h"
+
+#define GPIO_BASE  QAR_GPIO0_BASE
+#define TIMER_BASE QAR_TIMER0_BASE
+#define EVR_BASE   QAR_EVR0_BASE
+
+#define STEPPER_PINS   0x0000000Fu   /* coils A, B, A', B' on pins 0-3 */
+#define SENSE_PINS     0x0000FF00u   /* parallel bus sampled on pins 8-15 */
+#define STEP_CYCLES    50000u        /* 1 ms per half step at 50 MHz */
+
+/* Half-step drive sequence for a unipolar stepper */
+static const uint32_t half_steps[8] = {
+    0x1u, 0x3u, 0x2u, 0x6u, 0x4u, 0xCu, 0x8u, 0x9u,
+};
+
+static uint32_t samples[QAR_GPIO_SEQ_DEPTH];
+
+int main(void)
+{
+    qar_gpio_config_dir(GPIO_BASE, STEPPER_PINS);
+
+    /* One electrical revolution at a jitter-free rate, no CPU involvement.
+     * QAR_GPIO_SEQ_LOOP would keep the motor turning until stopped. */
+    qar_gpio_seq_load(GPIO_BASE, half_steps, 8);
+    qar_gpio_seq_play(GPIO_BASE, STEPPER_PINS, STEP_CYCLES, 0);
+    while (!qar_gpio_seq_done(GPIO_BASE))
+        ;
+    qar_gpio_seq_stop(GPIO_BASE);
+
+    /* Sample the parallel bus on every TIMER0 CMP0 event */
+    qar_evr_route(EVR_BASE, QAR_EVR_ACT_GPIO_SEQ_STEP, QAR_EVR_SRC_TIMER0_CMP0);
+    qar_evr_enable(EVR_BASE, 1);
+    qar_timer_set_compare0(TIMER_BASE, 1000u, 1000u);
+    qar_timer_init(TIMER_BASE, 0, QAR_TIMER_CTRL_CMP0_AUTO);
+
+    qar_gpio_seq_capture(GPIO_BASE, QAR_GPIO_SEQ_DEPTH, 0, QAR_GPIO_SEQ_EXT_TICK);
+    while (!qar_gpio_seq_done(GPIO_BASE))
+        ;
+    qar_gpio_seq_read(GPIO_BASE, samples, QAR_GPIO_SEQ_DEPTH);
+
+    volatile uint32_t first_sample = (samples[0] & SENSE_PINS) >> 8;
+    (void)first_sample;
+
+    while (1) {
+    }
+
+    return 0;
+}
@@ -3,7 +3,6 @@
 #include "hal/i2c.h"
 
 #define I2C_BASE QAR_I2C0_BASE
-#define QAR_I2C_CTRL_LOOPBACK_ACK (1u << 4)
 
 static void wait_cmd_clear(uint32_t cmd_mask)
 {
@@ -20,7 +19,7 @@ static void wait_idle(void)
 int main(void)
 {
     qar_i2c_init(I2C_BASE, 10);
-    QAR_I2C_CTRL(I2C_BASE) = QAR_I2C_CTRL_ENABLE | QAR_I2C_CTRL_LOOPBACK_ACK;
+    QAR_I2C_CTRL(I2C_BASE) = QAR_I2C_CTRL_ENABLE | QAR_I2C_CTRL_LOOPBACK;
 
     /* Stage 7-bit address (0x50<<1) and payload byte */
     qar_i2c_stage_tx(I2C_BASE, 0xA0u);
@@ -41,6 +40,19 @@ int main(void)
     volatile uint32_t status = QAR_I2C_STATUS(I2C_BASE);
     (void)status;
 
+    /* Same bus, but let the sequencer run a register read (reg 0x10, 2 bytes). */
+    uint32_t sample[2];
+    qar_i2c_write_read(I2C_BASE, 0x50u, 0x10u, 2u);
+    while (qar_i2c_seq_busy(I2C_BASE))
+        ;
+    volatile int got = qar_i2c_seq_collect(I2C_BASE, sample, 2u);
+    (void)got;
+
+    /* Longer than the RX FIFO: the sequencer stalls until bytes are popped. */
+    uint32_t block[12];
+    qar_i2c_write_read(I2C_BASE, 0x50u, 0x20u, 12u);
+    got = qar_i2c_seq_read(I2C_BASE, block, 12u);
+
     while (1) {
     }
 
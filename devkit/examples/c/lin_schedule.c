@@ -0,0 +1,64 @@
+#include <stdint.h>
+
+#include "hal/cpu.h"
+#include "hal/evr.h"
+#include "hal/timer.h"
+#include "hal/uart.h"
+
+#define UART_BASE  QAR_UART0_BASE
+#define TIMER_BASE QAR_TIMER0_BASE
+#define EVR_BASE   QAR_EVR0_BASE
+
+/* 5 ms LIN time base at 50 MHz, fed to the schedule through TIMER0 CMP0 */
+#define LIN_TIME_BASE_CYCLES 250000u
+
+static volatile uint32_t lin_responses;
+static volatile uint32_t lin_errors;
+
+static void lin_drain_response(void)
+{
+    /* Payload plus checksum; a real node would verify and publish it here */
+    while (qar_uart_available(UART_BASE)) {
+        volatile int byte = qar_uart_read(UART_BASE);
+        (void)byte;
+    }
+}
+
+int main(void)
+{
+    qar_uart_init(UART_BASE, 2604, QAR_UART_CTRL_LIN_MODE); /* 19200 baud at 50 MHz */
+
+    /* Schedule: two slave responses and one header-only master frame */
+    qar_uart_lin_sched_set_entry(UART_BASE, 0, qar_uart_lin_pid(0x10), 2, 3);
+    qar_uart_lin_sched_set_entry(UART_BASE, 1, qar_uart_lin_pid(0x11), 2, 5);
+    qar_uart_lin_sched_set_entry(UART_BASE, 2, qar_uart_lin_pid(0x3C), 4, 0);
+
+    /* The CPU only hears about completed responses and schedule errors */
+    qar_uart_enable_irq(UART_BASE, QAR_UART_IRQ_LIN_SCHED_RESP | QAR_UART_IRQ_LIN_SCHED_ERR);
+    qar_irq_enable_sources(QAR_MIE_MEIE);
+
+    qar_evr_route(EVR_BASE, QAR_EVR_ACT_UART0_LIN_TICK, QAR_EVR_SRC_TIMER0_CMP0);
+    qar_evr_enable(EVR_BASE, 1);
+    qar_timer_set_compare0(TIMER_BASE, LIN_TIME_BASE_CYCLES, LIN_TIME_BASE_CYCLES);
+    qar_timer_init(TIMER_BASE, 0, QAR_TIMER_CTRL_ENABLE | QAR_TIMER_CTRL_CMP0_AUTO);
+
+    qar_uart_lin_sched_start(UART_BASE, 3, 0);
+
+    while (1) {
+        /* Headers keep going out on time while the core sleeps */
+        qar_wait_for_interrupt();
+
+        uint32_t pending = QAR_UART_IRQ_STATUS(UART_BASE);
+        if (pending & QAR_UART_IRQ_LIN_SCHED_RESP) {
+            lin_drain_response();
+            lin_responses++;
+        }
+        if (pending & QAR_UART_IRQ_LIN_SCHED_ERR) {
+            lin_errors++;
+            qar_uart_lin_sched_clear(UART_BASE, QAR_UART_LIN_SCHED_FLAGS);
+        }
+        qar_uart_clear_irq(UART_BASE, pending & (QAR_UART_IRQ_LIN_SCHED_RESP | QAR_UART_IRQ_LIN_SCHED_ERR));
+    }
+
+    return 0;
+}
@@ -0,0 +1,280 @@
+#include <stdint.h>
+
+#include "hal/timer.h"
+#include "sdk/runtime.h"
+
+#define TIMER_BASE QAR_TIMER0_BASE
+
+/* Host port of qar_core_bench_tb: each store is printed, not kept */
+#define BENCH_MAILBOX (*(volatile uint32_t *)0x2FFFFFF0u)
+#define BENCH_DONE    0xFFFFFFFFu
+#define BENCH_FAIL    0xFFFFFFFDu
+
+enum {
+    BENCH_MEMCPY_ALIGNED = 0,
+    BENCH_MEMCPY_SKEWED  = 1,
+    BENCH_MEMMOVE_OVERLAP = 2,
+    BENCH_MEMSET         = 3,
+    BENCH_MEMCMP_EQUAL   = 4,
+    BENCH_MUL            = 5,
+    BENCH_UDIV           = 6,
+    BENCH_DIV            = 7,
+};
+
+#define BUF_WORDS  80
+#define EDGE_WORDS 12
+
+/* The muldiv.S entry points, called directly for the cases where the C
+ * operators would be undefined (INT_MIN / -1, division by zero). */
+uint32_t __mulsi3(uint32_t a, uint32_t b);
+uint32_t __udivsi3(uint32_t n, uint32_t d);
+uint32_t __umodsi3(uint32_t n, uint32_t d);
+int32_t __divsi3(int32_t n, int32_t d);
+int32_t __modsi3(int32_t n, int32_t d);
+
+struct mul_case {
+    uint32_t a, b, product;
+};
+
+struct div_case {
+    uint32_t n, d;
+    uint32_t udiv, umod, div, mod;
+};
+
+static const struct mul_case mul_cases[] = {
+    { 0x000003E8u, 0x01234567u, 0x71C71A58u },
+    { 0xFFFFFFF9u, 0x00000003u, 0xFFFFFFEBu }, /* -7 * 3 */
+    { 0xFFFFFFFFu, 0xFFFFFFFFu, 0x00000001u },
+    { 0x00010000u, 0x00010000u, 0x00000000u },
+    { 0x00000000u, 0x00003039u, 0x00000000u },
+    { 0x80000000u, 0xFFFFFFFFu, 0x80000000u }, /* INT_MIN * -1 */
+};
+
+/* Division by zero follows the RISC-V M rules: quotient all ones,
+ * remainder = dividend; INT_MIN / -1 = INT_MIN remainder 0. */
+static const struct div_case div_cases[] = {
+    { 0x000F4240u, 0x00000007u, 0x00022E09u, 0x00000001u, 0x00022E09u, 0x00000001u },
+    { 0xFFF0BDC0u, 0x00000007u, 0x24901B1Bu, 0x00000003u, 0xFFFDD1F7u, 0xFFFFFFFFu },
+    { 0x80000000u, 0xFFFFFFFFu, 0x00000000u, 0x80000000u, 0x80000000u, 0x00000000u },
+    { 0x00000007u, 0x00000000u, 0xFFFFFFFFu, 0x00000007u, 0xFFFFFFFFu, 0x00000007u },
+    { 0xFFFFFFF9u, 0x00000000u, 0xFFFFFFFFu, 0xFFFFFFF9u, 0xFFFFFFFFu, 0xFFFFFFF9u },
+    { 0xFFFFFFFFu, 0x00000001u, 0xFFFFFFFFu, 0x00000000u, 0xFFFFFFFFu, 0x00000000u },
+    { 0x00000007u, 0xFFFFFFFEu, 0x00000000u, 0x00000007u, 0xFFFFFFFDu, 0x00000001u },
+    { 0x80000000u, 0x00000002u, 0x40000000u, 0x00000000u, 0xC0000000u, 0x00000000u },
+};
+
+static uint32_t src_buf[BUF_WORDS];
+static uint32_t dst_buf[BUF_WORDS];
+static uint32_t ref_buf[BUF_WORDS];
+static uint32_t errors;
+
+/* Read through volatiles so GCC cannot inline or fold the calls away */
+static volatile uint32_t sizes[] = { 16, 64, 256 };
+static volatile uint32_t mul_args[] = { 1000, 0x1234567u };
+static volatile uint32_t div_args[] = { 1000000u, 7 };
+static volatile uint32_t sink;
+
+static uint32_t timer_overhead;
+
+static inline uint32_t bench_now(void)
+{
+    return qar_timer_counter(TIMER_BASE);
+}
+
+static void bench_report(uint32_t id, uint32_t bytes, uint32_t start, uint32_t end)
+{
+    BENCH_MAILBOX = (id << 16) | bytes;
+    BENCH_MAILBOX = end - start - timer_overhead;
+}
+
+/* The core has no byte loads or stores, so the reference works on words */
+static uint32_t get_byte(const uint32_t *buf, uint32_t i)
+{
+    return (buf[i >> 2] >> ((i & 3u) * 8u)) & 0xFFu;
+}
+
+static void put_byte(uint32_t *buf, uint32_t i, uint32_t value)
+{
+    uint32_t shift = (i & 3u) * 8u;
+
+    buf[i >> 2] = (buf[i >> 2] & ~(0xFFu << shift)) | ((value & 0xFFu) << shift);
+}
+
+/* Snapshot buf into ref_buf; the volatile keeps GCC from turning the loop
+ * into a call to the memcpy under test. */
+static void snapshot(const uint32_t *buf, uint32_t words)
+{
+    volatile uint32_t *ref = ref_buf;
+
+    for (uint32_t i = 0; i < words; i++)
+        ref[i] = buf[i];
+}
+
+/* Expected buf after copying n bytes from src+soff to buf+doff. Reads the
+ * source before the call, so an overlapping memmove needs no care here. */
+static void expect_copy(const uint32_t *buf, uint32_t words, uint32_t doff,
+                        const uint32_t *src, uint32_t soff, uint32_t n)
+{
+    snapshot(buf, words);
+    for (uint32_t i = 0; i < n; i++)
+        put_byte(ref_buf, doff + i, get_byte(src, soff + i));
+}
+
+static void expect_set(const uint32_t *buf, uint32_t words, uint32_t doff,
+                       uint32_t value, uint32_t n)
+{
+    snapshot(buf, words);
+    for (uint32_t i = 0; i < n; i++)
+        put_byte(ref_buf, doff + i, value);
+}
+
+/* Whole words, so a store past either end of the range is caught too */
+static void check(const uint32_t *buf, uint32_t words)
+{
+    for (uint32_t i = 0; i < words; i++) {
+        if (buf[i] != ref_buf[i])
+            errors++;
+    }
+}
+
+/* Untimed: every source/destination alignment, both overlap directions,
+ * odd lengths, and memcmp ordering (bytes compare as unsigned). */
+static void check_edges(void)
+{
+    uint8_t *src = (uint8_t *)src_buf;
+    uint8_t *dst = (uint8_t *)dst_buf;
+
+    for (uint32_t d = 0; d < 4; d++) {
+        for (uint32_t s = 0; s < 4; s++) {
+            expect_copy(dst_buf, EDGE_WORDS, 8 + d, src_buf, s, 13);
+            memcpy(dst + 8 + d, src + s, 13);
+            check(dst_buf, EDGE_WORDS);
+
+            expect_copy(dst_buf, EDGE_WORDS, 8 + d, dst_buf, 13 + s, 21);
+            memmove(dst + 8 + d, dst + 13 + s, 21);
+            check(dst_buf, EDGE_WORDS);
+
+            expect_copy(dst_buf, EDGE_WORDS, 13 + d, dst_buf, 8 + s, 21);
+            memmove(dst + 13 + d, dst + 8 + s, 21);
+            check(dst_buf, EDGE_WORDS);
+        }
+        expect_set(dst_buf, EDGE_WORDS, 8 + d, 0xA5u, 13);
+        memset(dst + 8 + d, 0x1A5, 13); /* only the low byte is stored */
+        check(dst_buf, EDGE_WORDS);
+    }
+
+    expect_copy(dst_buf, EDGE_WORDS, 0, src_buf, 0, 4 * EDGE_WORDS);
+    memcpy(dst, src, 4 * EDGE_WORDS);
+    check(dst_buf, EDGE_WORDS);
+    put_byte(dst_buf, 21, 0xFFu);
+    put_byte(src_buf, 21, 0x01u);
+    if (memcmp(dst + 1, src + 1, 20) != 0 || memcmp(dst, src, 0) != 0)
+        errors++;
+    if (memcmp(dst + 1, src + 1, 21) <= 0 || memcmp(src + 3, dst + 3, 30) >= 0)
+        errors++;
+}
+
+static void check_muldiv(void)
+{
+    for (uint32_t i = 0; i < sizeof(mul_cases) / sizeof(mul_cases[0]); i++) {
+        const struct mul_case *c = &mul_cases[i];
+
+        if (__mulsi3(c->a, c->b) != c->product)
+            errors++;
+    }
+    for (uint32_t i = 0; i < sizeof(div_cases) / sizeof(div_cases[0]); i++) {
+        const struct div_case *c = &div_cases[i];
+
+        if (__udivsi3(c->n, c->d) != c->udiv || __umodsi3(c->n, c->d) != c->umod)
+            errors++;
+        if ((uint32_t)__divsi3((int32_t)c->n, (int32_t)c->d) != c->div ||
+            (uint32_t)__modsi3((int32_t)c->n, (int32_t)c->d) != c->mod)
+            errors++;
+    }
+}
+
+int main(void)
+{
+    qar_timer_init(TIMER_BASE, 0, 0);
+
+    uint32_t t0 = bench_now();
+    uint32_t t1 = bench_now();
+    timer_overhead = t1 - t0;
+
+    for (uint32_t i = 0; i < BUF_WORDS; i++)
+        src_buf[i] = i * 0x01010101u;
+
+    uint8_t *src = (uint8_t *)src_buf;
+    uint8_t *dst = (uint8_t *)dst_buf;
+
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t n = sizes[s];
+
+        expect_copy(dst_buf, BUF_WORDS, 0, src_buf, 0, n);
+        t0 = bench_now();
+        memcpy(dst, src, n);
+        t1 = bench_now();
+        bench_report(BENCH_MEMCPY_ALIGNED, n, t0, t1);
+        check(dst_buf, BUF_WORDS);
+
+        expect_copy(dst_buf, BUF_WORDS, 0, src_buf, 1, n);
+        t0 = bench_now();
+        memcpy(dst, src + 1, n);
+        t1 = bench_now();
+        bench_report(BENCH_MEMCPY_SKEWED, n, t0, t1);
+        check(dst_buf, BUF_WORDS);
+
+        expect_copy(src_buf, BUF_WORDS, 4, src_buf, 0, n);
+        t0 = bench_now();
+        memmove(src + 4, src, n);
+        t1 = bench_now();
+        bench_report(BENCH_MEMMOVE_OVERLAP, n, t0, t1);
+        check(src_buf, BUF_WORDS);
+
+        expect_set(dst_buf, BUF_WORDS, 0, 0x5Au, n);
+        t0 = bench_now();
+        memset(dst, 0x5A, n);
+        t1 = bench_now();
+        bench_report(BENCH_MEMSET, n, t0, t1);
+        check(dst_buf, BUF_WORDS);
+
+        memcpy(dst, src, n);
+        t0 = bench_now();
+        sink = (uint32_t)memcmp(dst, src, n);
+        t1 = bench_now();
+        bench_report(BENCH_MEMCMP_EQUAL, n, t0, t1);
+        if (sink != 0)
+            errors++;
+    }
+
+    /* Arithmetic helpers: bytes = 0, the cycles are per call */
+    t0 = bench_now();
+    sink = mul_args[0] * mul_args[1];
+    t1 = bench_now();
+    bench_report(BENCH_MUL, 0, t0, t1);
+    if (sink != 0x71C71A58u)
+        errors++;
+
+    t0 = bench_now();
+    sink = div_args[0] / div_args[1];
+    t1 = bench_now();
+    bench_report(BENCH_UDIV, 0, t0, t1);
+    if (sink != 142857u)
+        errors++;
+
+    t0 = bench_now();
+    sink = (uint32_t)((int32_t)-div_args[0] / (int32_t)div_args[1]);
+    t1 = bench_now();
+    bench_report(BENCH_DIV, 0, t0, t1);
+    if (sink != (uint32_t)-142857)
+        errors++;
+
+    check_edges();
+    check_muldiv();
+
+    BENCH_MAILBOX = errors ? BENCH_FAIL : BENCH_DONE;
+    while (1) {
+    }
+
+    return 0;
+}
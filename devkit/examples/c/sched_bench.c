@@ -0,0 +1,140 @@
+#include <stdint.h>
+
+#include "hal/timer.h"
+#include "sdk/sched.h"
+
+#define TIMER_BASE QAR_TIMER0_BASE
+
+/* Same mailbox protocol as runtime_bench.c (qar_core_bench_tb) */
+#define BENCH_MAILBOX (*(volatile uint32_t *)0x2FFFFFF0u)
+#define BENCH_DONE    0xFFFFFFFFu
+
+enum {
+    BENCH_SWITCH_MIN = 8,
+    BENCH_SWITCH_MAX = 9,
+    BENCH_POST_MIN   = 10,
+    BENCH_POST_MAX   = 11,
+    BENCH_TICK_MIN   = 12,
+    BENCH_TICK_MAX   = 13,
+};
+
+#define TICK_CYCLES 5000u
+#define ROUNDS      8u
+
+#define EVT_GO (1u << 0)
+
+#define PRIO_HIGH 1u
+#define PRIO_LOW  3u
+
+QAR_TASK_STACK(high_stack, 128);
+QAR_TASK_STACK(ping_stack, 128);
+QAR_TASK_STACK(peer_stack, 128);
+
+static qar_task_t high_task;
+static qar_task_t ping_task;
+static qar_task_t peer_task;
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+} bench_range_t;
+
+static bench_range_t switch_cycles = { 0xFFFFFFFFu, 0 };
+static bench_range_t post_cycles   = { 0xFFFFFFFFu, 0 };
+static bench_range_t tick_cycles   = { 0xFFFFFFFFu, 0 };
+
+static volatile uint32_t stamp;
+static uint32_t timer_overhead;
+
+static inline uint32_t bench_now(void)
+{
+    return qar_timer_counter(TIMER_BASE);
+}
+
+static void range_add(bench_range_t *range, uint32_t cycles)
+{
+    if (cycles < range->min)
+        range->min = cycles;
+    if (cycles > range->max)
+        range->max = cycles;
+}
+
+static void bench_report(uint32_t id, uint32_t cycles)
+{
+    BENCH_MAILBOX = id << 16;
+    BENCH_MAILBOX = cycles;
+}
+
+/* Priority 1: post-to-run latency, then tick-to-run latency */
+static void high_entry(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for (i = 0; i < ROUNDS; i++) {
+        qar_event_wait(EVT_GO);
+        range_add(&post_cycles, bench_now() - stamp - timer_overhead);
+    }
+
+    /* TIMER0 matched CMP0 at (CMP0 - TICK_CYCLES); auto-reload has
+     * already advanced CMP0 by the time this task runs. */
+    for (i = 0; i < ROUNDS; i++) {
+        qar_task_sleep(1);
+        uint32_t now = bench_now();
+        range_add(&tick_cycles, now - (QAR_TIMER_CMP0(TIMER_BASE) - TICK_CYCLES) - timer_overhead);
+    }
+
+    bench_report(BENCH_SWITCH_MIN, switch_cycles.min);
+    bench_report(BENCH_SWITCH_MAX, switch_cycles.max);
+    bench_report(BENCH_POST_MIN, post_cycles.min);
+    bench_report(BENCH_POST_MAX, post_cycles.max);
+    bench_report(BENCH_TICK_MIN, tick_cycles.min);
+    bench_report(BENCH_TICK_MAX, tick_cycles.max);
+    BENCH_MAILBOX = BENCH_DONE;
+
+    while (1)
+        qar_event_wait(0x80000000u);
+}
+
+/* Priority 3: yield round trips against peer_entry (two switches each),
+ * then wakes the high task. */
+static void ping_entry(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for (i = 0; i < ROUNDS; i++) {
+        uint32_t start = bench_now();
+        qar_task_yield();
+        uint32_t cycles = bench_now() - start - timer_overhead;
+        range_add(&switch_cycles, cycles / 2u);
+    }
+
+    for (i = 0; i < ROUNDS; i++) {
+        stamp = bench_now();
+        qar_event_post(&high_task, EVT_GO);
+    }
+}
+
+/* Priority 3 background load: keeps yielding, so the tick lands on a
+ * busy task rather than on WFI. */
+static void peer_entry(void *arg)
+{
+    (void)arg;
+    while (1)
+        qar_task_yield();
+}
+
+int main(void)
+{
+    qar_timer_init(TIMER_BASE, 0, 0);
+
+    uint32_t t0 = bench_now();
+    uint32_t t1 = bench_now();
+    timer_overhead = t1 - t0;
+
+    qar_task_create(&high_task, high_entry, 0, high_stack, 128, PRIO_HIGH);
+    qar_task_create(&ping_task, ping_entry, 0, ping_stack, 128, PRIO_LOW);
+    qar_task_create(&peer_task, peer_entry, 0, peer_stack, 128, PRIO_LOW);
+    qar_sched_start(TICK_CYCLES);
+}
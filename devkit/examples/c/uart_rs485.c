@@ -1,5 +1,6 @@
 #include <stdint.h>
 
+#include "hal/crc.h"
 #include "hal/uart.h"
 
 #define UART_BASE QAR_UART0_BASE
@@ -9,6 +10,25 @@ static void send_byte(uint8_t b)
     qar_uart_write(UART_BASE, b);
 }
 
+/* Modbus RTU "read holding register 0" request; one byte per word because
+ * the core has no byte loads. The CRC unit folds each byte as it is sent. */
+static const uint32_t modbus_request[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x01 };
+
+static void send_modbus_request(void)
+{
+    uint32_t i;
+    uint32_t crc;
+
+    qar_crc_setup_modbus(QAR_CRC0_BASE);
+    for (i = 0; i < sizeof(modbus_request) / sizeof(modbus_request[0]); ++i) {
+        qar_crc_feed_byte(QAR_CRC0_BASE, modbus_request[i]);
+        send_byte((uint8_t)modbus_request[i]);
+    }
+    crc = qar_crc_result(QAR_CRC0_BASE);
+    send_byte((uint8_t)(crc & 0xFFu));        /* CRC low byte first */
+    send_byte((uint8_t)(crc >> 8));
+}
+
 int main(void)
 {
     /* Configure UART0: enable, idle detection disabled, auto RS-485 direction */
@@ -19,9 +39,8 @@ int main(void)
     qar_uart_enable_irq(UART_BASE, QAR_UART_IRQ_IDLE);
     qar_uart_set_idle_cycles(UART_BASE, 1000);
 
-    /* Transmit two bytes */
-    send_byte(0x33);
-    send_byte(0x55);
+    /* Transmit a Modbus request (CRC 0x0A84, sent as 84 0A) */
+    send_modbus_request();
 
     /* Wait for idle interrupt */
     while ((qar_uart_status(UART_BASE) & QAR_UART_STATUS_IDLE) == 0)
@@ -1,27 +1,57 @@
 #include <stdint.h>
 
+#include "hal/cpu.h"
 #include "hal/uart.h"
+#include "sdk/ringbuf.h"
+#include "sdk/wcet.h"
 
 #define UART_BASE QAR_UART0_BASE
 
 volatile uint32_t idle_count = 0;
+uint32_t idle_frames = 0;
+
+static uint32_t rx_storage[16];
+static qar_ringbuf_t rx_queue;
 
 void uart_isr(void)
 {
     uint32_t status = qar_uart_status(UART_BASE);
+    /* A byte takes far longer to arrive than the drain loop, so the FIFO
+     * depth bounds it for `qarsim wcet`. */
+    while (qar_uart_available(UART_BASE)) {
+        QAR_LOOP_BOUND(QAR_UART_FIFO_DEPTH);
+        qar_ringbuf_push(&rx_queue, (uint32_t)qar_uart_read(UART_BASE));
+    }
     if (status & QAR_UART_STATUS_IDLE) {
-        idle_count++;
+        qar_atomic_fetch_add(&idle_count, 1u);
         qar_uart_clear_irq(UART_BASE, QAR_UART_IRQ_IDLE);
     }
+    qar_uart_clear_irq(UART_BASE, QAR_UART_IRQ_RX_READY);
 }
 
 int main(void)
 {
+    uint32_t byte;
+
+    qar_ringbuf_init(&rx_queue, rx_storage, 16);
     qar_uart_init(UART_BASE, 500, QAR_UART_CTRL_ENABLE);
     qar_uart_set_idle_cycles(UART_BASE, 1000);
-    qar_uart_enable_irq(UART_BASE, QAR_UART_IRQ_IDLE);
-    send_byte(UART_BASE, 0x33);
-    send_byte(UART_BASE, 0x55);
-    while (1) {}
+    qar_uart_enable_irq(UART_BASE, QAR_UART_IRQ_IDLE | QAR_UART_IRQ_RX_READY);
+    qar_uart_write(UART_BASE, 0x33);
+    qar_uart_write(UART_BASE, 0x55);
+    while (1) {
+        /* No interrupt masking: the queue is SPSC and the counter is
+         * consumed with a single atomic swap. */
+        while (qar_ringbuf_pop(&rx_queue, &byte))
+            (void)byte;
+        idle_frames += qar_atomic_swap(&idle_count, 0u);
+        /* WFI wakes on a pending enabled interrupt even with MIE clear,
+         * so checking the queue with interrupts masked cannot miss a byte
+         * the ISR queues between the check and the WFI. */
+        uint32_t irq = qar_irq_save();
+        if (qar_ringbuf_count(&rx_queue) == 0)
+            qar_wait_for_interrupt();
+        qar_irq_restore(irq);
+    }
     return 0;
 }
@@ -0,0 +1,55 @@
+#include <stdint.h>
+
+#include "hal/cpp/gpio.hpp"
+#include "hal/cpp/timer.hpp"
+
+/* C++ counterpart of examples/c/timer_pwm_demo.c on the templated HAL.
+ * Every register address below is a compile-time constant, so each access
+ * is a single LW/SW off a LUI-built base with no channel tests. */
+
+using timer = qar::timer0;
+using led   = qar::gpio0::pin<2>;
+using pwm_a = timer::pwm<0>;
+using pwm_b = timer::pwm<1>;
+using edges = timer::icap<0>;
+
+static constexpr uint32_t period = 1024;
+
+/* Rising edges of pin 0 (PWM0 output), FIFO watermark at 4 timestamps */
+static_assert(edges::encode(0, QAR_TIMER_ICAP_EDGE_RISING, 4).value ==
+                  (QAR_TIMER_ICAP_ENABLE | QAR_TIMER_ICAP_EDGE_RISING | QAR_TIMER_ICAP_PIN(0) |
+                   QAR_TIMER_ICAP_WATERMARK(4) | QAR_TIMER_ICAP_FLUSH),
+              "icap encoder must match the C HAL macros");
+
+static uint32_t stamps[QAR_TIMER_ICAP_DEPTH];
+volatile uint32_t last_period;
+
+int main()
+{
+    /* Route PWM outputs to GPIO pins 0 and 1; pin 2 is a status LED */
+    qar::write(qar::gpio0::alt_pwm::all(0x3u), qar::gpio0::dir::all(led::mask));
+
+    pwm_a::config(period, 256);
+    pwm_b::config(period, 768);
+    edges::config(0, QAR_TIMER_ICAP_EDGE_RISING, 4);
+
+    /* One store of a constant: ENABLE | CMP0_AUTO | CMP1_AUTO */
+    timer::ctrl::write(timer::ctrl_enable::encode(1) | timer::ctrl_cmp0_auto::encode(1) |
+                       timer::ctrl_cmp1_auto::encode(1));
+
+    while (1) {
+        /* simple ramp on duty cycle, mirrored on the second channel */
+        for (uint32_t duty = 0; duty < period; duty += 64) {
+            pwm_a::set_duty(duty);
+            pwm_b::set_duty(period - 1 - duty);
+
+            uint32_t n = edges::read(stamps, QAR_TIMER_ICAP_DEPTH);
+            if (n >= 2) {
+                last_period = stamps[n - 1] - stamps[n - 2];
+                led::write(last_period == period);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -15,6 +15,13 @@
 #define QAR_ADC_IRQ_STATUS(base)  QAR_ADC_REG((base), 0x10)
 #define QAR_ADC_SEQ_MASK(base)    QAR_ADC_REG((base), 0x14)
 #define QAR_ADC_SAMPLE_DIV(base)  QAR_ADC_REG((base), 0x18)
+#define QAR_ADC_FIFO_DATA(base)   QAR_ADC_REG((base), 0x1C)
+#define QAR_ADC_FIFO_CTRL(base)   QAR_ADC_REG((base), 0x20)
+#define QAR_ADC_FIFO_STATUS(base) QAR_ADC_REG((base), 0x24)
+#define QAR_ADC_OVERSAMPLE(base)  QAR_ADC_REG((base), 0x28)
+#define QAR_ADC_WIN_EN(base)      QAR_ADC_REG((base), 0x2C)
+#define QAR_ADC_WIN_STATUS(base)  QAR_ADC_REG((base), 0x30)
+#define QAR_ADC_WIN(base, ch)     QAR_ADC_REG((base), 0x34 + ((ch) << 2))
 
 #define QAR_ADC_CTRL_ENABLE       (1u << 0)
 #define QAR_ADC_CTRL_CONTINUOUS   (1u << 1)
@@ -28,6 +35,26 @@
 
 #define QAR_ADC_IRQ_DATA_READY    (1u << 0)
 #define QAR_ADC_IRQ_OVERRUN       (1u << 1)
+#define QAR_ADC_IRQ_FIFO_WATERMARK (1u << 2)
+#define QAR_ADC_IRQ_FIFO_OVERFLOW (1u << 3)
+#define QAR_ADC_IRQ_WINDOW        (1u << 4)
+
+#define QAR_ADC_FIFO_CTRL_ENABLE  (1u << 0)
+#define QAR_ADC_FIFO_CTRL_FLUSH   (1u << 1)
+#define QAR_ADC_FIFO_CTRL_WATERMARK_SHIFT 8
+
+#define QAR_ADC_FIFO_STATUS_LEVEL(val) ((val) & 0xFFu)
+#define QAR_ADC_FIFO_STATUS_EMPTY     (1u << 8)
+#define QAR_ADC_FIFO_STATUS_WATERMARK (1u << 9)
+#define QAR_ADC_FIFO_STATUS_OVERFLOW  (1u << 10)
+
+#define QAR_ADC_FIFO_DATA_VALID   (1u << 31)
+
+#define QAR_ADC_WIN_BELOW_HIT(ch) (1u << (ch))
+#define QAR_ADC_WIN_ABOVE_HIT(ch) (1u << ((ch) + 4))
+#define QAR_ADC_WIN_BELOW_NOW(ch) (1u << ((ch) + 8))
+#define QAR_ADC_WIN_ABOVE_NOW(ch) (1u << ((ch) + 12))
+#define QAR_ADC_WIN_HIT_ALL       0xFFu
 
 #define QAR_ADC_RESULT_VALUE(val)   ((val) & 0xFFFu)
 #define QAR_ADC_RESULT_CHANNEL(val) (((val) >> 16) & 0xF)
@@ -77,4 +104,56 @@ static inline void qar_adc_clear_irq(uint32_t base, uint32_t mask)
     QAR_ADC_IRQ_STATUS(base) = mask;
 }
 
+static inline void qar_adc_fifo_config(uint32_t base, uint32_t watermark)
+{
+    QAR_ADC_FIFO_CTRL(base) = QAR_ADC_FIFO_CTRL_ENABLE | QAR_ADC_FIFO_CTRL_FLUSH |
+        ((watermark & 0x1Fu) << QAR_ADC_FIFO_CTRL_WATERMARK_SHIFT);
+}
+
+static inline uint32_t qar_adc_fifo_level(uint32_t base)
+{
+    return QAR_ADC_FIFO_STATUS_LEVEL(QAR_ADC_FIFO_STATUS(base));
+}
+
+/* Pop up to max entries (RESULT layout) from the sample FIFO; returns the count. */
+static inline uint32_t qar_adc_fifo_read(uint32_t base, uint32_t *buf, uint32_t max)
+{
+    uint32_t count = 0;
+
+    while (count < max) {
+        uint32_t entry = QAR_ADC_FIFO_DATA(base);
+        if (!(entry & QAR_ADC_FIFO_DATA_VALID))
+            break;
+        buf[count++] = entry & ~QAR_ADC_FIFO_DATA_VALID;
+    }
+    return count;
+}
+
+/* Average 2^log2_ratio conversions per result (0 = off, max 7). */
+static inline void qar_adc_set_oversampling(uint32_t base, uint32_t log2_ratio)
+{
+    QAR_ADC_OVERSAMPLE(base) = log2_ratio & 0x7u;
+}
+
+static inline void qar_adc_set_window(uint32_t base, uint32_t channel, uint16_t low, uint16_t high)
+{
+    QAR_ADC_WIN(base, channel & 0x3u) = ((uint32_t)(high & 0xFFFu) << 16) | (low & 0xFFFu);
+}
+
+static inline void qar_adc_window_enable(uint32_t base, uint32_t mask)
+{
+    QAR_ADC_WIN_EN(base) = mask & 0xFu;
+}
+
+static inline uint32_t qar_adc_window_status(uint32_t base)
+{
+    return QAR_ADC_WIN_STATUS(base);
+}
+
+static inline void qar_adc_window_clear(uint32_t base, uint32_t hits)
+{
+    QAR_ADC_WIN_STATUS(base) = hits;
+    QAR_ADC_IRQ_STATUS(base) = QAR_ADC_IRQ_WINDOW;
+}
+
 #endif /* QAR_HAL_ADC_H */
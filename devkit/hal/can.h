@@ -5,6 +5,7 @@
 #include "mmio.h"
 
 #define QAR_CAN0_BASE 0x40003000u
+#define QAR_CAN1_BASE 0x40003100u
 
 #define QAR_CAN_REG(base, offset) QAR_MMIO32((base), (offset))
 
@@ -0,0 +1,73 @@
+#ifndef QAR_HAL_CPP_GPIO_HPP
+#define QAR_HAL_CPP_GPIO_HPP
+
+#include "mmio.hpp"
+#include "../gpio.h"
+
+namespace qar {
+
+/* GPIO block at Base; the C equivalents live in hal/gpio.h. */
+template <uint32_t Base>
+struct gpio {
+    using dir        = reg<Base + 0x00>;
+    using out        = reg<Base + 0x04>;
+    using in         = reg<Base + 0x08>;
+    using out_set    = reg<Base + 0x0C>;
+    using out_clr    = reg<Base + 0x10>;
+    using irq_en     = reg<Base + 0x14>;
+    using irq_status = reg<Base + 0x18>;
+    using alt_pwm    = reg<Base + 0x1C>;
+    using irq_rise   = reg<Base + 0x20>;
+    using irq_fall   = reg<Base + 0x24>;
+    using db_en      = reg<Base + 0x28>;
+    using db_cycles  = reg<Base + 0x2C>;
+
+    /* Single pin N. OUT_SET/OUT_CLR make set/clear one store each, with
+     * no read-modify-write of OUT. */
+    template <unsigned N>
+    struct pin {
+        static_assert(N < 32, "qar: GPIO pin out of range");
+        static constexpr uint32_t mask = 1u << N;
+
+        static void set()
+        {
+            out_set::write(mask);
+        }
+
+        static void clear()
+        {
+            out_clr::write(mask);
+        }
+
+        static void write(bool level)
+        {
+            if (level)
+                set();
+            else
+                clear();
+        }
+
+        static bool read()
+        {
+            return (in::read() & mask) != 0;
+        }
+
+        static void clear_irq()
+        {
+            irq_status::write(mask);
+        }
+    };
+
+    static void config_irq(uint32_t enable_mask, uint32_t rise_mask, uint32_t fall_mask)
+    {
+        irq_en::write(enable_mask);
+        irq_rise::write(rise_mask);
+        irq_fall::write(fall_mask);
+    }
+};
+
+using gpio0 = gpio<QAR_GPIO0_BASE>;
+
+} /* namespace qar */
+
+#endif /* QAR_HAL_CPP_GPIO_HPP */
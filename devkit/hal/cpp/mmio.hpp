@@ -0,0 +1,169 @@
+#ifndef QAR_HAL_CPP_MMIO_HPP
+#define QAR_HAL_CPP_MMIO_HPP
+
+/*
+ * Compile-time register access for C++17 firmware.
+ *
+ * Every register is a distinct type, reg<Addr>, so the address folds into
+ * the LUI/SW pair at the call site and there is no base pointer to pass
+ * around. Fields are described by field<Reg, Shift, Width>; encoding a
+ * value yields a field_value whose mask is part of its type, so
+ *
+ *     timer0::ctrl::write(timer0::ctrl_enable::encode(1) |
+ *                         timer0::ctrl_cmp0_auto::encode(1));
+ *
+ * is one store of a constant, combining fields of different registers is
+ * a compile error, and modify() only reads the register back when the
+ * fields do not cover all 32 bits.
+ */
+
+#include <stdint.h>
+
+#include "../mmio.h"
+
+namespace qar {
+
+template <uint32_t Addr>
+struct reg;
+
+template <typename Reg, uint32_t Mask>
+struct field_value {
+    using reg_type = Reg;
+    static constexpr uint32_t mask = Mask;
+    uint32_t value;
+};
+
+/* Fields of one register merge into a single value; overlapping fields
+ * would silently drop bits, so they are rejected. */
+template <typename Reg, uint32_t MaskA, uint32_t MaskB>
+constexpr field_value<Reg, MaskA | MaskB> operator|(field_value<Reg, MaskA> a, field_value<Reg, MaskB> b)
+{
+    static_assert((MaskA & MaskB) == 0, "qar: overlapping fields in one register write");
+    return {a.value | b.value};
+}
+
+template <uint32_t Addr>
+struct reg {
+    static_assert((Addr & 3u) == 0, "qar: registers are word aligned");
+
+    static constexpr uint32_t address = Addr;
+
+    /* Whole-register value, for batching with qar::write() */
+    static constexpr field_value<reg, 0xFFFFFFFFu> all(uint32_t value)
+    {
+        return {value};
+    }
+
+    static volatile uint32_t &ref()
+    {
+        return QAR_MMIO32(Addr, 0);
+    }
+
+    static uint32_t read()
+    {
+        return ref();
+    }
+
+    static void write(uint32_t value)
+    {
+        ref() = value;
+    }
+
+    /* One store; bits outside the given fields are written as zero. */
+    template <uint32_t Mask>
+    static void write(field_value<reg, Mask> fields)
+    {
+        ref() = fields.value;
+    }
+
+    /* Update only the given fields. Collapses to a plain store when they
+     * cover the whole register. */
+    template <uint32_t Mask>
+    static void modify(field_value<reg, Mask> fields)
+    {
+        if constexpr (Mask == 0xFFFFFFFFu)
+            ref() = fields.value;
+        else
+            ref() = (ref() & ~Mask) | fields.value;
+    }
+
+    /* Read-modify-write of a bit mask; prefer write() for registers whose
+     * full contents are known (IRQ_EN after init, W1C status flags). */
+    static void set_bits(uint32_t mask)
+    {
+        ref() = ref() | mask;
+    }
+
+    static void clear_bits(uint32_t mask)
+    {
+        ref() = ref() & ~mask;
+    }
+};
+
+template <typename Reg, unsigned Shift, unsigned Width = 1>
+struct field {
+    static_assert(Width >= 1 && Shift + Width <= 32, "qar: field outside the register");
+
+    static constexpr uint32_t mask = (Width == 32 ? 0xFFFFFFFFu : ((1u << Width) - 1u)) << Shift;
+
+    using value_type = field_value<Reg, mask>;
+
+    static constexpr value_type encode(uint32_t value)
+    {
+        return {(value << Shift) & mask};
+    }
+
+    static constexpr uint32_t decode(uint32_t raw)
+    {
+        return (raw & mask) >> Shift;
+    }
+
+    static uint32_t read()
+    {
+        return decode(Reg::read());
+    }
+};
+
+namespace detail {
+
+template <typename A, typename B>
+struct same_type {
+    static constexpr bool value = false;
+};
+
+template <typename A>
+struct same_type<A, A> {
+    static constexpr bool value = true;
+};
+
+template <typename T, typename... Rest>
+constexpr bool unique_regs()
+{
+    if constexpr (sizeof...(Rest) == 0)
+        return true;
+    else
+        return (!same_type<typename T::reg_type, typename Rest::reg_type>::value && ...) && unique_regs<Rest...>();
+}
+
+} /* namespace detail */
+
+/*
+ * Batched write: one store per register, in argument order. A register may
+ * appear only once, so merging its fields with '|' is enforced rather than
+ * left to the optimiser (volatile stores are never combined).
+ */
+template <typename... Values>
+inline void write(Values... values)
+{
+    static_assert(detail::unique_regs<Values...>(), "qar: merge fields of one register with '|'");
+    (Values::reg_type::write(values), ...);
+}
+
+inline void fence()
+{
+    qar_mmio_fence();
+}
+
+} /* namespace qar */
+
+#endif /* QAR_HAL_CPP_MMIO_HPP */
@@ -0,0 +1,154 @@
+#ifndef QAR_HAL_CPP_TIMER_HPP
+#define QAR_HAL_CPP_TIMER_HPP
+
+#include "mmio.hpp"
+#include "../timer.h"
+
+namespace qar {
+
+/* TIMER block at Base; the C equivalents live in hal/timer.h. */
+template <uint32_t Base>
+struct timer {
+    using ctrl          = reg<Base + 0x00>;
+    using prescale      = reg<Base + 0x04>;
+    using counter       = reg<Base + 0x08>;
+    using status        = reg<Base + 0x0C>;
+    using irq_en        = reg<Base + 0x10>;
+    using wdt_load      = reg<Base + 0x24>;
+    using wdt_ctrl      = reg<Base + 0x28>;
+    using pwm_status    = reg<Base + 0x40>;
+    using capture_ctrl  = reg<Base + 0x44>;
+    using icap_status   = reg<Base + 0x60>;
+
+    using ctrl_enable    = field<ctrl, 0>;
+    using ctrl_cmp0_auto = field<ctrl, 1>;
+    using ctrl_cmp1_auto = field<ctrl, 2>;
+    using ctrl_pwm_sync  = field<ctrl, 3>;
+
+    /* Compare channel Ch (0 or 1): CMPn and CMPn_PERIOD */
+    template <unsigned Ch>
+    struct compare {
+        static_assert(Ch < 2, "qar: TIMER has compare channels 0 and 1");
+        using value  = reg<Base + 0x14 + Ch * 8>;
+        using period = reg<Base + 0x18 + Ch * 8>;
+        static constexpr uint32_t status_bit = QAR_TIMER_STATUS_CMP0 << Ch;
+
+        static void set(uint32_t first, uint32_t reload)
+        {
+            value::write(first);
+            period::write(reload);
+        }
+    };
+
+    /* PWM channel Ch (0 or 1); no runtime channel test as in
+     * qar_timer_config_pwm(). */
+    template <unsigned Ch>
+    struct pwm {
+        static_assert(Ch < 2, "qar: TIMER has PWM channels 0 and 1");
+        using period = reg<Base + 0x30 + Ch * 8>;
+        using duty   = reg<Base + 0x34 + Ch * 8>;
+
+        static void config(uint32_t period_cycles, uint32_t duty_cycles)
+        {
+            period::write(period_cycles);
+            duty::write(duty_cycles);
+        }
+
+        static void set_duty(uint32_t duty_cycles)
+        {
+            duty::write(duty_cycles);
+        }
+
+        static bool output()
+        {
+            return (pwm_status::read() >> Ch) & 1u;
+        }
+    };
+
+    /* Manual capture channel Ch */
+    template <unsigned Ch>
+    struct capture {
+        static_assert(Ch < 2, "qar: TIMER has capture channels 0 and 1");
+        using value = reg<Base + 0x48 + Ch * 4>;
+
+        static uint32_t take()
+        {
+            capture_ctrl::write(1u << Ch);
+            return value::read();
+        }
+    };
+
+    /* Input-capture FIFO channel Ch */
+    template <unsigned Ch>
+    struct icap {
+        static_assert(Ch < 2, "qar: TIMER has input-capture channels 0 and 1");
+        using cfg  = reg<Base + 0x50 + Ch * 4>;
+        using data = reg<Base + 0x58 + Ch * 4>;
+
+        using enable    = field<cfg, 0>;
+        using edges     = field<cfg, 1, 2>;
+        using pin       = field<cfg, 4, 5>;
+        using watermark = field<cfg, 12, 4>;
+        using flush     = field<cfg, 16>;
+
+        /* Same encoding as qar_timer_icap_config(); a constant when the
+         * arguments are. */
+        static constexpr auto encode(uint32_t gpio_pin, uint32_t edge_mask, uint32_t level)
+        {
+            return enable::encode(1) | edges::encode(edge_mask >> 1) | pin::encode(gpio_pin) |
+                   watermark::encode(level) | flush::encode(1);
+        }
+
+        static void config(uint32_t gpio_pin, uint32_t edge_mask, uint32_t level)
+        {
+            cfg::write(encode(gpio_pin, edge_mask, level));
+        }
+
+        static void disable()
+        {
+            cfg::write(flush::encode(1));
+        }
+
+        static uint32_t level()
+        {
+            return QAR_TIMER_ICAP_LEVEL(icap_status::read(), Ch);
+        }
+
+        static uint32_t read(uint32_t *buf, uint32_t max)
+        {
+            uint32_t count = level();
+            if (count > max)
+                count = max;
+            for (uint32_t i = 0; i < count; ++i)
+                buf[i] = data::read();
+            return count;
+        }
+    };
+
+    static void start(uint32_t prescale_value, uint32_t ctrl_flags)
+    {
+        prescale::write(prescale_value);
+        ctrl::write(ctrl_flags | QAR_TIMER_CTRL_ENABLE);
+    }
+
+    static uint32_t now()
+    {
+        return counter::read();
+    }
+
+    static void clear_status(uint32_t mask)
+    {
+        status::write(mask);
+    }
+
+    static void kick_wdt()
+    {
+        wdt_ctrl::write(0x3u);
+    }
+};
+
+using timer0 = timer<QAR_TIMER0_BASE>;
+
+} /* namespace qar */
+
+#endif /* QAR_HAL_CPP_TIMER_HPP */
@@ -0,0 +1,74 @@
+#ifndef QAR_HAL_CPP_UART_HPP
+#define QAR_HAL_CPP_UART_HPP
+
+#include "mmio.hpp"
+#include "../uart.h"
+
+namespace qar {
+
+/* UART block at Base; the C equivalents live in hal/uart.h. */
+template <uint32_t Base>
+struct uart {
+    using data       = reg<Base + 0x00>;
+    using status     = reg<Base + 0x04>;
+    using ctrl       = reg<Base + 0x08>;
+    using baud       = reg<Base + 0x0C>;
+    using irq_en     = reg<Base + 0x10>;
+    using irq_status = reg<Base + 0x14>;
+    using rs485      = reg<Base + 0x18>;
+    using idle_cfg   = reg<Base + 0x1C>;
+    using lin_ctrl   = reg<Base + 0x20>;
+
+    using ctrl_enable     = field<ctrl, 0>;
+    using ctrl_parity_en  = field<ctrl, 1>;
+    using ctrl_parity_odd = field<ctrl, 2>;
+    using ctrl_two_stop   = field<ctrl, 3>;
+    using ctrl_lin_mode   = field<ctrl, 5>;
+
+    /* Same sequence as qar_uart_init(), with IRQ_EN written once to its
+     * final value instead of being cleared and then read-modify-written. */
+    static void init(uint32_t baud_divider, uint32_t ctrl_flags, uint32_t irq_mask = 0)
+    {
+        baud::write(baud_divider);
+        ctrl::write(ctrl_flags | QAR_UART_CTRL_ENABLE);
+        irq_en::write(irq_mask);
+        idle_cfg::write(0);
+        lin_ctrl::write(13);
+    }
+
+    static bool available()
+    {
+        return (status::read() & QAR_UART_STATUS_RX_READY) != 0;
+    }
+
+    static bool can_write()
+    {
+        return (status::read() & QAR_UART_STATUS_TX_SPACE) != 0;
+    }
+
+    static void write(uint8_t byte)
+    {
+        while (!can_write())
+            ;
+        data::write(byte);
+    }
+
+    static int read()
+    {
+        if (!available())
+            return -1;
+        return (int)(data::read() & 0xFFu);
+    }
+
+    static void clear_irq(uint32_t mask)
+    {
+        irq_status::write(mask);
+    }
+};
+
+using uart0 = uart<QAR_UART0_BASE>;
+using uart1 = uart<QAR_UART1_BASE>;
+
+} /* namespace qar */
+
+#endif /* QAR_HAL_CPP_UART_HPP */
@@ -0,0 +1,161 @@
+#ifndef QAR_HAL_CPU_H
+#define QAR_HAL_CPU_H
+
+#include <stdint.h>
+
+#define QAR_MSTATUS_MIE (1u << 3)
+#define QAR_MIE_MTIE    (1u << 7)
+#define QAR_MIE_MEIE    (1u << 11)
+
+/* Compiler-only barrier. The core retires loads and stores in program
+ * order, so this is all single-hart ISR/main-loop sharing needs. */
+static inline void qar_compiler_barrier(void)
+{
+    __asm__ volatile ("" ::: "memory");
+}
+
+/* Clear mstatus.MIE and return its previous state for qar_irq_restore().
+ * Register CSR forms only: the core does not decode CSRRxI. */
+static inline uint32_t qar_irq_save(void)
+{
+    uint32_t prev;
+    __asm__ volatile ("csrrc %0, mstatus, %1" : "=r"(prev) : "r"(QAR_MSTATUS_MIE) : "memory");
+    return prev & QAR_MSTATUS_MIE;
+}
+
+static inline void qar_irq_restore(uint32_t state)
+{
+    if (state)
+        __asm__ volatile ("csrrs x0, mstatus, %0" :: "r"(QAR_MSTATUS_MIE) : "memory");
+}
+
+/* Enable interrupt sources in mie (QAR_MIE_*); also selects WFI wake-ups. */
+static inline void qar_irq_enable_sources(uint32_t mask)
+{
+    __asm__ volatile ("csrrs x0, mie, %0" :: "r"(mask) : "memory");
+}
+
+/* Custom CSR counting cycles spent asleep in WFI (read/write). */
+#define QAR_CSR_IDLE_CYCLES 0xBC2
+
+/* Halt fetch until an interrupt enabled in mie is pending. With
+ * mstatus.MIE set the handler runs first and execution resumes after the
+ * WFI; with MIE clear the core simply wakes and continues. */
+static inline void qar_wait_for_interrupt(void)
+{
+    __asm__ volatile ("wfi" ::: "memory");
+}
+
+static inline uint32_t qar_idle_cycles(void)
+{
+    uint32_t cycles;
+    __asm__ volatile ("csrr %0, 0xbc2" : "=r"(cycles));
+    return cycles;
+}
+
+static inline void qar_idle_cycles_reset(void)
+{
+    __asm__ volatile ("csrw 0xbc2, x0");
+}
+
+/* Atomic read-modify-write on DMEM words. Built with -march=rv32ia these
+ * are single AMO instructions (interrupts are held off by hardware only for
+ * the instruction itself); rv32i builds fall back to a short MIE-masked
+ * section. Atomics on peripheral addresses trap with an access fault. */
+#if defined(__riscv_atomic)
+
+#define QAR_CPU_AMO(insn, ptr, val) ({                                        \
+    uint32_t qar_old_;                                                        \
+    __asm__ volatile (insn " %0, %2, (%1)"                                    \
+                      : "=r"(qar_old_) : "r"(ptr), "r"(val) : "memory");      \
+    qar_old_; })
+
+static inline uint32_t qar_atomic_fetch_add(volatile uint32_t *ptr, uint32_t val)
+{
+    return QAR_CPU_AMO("amoadd.w", ptr, val);
+}
+
+static inline uint32_t qar_atomic_fetch_or(volatile uint32_t *ptr, uint32_t val)
+{
+    return QAR_CPU_AMO("amoor.w", ptr, val);
+}
+
+static inline uint32_t qar_atomic_fetch_and(volatile uint32_t *ptr, uint32_t val)
+{
+    return QAR_CPU_AMO("amoand.w", ptr, val);
+}
+
+static inline uint32_t qar_atomic_swap(volatile uint32_t *ptr, uint32_t val)
+{
+    return QAR_CPU_AMO("amoswap.w", ptr, val);
+}
+
+/* Returns 1 and stores desired if *ptr == expected. The SC fails (and the
+ * loop retries) if an interrupt was taken between the LR and the SC. */
+static inline int qar_atomic_cas(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+    uint32_t seen;
+    uint32_t fail;
+    __asm__ volatile (
+        "1: lr.w %0, (%2)\n"
+        "   bne  %0, %3, 2f\n"
+        "   sc.w %1, %4, (%2)\n"
+        "   bne  %1, x0, 1b\n"
+        "2:\n"
+        : "=&r"(seen), "=&r"(fail)
+        : "r"(ptr), "r"(expected), "r"(desired)
+        : "memory");
+    return seen == expected;
+}
+
+#else
+
+static inline uint32_t qar_atomic_fetch_add(volatile uint32_t *ptr, uint32_t val)
+{
+    uint32_t irq = qar_irq_save();
+    uint32_t old = *ptr;
+    *ptr = old + val;
+    qar_irq_restore(irq);
+    return old;
+}
+
+static inline uint32_t qar_atomic_fetch_or(volatile uint32_t *ptr, uint32_t val)
+{
+    uint32_t irq = qar_irq_save();
+    uint32_t old = *ptr;
+    *ptr = old | val;
+    qar_irq_restore(irq);
+    return old;
+}
+
+static inline uint32_t qar_atomic_fetch_and(volatile uint32_t *ptr, uint32_t val)
+{
+    uint32_t irq = qar_irq_save();
+    uint32_t old = *ptr;
+    *ptr = old & val;
+    qar_irq_restore(irq);
+    return old;
+}
+
+static inline uint32_t qar_atomic_swap(volatile uint32_t *ptr, uint32_t val)
+{
+    uint32_t irq = qar_irq_save();
+    uint32_t old = *ptr;
+    *ptr = val;
+    qar_irq_restore(irq);
+    return old;
+}
+
+static inline int qar_atomic_cas(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+    uint32_t irq = qar_irq_save();
+    int hit = (*ptr == expected);
+    if (hit)
+        *ptr = desired;
+    qar_irq_restore(irq);
+    return hit;
+}
+
+#endif /* __riscv_atomic */
+
+#endif /* QAR_HAL_CPU_H */
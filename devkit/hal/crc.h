@@ -0,0 +1,101 @@
+#ifndef QAR_HAL_CRC_H
+#define QAR_HAL_CRC_H
+
+#include <stdint.h>
+#include "mmio.h"
+
+#define QAR_CRC0_BASE 0x40009000u
+
+#define QAR_CRC_REG(base, offset) QAR_MMIO32((base), (offset))
+
+#define QAR_CRC_CTRL(base)    QAR_CRC_REG((base), 0x00)
+#define QAR_CRC_POLY(base)    QAR_CRC_REG((base), 0x04)
+#define QAR_CRC_INIT(base)    QAR_CRC_REG((base), 0x08)
+#define QAR_CRC_XOROUT(base)  QAR_CRC_REG((base), 0x0C)
+#define QAR_CRC_DATA8(base)   QAR_CRC_REG((base), 0x10)
+#define QAR_CRC_DATA16(base)  QAR_CRC_REG((base), 0x14)
+#define QAR_CRC_DATA32(base)  QAR_CRC_REG((base), 0x18)
+#define QAR_CRC_STATE(base)   QAR_CRC_REG((base), 0x1C)
+#define QAR_CRC_RESULT(base)  QAR_CRC_REG((base), 0x20)
+
+#define QAR_CRC_CTRL_WIDTH8   (0u << 0)
+#define QAR_CRC_CTRL_WIDTH16  (1u << 0)
+#define QAR_CRC_CTRL_WIDTH32  (2u << 0)
+#define QAR_CRC_CTRL_REFIN    (1u << 2)
+#define QAR_CRC_CTRL_REFOUT   (1u << 3)
+#define QAR_CRC_CTRL_RESET    (1u << 4)
+
+#define QAR_CRC_CTRL_REFLECT  (QAR_CRC_CTRL_REFIN | QAR_CRC_CTRL_REFOUT)
+
+/* Program a CRC model and restart it from init. ctrl = WIDTHn | REFIN/REFOUT. */
+static inline void qar_crc_config(uint32_t base, uint32_t ctrl, uint32_t poly,
+                                  uint32_t init, uint32_t xorout)
+{
+    QAR_CRC_POLY(base) = poly;
+    QAR_CRC_INIT(base) = init;
+    QAR_CRC_XOROUT(base) = xorout;
+    QAR_CRC_CTRL(base) = (ctrl & 0xFu) | QAR_CRC_CTRL_RESET;
+}
+
+/* CRC-32 (IEEE 802.3, zlib): check("123456789") = 0xCBF43926 */
+static inline void qar_crc_setup_crc32(uint32_t base)
+{
+    qar_crc_config(base, QAR_CRC_CTRL_WIDTH32 | QAR_CRC_CTRL_REFLECT,
+                   0x04C11DB7u, 0xFFFFFFFFu, 0xFFFFFFFFu);
+}
+
+/* CRC-16/MODBUS: check = 0x4B37; the result goes on the wire low byte first */
+static inline void qar_crc_setup_modbus(uint32_t base)
+{
+    qar_crc_config(base, QAR_CRC_CTRL_WIDTH16 | QAR_CRC_CTRL_REFLECT,
+                   0x8005u, 0xFFFFu, 0x0000u);
+}
+
+/* CRC-16/CCITT-FALSE: check = 0x29B1 */
+static inline void qar_crc_setup_ccitt(uint32_t base)
+{
+    qar_crc_config(base, QAR_CRC_CTRL_WIDTH16, 0x1021u, 0xFFFFu, 0x0000u);
+}
+
+/* CRC-8 (SMBus PEC): check = 0xF4 */
+static inline void qar_crc_setup_crc8(uint32_t base)
+{
+    qar_crc_config(base, QAR_CRC_CTRL_WIDTH8, 0x07u, 0x00u, 0x00u);
+}
+
+static inline void qar_crc_reset(uint32_t base)
+{
+    QAR_CRC_CTRL(base) = QAR_CRC_CTRL(base) | QAR_CRC_CTRL_RESET;
+}
+
+static inline void qar_crc_feed_byte(uint32_t base, uint32_t value)
+{
+    QAR_CRC_DATA8(base) = value & 0xFFu;
+}
+
+/* Two bytes, bits[7:0] first */
+static inline void qar_crc_feed_half(uint32_t base, uint32_t value)
+{
+    QAR_CRC_DATA16(base) = value & 0xFFFFu;
+}
+
+/* Four bytes, bits[7:0] first (memory order of a little-endian word) */
+static inline void qar_crc_feed_word(uint32_t base, uint32_t value)
+{
+    QAR_CRC_DATA32(base) = value;
+}
+
+/* Feed a word-aligned buffer: one store per word, so the core's LW/SW-only
+ * data path never needs byte loads. */
+static inline void qar_crc_feed_words(uint32_t base, const uint32_t *words, uint32_t count)
+{
+    while (count--)
+        QAR_CRC_DATA32(base) = *words++;
+}
+
+static inline uint32_t qar_crc_result(uint32_t base)
+{
+    return QAR_CRC_RESULT(base);
+}
+
+#endif /* QAR_HAL_CRC_H */
@@ -0,0 +1,74 @@
+#ifndef QAR_HAL_EVR_H
+#define QAR_HAL_EVR_H
+
+#include <stdint.h>
+#include "mmio.h"
+
+#define QAR_EVR0_BASE 0x40007000u
+
+#define QAR_EVR_REG(base, offset) QAR_MMIO32((base), (offset))
+
+#define QAR_EVR_CTRL(base)        QAR_EVR_REG((base), 0x00)
+#define QAR_EVR_GPIO_SEL(base)    QAR_EVR_REG((base), 0x04)
+#define QAR_EVR_SW_TRIGGER(base)  QAR_EVR_REG((base), 0x08)
+#define QAR_EVR_SRC_FLAGS(base)   QAR_EVR_REG((base), 0x0C)
+#define QAR_EVR_ACT_FLAGS(base)   QAR_EVR_REG((base), 0x10)
+#define QAR_EVR_ROUTE(base, act)  QAR_EVR_REG((base), 0x20 + ((act) << 2))
+
+#define QAR_EVR_CTRL_ENABLE       (1u << 0)
+
+/* Event sources (ROUTEn values) */
+#define QAR_EVR_SRC_NONE          0u
+#define QAR_EVR_SRC_TIMER0_CMP0   1u
+#define QAR_EVR_SRC_TIMER0_CMP1   2u
+#define QAR_EVR_SRC_GPIO_EDGE     3u
+#define QAR_EVR_SRC_CAN0_RX       4u
+#define QAR_EVR_SRC_UART0_RX      5u
+#define QAR_EVR_SRC_ADC0_DONE     6u
+#define QAR_EVR_SRC_ADC0_WINDOW   7u
+#define QAR_EVR_SRC_SOFTWARE      8u
+
+/* Actions (ROUTE register index) */
+#define QAR_EVR_ACT_ADC0_START        0u
+#define QAR_EVR_ACT_TIMER0_CAPTURE0   1u
+#define QAR_EVR_ACT_TIMER0_CAPTURE1   2u
+#define QAR_EVR_ACT_TIMER0_PWM_UPDATE 3u
+#define QAR_EVR_ACT_UART0_LIN_TICK    4u
+#define QAR_EVR_ACT_GPIO_SEQ_STEP     5u
+#define QAR_EVR_ACT_COUNT             6u
+
+#define QAR_EVR_ACT_ALL           ((1u << QAR_EVR_ACT_COUNT) - 1u)
+#define QAR_EVR_SRC_ALL           0x1FFu
+
+static inline void qar_evr_route(uint32_t base, uint32_t action, uint32_t source)
+{
+    QAR_EVR_ROUTE(base, action) = source & 0xFu;
+}
+
+static inline void qar_evr_select_gpio(uint32_t base, uint32_t pin)
+{
+    QAR_EVR_GPIO_SEL(base) = pin & 0x1Fu;
+}
+
+static inline void qar_evr_enable(uint32_t base, int enable)
+{
+    QAR_EVR_CTRL(base) = enable ? QAR_EVR_CTRL_ENABLE : 0u;
+}
+
+static inline void qar_evr_sw_trigger(uint32_t base)
+{
+    QAR_EVR_SW_TRIGGER(base) = 0x1u;
+}
+
+static inline uint32_t qar_evr_action_flags(uint32_t base)
+{
+    return QAR_EVR_ACT_FLAGS(base);
+}
+
+static inline void qar_evr_clear_flags(uint32_t base)
+{
+    QAR_EVR_SRC_FLAGS(base) = QAR_EVR_SRC_ALL;
+    QAR_EVR_ACT_FLAGS(base) = QAR_EVR_ACT_ALL;
+}
+
+#endif /* QAR_HAL_EVR_H */
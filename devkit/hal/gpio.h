@@ -20,6 +20,24 @@
 #define QAR_GPIO_IRQ_FALL(base)   QAR_GPIO_REG((base), 0x24)
 #define QAR_GPIO_DB_EN(base)      QAR_GPIO_REG((base), 0x28)
 #define QAR_GPIO_DB_CYCLES(base)  QAR_GPIO_REG((base), 0x2C)
+#define QAR_GPIO_SEQ_CTRL(base)   QAR_GPIO_REG((base), 0x30)
+#define QAR_GPIO_SEQ_DIV(base)    QAR_GPIO_REG((base), 0x34)
+#define QAR_GPIO_SEQ_MASK(base)   QAR_GPIO_REG((base), 0x38)
+#define QAR_GPIO_SEQ_LEN(base)    QAR_GPIO_REG((base), 0x3C)
+#define QAR_GPIO_SEQ_PTR(base)    QAR_GPIO_REG((base), 0x40)
+#define QAR_GPIO_SEQ_DATA(base)   QAR_GPIO_REG((base), 0x44)
+#define QAR_GPIO_SEQ_STATUS(base) QAR_GPIO_REG((base), 0x48)
+
+#define QAR_GPIO_SEQ_DEPTH        16u
+
+#define QAR_GPIO_SEQ_ENABLE       (1u << 0)
+#define QAR_GPIO_SEQ_CAPTURE      (1u << 1)
+#define QAR_GPIO_SEQ_LOOP         (1u << 2)
+#define QAR_GPIO_SEQ_EXT_TICK     (1u << 3)
+#define QAR_GPIO_SEQ_IRQ_EN       (1u << 4)
+
+#define QAR_GPIO_SEQ_BUSY         (1u << 0)
+#define QAR_GPIO_SEQ_DONE         (1u << 1)
 
 static inline void qar_gpio_config_dir(uint32_t base, uint32_t dir_mask)
 {
@@ -69,4 +87,54 @@ static inline void qar_gpio_clear_irq(uint32_t base, uint32_t mask)
     QAR_GPIO_IRQ_STATUS(base) = mask;
 }
 
+/* Pattern sequencer. A step lasts `div` core cycles, or one event-router
+ * GPIO_SEQ_STEP pulse when QAR_GPIO_SEQ_EXT_TICK is set in the start flags. */
+static inline void qar_gpio_seq_load(uint32_t base, const uint32_t *patterns, uint32_t count)
+{
+    uint32_t i;
+
+    if (count > QAR_GPIO_SEQ_DEPTH)
+        count = QAR_GPIO_SEQ_DEPTH;
+    QAR_GPIO_SEQ_PTR(base) = 0;
+    for (i = 0; i < count; ++i)
+        QAR_GPIO_SEQ_DATA(base) = patterns[i];
+    QAR_GPIO_SEQ_LEN(base) = count;
+}
+
+/* Play the loaded patterns on the pins in `pin_mask` (other pins keep OUT). */
+static inline void qar_gpio_seq_play(uint32_t base, uint32_t pin_mask, uint32_t div, uint32_t flags)
+{
+    QAR_GPIO_SEQ_MASK(base) = pin_mask;
+    QAR_GPIO_SEQ_DIV(base) = div;
+    QAR_GPIO_SEQ_CTRL(base) = (flags & ~QAR_GPIO_SEQ_CAPTURE) | QAR_GPIO_SEQ_ENABLE;
+}
+
+/* Sample GPIO_IN into the buffer once per step, `count` samples. */
+static inline void qar_gpio_seq_capture(uint32_t base, uint32_t count, uint32_t div, uint32_t flags)
+{
+    QAR_GPIO_SEQ_LEN(base) = count;
+    QAR_GPIO_SEQ_DIV(base) = div;
+    QAR_GPIO_SEQ_CTRL(base) = flags | QAR_GPIO_SEQ_CAPTURE | QAR_GPIO_SEQ_ENABLE;
+}
+
+/* Stopping also hands the pins back to OUT. */
+static inline void qar_gpio_seq_stop(uint32_t base)
+{
+    QAR_GPIO_SEQ_CTRL(base) = 0;
+}
+
+static inline int qar_gpio_seq_done(uint32_t base)
+{
+    return (QAR_GPIO_SEQ_STATUS(base) & QAR_GPIO_SEQ_DONE) != 0;
+}
+
+static inline void qar_gpio_seq_read(uint32_t base, uint32_t *samples, uint32_t count)
+{
+    uint32_t i;
+
+    QAR_GPIO_SEQ_PTR(base) = 0;
+    for (i = 0; i < count; ++i)
+        samples[i] = QAR_GPIO_SEQ_DATA(base);
+}
+
 #endif /* QAR_HAL_GPIO_H */
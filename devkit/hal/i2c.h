@@ -4,7 +4,10 @@
 #include <stdint.h>
 #include "mmio.h"
 
+/* Byte buffers passed to the sequencer helpers hold one byte per 32-bit
+ * word (low 8 bits), because the core only implements LW/SW. */
 #define QAR_I2C0_BASE 0x40004400u
+#define QAR_I2C1_BASE 0x40004500u
 
 #define QAR_I2C_REG(base, offset) QAR_MMIO32((base), (offset))
 
@@ -17,8 +20,12 @@
 #define QAR_I2C_RXDATA(base)   QAR_I2C_REG((base), 0x18)
 #define QAR_I2C_CMD(base)      QAR_I2C_REG((base), 0x1C)
 #define QAR_I2C_FAULT_STATUS(base) QAR_I2C_REG((base), 0x20)
+#define QAR_I2C_SEQ_CMD(base)    QAR_I2C_REG((base), 0x24)
+#define QAR_I2C_SEQ_CTRL(base)   QAR_I2C_REG((base), 0x28)
+#define QAR_I2C_SEQ_STATUS(base) QAR_I2C_REG((base), 0x2C)
 
 #define QAR_I2C_CTRL_ENABLE    (1u << 0)
+#define QAR_I2C_CTRL_LOOPBACK  (1u << 4)
 
 #define QAR_I2C_STATUS_BUSY      (1u << 0)
 #define QAR_I2C_STATUS_RX_RDY    (1u << 1)
@@ -27,18 +34,40 @@
 #define QAR_I2C_STATUS_RX_OVF    (1u << 4)
 #define QAR_I2C_STATUS_TX_OVF    (1u << 5)
 
+#define QAR_I2C_FIFO_DEPTH     8u
+#define QAR_I2C_SEQ_DEPTH      16u
+/* qar_i2c_write_reg(): START, address, register and STOP take 4 entries */
+#define QAR_I2C_WRITE_REG_MAX  (QAR_I2C_SEQ_DEPTH - 4u)
+
 #define QAR_I2C_IRQ_RX_READY   (1u << 0)
 #define QAR_I2C_IRQ_TX_EMPTY   (1u << 1)
 #define QAR_I2C_IRQ_FAULT      (1u << 2)
 #define QAR_I2C_IRQ_TX_OVF     (1u << 3)
 #define QAR_I2C_IRQ_RX_OVF     (1u << 4)
 #define QAR_I2C_IRQ_NACK       (1u << 5)
+#define QAR_I2C_IRQ_SEQ_DONE   (1u << 6)
 
 #define QAR_I2C_CMD_START      (1u << 0)
 #define QAR_I2C_CMD_STOP       (1u << 1)
 #define QAR_I2C_CMD_WRITE      (1u << 2)
 #define QAR_I2C_CMD_READ       (1u << 3)
 
+#define QAR_I2C_SEQ_OP_START   (1u << 8)
+#define QAR_I2C_SEQ_OP_WRITE   (2u << 8)
+#define QAR_I2C_SEQ_OP_READ    (3u << 8)
+#define QAR_I2C_SEQ_OP_STOP    (4u << 8)
+
+#define QAR_I2C_SEQ_CTRL_GO            (1u << 0)
+#define QAR_I2C_SEQ_CTRL_FLUSH         (1u << 1)
+#define QAR_I2C_SEQ_CTRL_ABORT_ON_NACK (1u << 2)
+
+#define QAR_I2C_SEQ_STATUS_RUNNING  (1u << 0)
+#define QAR_I2C_SEQ_STATUS_DONE     (1u << 1)
+#define QAR_I2C_SEQ_STATUS_NACK     (1u << 2)
+#define QAR_I2C_SEQ_STATUS_OVERFLOW (1u << 3)
+#define QAR_I2C_SEQ_STATUS_LEVEL_SHIFT 8
+#define QAR_I2C_SEQ_STATUS_RXCNT_SHIFT 16
+
 static inline void qar_i2c_init(uint32_t base, uint32_t clk_divider)
 {
     QAR_I2C_CLKDIV(base) = clk_divider;
@@ -65,4 +94,106 @@ static inline uint32_t qar_i2c_fault_status(uint32_t base)
     return QAR_I2C_FAULT_STATUS(base);
 }
 
+static inline void qar_i2c_seq_push(uint32_t base, uint32_t op, uint8_t data)
+{
+    QAR_I2C_SEQ_CMD(base) = op | data;
+}
+
+static inline void qar_i2c_seq_start(uint32_t base)
+{
+    QAR_I2C_SEQ_CTRL(base) = QAR_I2C_SEQ_CTRL_GO | QAR_I2C_SEQ_CTRL_ABORT_ON_NACK;
+}
+
+static inline int qar_i2c_seq_busy(uint32_t base)
+{
+    return (QAR_I2C_SEQ_STATUS(base) & QAR_I2C_SEQ_STATUS_RUNNING) != 0;
+}
+
+/*
+ * Queue START, address+W, register pointer, repeated START, address+R,
+ * an N-byte read and STOP, then launch the sequencer. The controller raises
+ * IRQ_STATUS[6] (SEQ_DONE) once the whole transaction has finished; the
+ * bytes are then waiting in the RX FIFO (see qar_i2c_seq_collect()).
+ * len 0 reads nothing. Past QAR_I2C_FIFO_DEPTH bytes the sequencer holds SCL
+ * low until the RX FIFO is popped, so drain it with qar_i2c_seq_read().
+ */
+static inline void qar_i2c_write_read(uint32_t base, uint8_t addr7, uint8_t reg, uint8_t len)
+{
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_START, 0);
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_WRITE, (uint8_t)(addr7 << 1));
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_WRITE, reg);
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_START, 0);
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_WRITE, (uint8_t)((addr7 << 1) | 1u));
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_READ, len);
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_STOP, 0);
+    qar_i2c_seq_start(base);
+}
+
+/*
+ * Register write: START, address+W, register pointer, payload, STOP, then
+ * launch the sequencer. data holds one byte per word. The whole transfer
+ * must fit the empty sequencer queue, so len is at most
+ * QAR_I2C_WRITE_REG_MAX; a longer write queues nothing and returns -1.
+ */
+static inline int qar_i2c_write_reg(uint32_t base, uint8_t addr7, uint8_t reg,
+                                    const uint32_t *data, uint32_t len)
+{
+    if (len > QAR_I2C_WRITE_REG_MAX)
+        return -1;
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_START, 0);
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_WRITE, (uint8_t)(addr7 << 1));
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_WRITE, reg);
+    for (uint32_t i = 0; i < len; ++i)
+        qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_WRITE, (uint8_t)data[i]);
+    qar_i2c_seq_push(base, QAR_I2C_SEQ_OP_STOP, 0);
+    qar_i2c_seq_start(base);
+    return 0;
+}
+
+/*
+ * Drain the bytes produced by the last sequence into buf, one per word,
+ * once it is done (at most QAR_I2C_FIFO_DEPTH of them). Returns the number of bytes copied,
+ * or -1 if the sequence was aborted on a NACK.
+ */
+static inline int qar_i2c_seq_collect(uint32_t base, uint32_t *buf, uint32_t max_len)
+{
+    uint32_t status = QAR_I2C_SEQ_STATUS(base);
+    uint32_t count = (status >> QAR_I2C_SEQ_STATUS_RXCNT_SHIFT) & 0xFFu;
+    uint32_t i;
+
+    if (count > max_len)
+        count = max_len;
+    for (i = 0; i < count; ++i)
+        buf[i] = qar_i2c_pop_rx(base);
+    QAR_I2C_SEQ_STATUS(base) = QAR_I2C_SEQ_STATUS_DONE | QAR_I2C_SEQ_STATUS_NACK;
+    QAR_I2C_IRQ_STATUS(base) = QAR_I2C_IRQ_SEQ_DONE;
+    return (status & QAR_I2C_SEQ_STATUS_NACK) ? -1 : (int)count;
+}
+
+/*
+ * Pop bytes into buf, one per word, while the sequence runs, for reads
+ * longer than the RX FIFO. Returns when the sequence is done: the number of bytes copied, or -1
+ * if it was aborted on a NACK. Bytes beyond max_len are popped and dropped.
+ */
+static inline int qar_i2c_seq_read(uint32_t base, uint32_t *buf, uint32_t max_len)
+{
+    uint32_t count = 0;
+    uint32_t status;
+
+    for (;;) {
+        /* Sample RUNNING first: once it reads 0 every byte is in the FIFO */
+        status = QAR_I2C_SEQ_STATUS(base);
+        if (QAR_I2C_STATUS(base) & QAR_I2C_STATUS_RX_RDY) {
+            uint32_t byte = qar_i2c_pop_rx(base);
+            if (count < max_len)
+                buf[count++] = byte;
+        } else if (!(status & QAR_I2C_SEQ_STATUS_RUNNING)) {
+            break;
+        }
+    }
+    QAR_I2C_SEQ_STATUS(base) = QAR_I2C_SEQ_STATUS_DONE | QAR_I2C_SEQ_STATUS_NACK;
+    QAR_I2C_IRQ_STATUS(base) = QAR_I2C_IRQ_SEQ_DONE;
+    return (status & QAR_I2C_SEQ_STATUS_NACK) ? -1 : (int)count;
+}
+
 #endif /* QAR_HAL_I2C_H */
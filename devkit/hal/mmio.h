@@ -3,6 +3,17 @@
 
 #include <stdint.h>
 
+/* Host tools (devkit/tools/initcheck) predefine this to record accesses */
+#ifndef QAR_MMIO32
 #define QAR_MMIO32(base, offset) (*((volatile uint32_t *)(uintptr_t)((uintptr_t)(base) + (offset))))
+#endif
+
+/* MMIO stores are posted: they retire before the peripheral sees them. A
+ * FENCE stalls until every posted store has completed; MMIO loads are
+ * already ordered after earlier MMIO stores. */
+static inline void qar_mmio_fence(void)
+{
+    __asm__ volatile ("fence" ::: "memory");
+}
 
 #endif /* QAR_HAL_MMIO_H */
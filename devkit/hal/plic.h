@@ -0,0 +1,89 @@
+#ifndef QAR_HAL_PLIC_H
+#define QAR_HAL_PLIC_H
+
+#include <stdint.h>
+#include "mmio.h"
+
+#define QAR_PLIC0_BASE 0x40008000u
+
+#define QAR_PLIC_REG(base, offset) QAR_MMIO32((base), (offset))
+
+#define QAR_PLIC_CTRL(base)           QAR_PLIC_REG((base), 0x00)
+#define QAR_PLIC_PENDING(base)        QAR_PLIC_REG((base), 0x04)
+#define QAR_PLIC_ENABLE(base)         QAR_PLIC_REG((base), 0x08)
+#define QAR_PLIC_THRESHOLD(base)      QAR_PLIC_REG((base), 0x0C)
+#define QAR_PLIC_CLAIM(base)          QAR_PLIC_REG((base), 0x10)
+#define QAR_PLIC_ACTIVE(base)         QAR_PLIC_REG((base), 0x14)
+#define QAR_PLIC_IN_SERVICE(base)     QAR_PLIC_REG((base), 0x18)
+#define QAR_PLIC_PRIORITY(base, src)  QAR_PLIC_REG((base), 0x40 + ((src) << 2))
+
+#define QAR_PLIC_CTRL_ENABLE      (1u << 0)
+
+#define QAR_PLIC_NUM_SOURCES      16u
+#define QAR_PLIC_MAX_PRIORITY     7u
+#define QAR_PLIC_NESTING_DEPTH    4u
+
+/* ACTIVE register fields */
+#define QAR_PLIC_ACTIVE_THRESHOLD(v)  ((v) & 0x7u)
+#define QAR_PLIC_ACTIVE_DEPTH(v)      (((v) >> 8) & 0xFu)
+
+/* Source IDs (0 = no interrupt) */
+#define QAR_PLIC_SRC_NONE   0u
+#define QAR_PLIC_SRC_UART0  1u
+#define QAR_PLIC_SRC_UART1  2u
+#define QAR_PLIC_SRC_CAN0   3u
+#define QAR_PLIC_SRC_CAN1   4u
+#define QAR_PLIC_SRC_GPIO   5u
+#define QAR_PLIC_SRC_SPI0   6u
+#define QAR_PLIC_SRC_SPI1   7u
+#define QAR_PLIC_SRC_I2C0   8u
+#define QAR_PLIC_SRC_I2C1   9u
+#define QAR_PLIC_SRC_ADC0   10u
+#define QAR_PLIC_SRC_EXT    11u
+
+/* Priority 0 never interrupts; 1..7, higher wins, ties go to the lower ID. */
+static inline void qar_plic_set_priority(uint32_t base, uint32_t source, uint32_t priority)
+{
+    QAR_PLIC_PRIORITY(base, source) = priority;
+}
+
+static inline void qar_plic_enable_source(uint32_t base, uint32_t source)
+{
+    QAR_PLIC_ENABLE(base) |= (1u << source);
+}
+
+static inline void qar_plic_disable_source(uint32_t base, uint32_t source)
+{
+    QAR_PLIC_ENABLE(base) &= ~(1u << source);
+}
+
+static inline void qar_plic_set_threshold(uint32_t base, uint32_t threshold)
+{
+    QAR_PLIC_THRESHOLD(base) = threshold;
+}
+
+/* Route external interrupts through the PLIC (enable != 0) or fall back to
+ * the legacy OR of every peripheral IRQ onto MEIP. */
+static inline void qar_plic_enable(uint32_t base, int enable)
+{
+    QAR_PLIC_CTRL(base) = enable ? QAR_PLIC_CTRL_ENABLE : 0u;
+}
+
+/* Returns the highest-priority pending source above the current threshold
+ * (0 if none) and raises the threshold to its priority until completion. */
+static inline uint32_t qar_plic_claim(uint32_t base)
+{
+    return QAR_PLIC_CLAIM(base);
+}
+
+static inline void qar_plic_complete(uint32_t base, uint32_t source)
+{
+    QAR_PLIC_CLAIM(base) = source;
+}
+
+static inline uint32_t qar_plic_pending(uint32_t base)
+{
+    return QAR_PLIC_PENDING(base);
+}
+
+#endif /* QAR_HAL_PLIC_H */
@@ -5,6 +5,7 @@
 #include "mmio.h"
 
 #define QAR_SPI0_BASE 0x40004000u
+#define QAR_SPI1_BASE 0x40004100u
 
 #define QAR_SPI_REG(base, offset) QAR_MMIO32((base), (offset))
 
@@ -28,16 +28,35 @@
 #define QAR_TIMER_CAPTURE_CTRL(base) QAR_TIMER_REG((base), 0x44)
 #define QAR_TIMER_CAPTURE0_VALUE(base) QAR_TIMER_REG((base), 0x48)
 #define QAR_TIMER_CAPTURE1_VALUE(base) QAR_TIMER_REG((base), 0x4C)
+#define QAR_TIMER_ICAP_CFG(base, ch)  QAR_TIMER_REG((base), 0x50 + ((ch) << 2))
+#define QAR_TIMER_ICAP_DATA(base, ch) QAR_TIMER_REG((base), 0x58 + ((ch) << 2))
+#define QAR_TIMER_ICAP_STATUS(base)   QAR_TIMER_REG((base), 0x60)
 
 #define QAR_TIMER_CTRL_ENABLE      (1u << 0)
 #define QAR_TIMER_CTRL_CMP0_AUTO   (1u << 1)
 #define QAR_TIMER_CTRL_CMP1_AUTO   (1u << 2)
+#define QAR_TIMER_CTRL_PWM_SYNC    (1u << 3)
 
 #define QAR_TIMER_STATUS_CMP0      (1u << 0)
 #define QAR_TIMER_STATUS_CMP1      (1u << 1)
 #define QAR_TIMER_STATUS_WDT       (1u << 2)
 #define QAR_TIMER_STATUS_CAPTURE0  (1u << 3)
 #define QAR_TIMER_STATUS_CAPTURE1  (1u << 4)
+#define QAR_TIMER_STATUS_ICAP0_WM  (1u << 5)
+#define QAR_TIMER_STATUS_ICAP1_WM  (1u << 6)
+#define QAR_TIMER_STATUS_ICAP_OVF  (1u << 7)
+
+#define QAR_TIMER_ICAP_ENABLE        (1u << 0)
+#define QAR_TIMER_ICAP_EDGE_RISING   (1u << 1)
+#define QAR_TIMER_ICAP_EDGE_FALLING  (1u << 2)
+#define QAR_TIMER_ICAP_EDGE_BOTH     (QAR_TIMER_ICAP_EDGE_RISING | QAR_TIMER_ICAP_EDGE_FALLING)
+#define QAR_TIMER_ICAP_PIN(pin)      (((pin) & 0x1Fu) << 4)
+#define QAR_TIMER_ICAP_WATERMARK(n)  (((n) & 0xFu) << 12)
+#define QAR_TIMER_ICAP_FLUSH         (1u << 16)
+#define QAR_TIMER_ICAP_DEPTH         8u
+
+#define QAR_TIMER_ICAP_LEVEL(status, ch) (((status) >> ((ch) * 8u)) & 0x1Fu)
+#define QAR_TIMER_ICAP_OVF(ch)           (1u << (16u + (ch)))
 
 static inline void qar_timer_init(uint32_t base, uint32_t prescale, uint32_t ctrl_flags)
 {
@@ -113,4 +132,50 @@ static inline uint32_t qar_timer_manual_capture(uint32_t base, uint32_t channel)
     return QAR_TIMER_CAPTURE1_VALUE(base);
 }
 
+/* Bind input-capture channel `channel` to GPIO `pin`; edges is a mask of
+ * QAR_TIMER_ICAP_EDGE_* bits. The FIFO is flushed on (re)configuration. */
+static inline void qar_timer_icap_config(uint32_t base, uint32_t channel, uint32_t pin,
+                                         uint32_t edges, uint32_t watermark)
+{
+    QAR_TIMER_ICAP_CFG(base, channel) = QAR_TIMER_ICAP_ENABLE |
+                                        (edges & QAR_TIMER_ICAP_EDGE_BOTH) |
+                                        QAR_TIMER_ICAP_PIN(pin) |
+                                        QAR_TIMER_ICAP_WATERMARK(watermark) |
+                                        QAR_TIMER_ICAP_FLUSH;
+}
+
+static inline void qar_timer_icap_disable(uint32_t base, uint32_t channel)
+{
+    QAR_TIMER_ICAP_CFG(base, channel) = QAR_TIMER_ICAP_FLUSH;
+}
+
+static inline uint32_t qar_timer_icap_level(uint32_t base, uint32_t channel)
+{
+    return QAR_TIMER_ICAP_LEVEL(QAR_TIMER_ICAP_STATUS(base), channel);
+}
+
+/* Drain up to `max` timestamps from a capture FIFO; returns the number read. */
+static inline uint32_t qar_timer_icap_read(uint32_t base, uint32_t channel, uint32_t *buf, uint32_t max)
+{
+    uint32_t count = qar_timer_icap_level(base, channel);
+    uint32_t i;
+
+    if (count > max)
+        count = max;
+    for (i = 0; i < count; ++i)
+        buf[i] = QAR_TIMER_ICAP_DATA(base, channel);
+    return count;
+}
+
+/* Returns non-zero (and clears the flag) if edges were dropped on `channel`. */
+static inline int qar_timer_icap_overflowed(uint32_t base, uint32_t channel)
+{
+    uint32_t mask = QAR_TIMER_ICAP_OVF(channel);
+
+    if (!(QAR_TIMER_ICAP_STATUS(base) & mask))
+        return 0;
+    QAR_TIMER_ICAP_STATUS(base) = mask;
+    return 1;
+}
+
 #endif /* QAR_HAL_TIMER_H */
@@ -0,0 +1,93 @@
+#ifndef QAR_HAL_TRACE_H
+#define QAR_HAL_TRACE_H
+
+#include <stdint.h>
+#include "mmio.h"
+
+/* Present when the core is built with TRACE_DEPTH > 0; otherwise every
+ * register reads as zero and qar_trace_depth() returns 0. */
+#define QAR_TRACE0_BASE 0x4000A000u
+
+#define QAR_TRACE_REG(base, offset) QAR_MMIO32((base), (offset))
+
+#define QAR_TRACE_CTRL(base)    QAR_TRACE_REG((base), 0x00)
+#define QAR_TRACE_STATUS(base)  QAR_TRACE_REG((base), 0x04)
+#define QAR_TRACE_DEPTH(base)   QAR_TRACE_REG((base), 0x08)
+#define QAR_TRACE_INDEX(base)   QAR_TRACE_REG((base), 0x0C)
+#define QAR_TRACE_DATA0(base)   QAR_TRACE_REG((base), 0x10)
+#define QAR_TRACE_DATA1(base)   QAR_TRACE_REG((base), 0x14)
+#define QAR_TRACE_DATA2(base)   QAR_TRACE_REG((base), 0x18)
+
+#define QAR_TRACE_CTRL_ENABLE   (1u << 0)
+#define QAR_TRACE_CTRL_ONESHOT  (1u << 1) /* stop when full instead of overwriting */
+#define QAR_TRACE_CTRL_FREEZE   (1u << 2) /* stop after recording an exception */
+#define QAR_TRACE_CTRL_CLEAR    (1u << 3) /* write-only: empty the buffer */
+
+#define QAR_TRACE_STATUS_LEVEL_MASK 0xFFFFu
+#define QAR_TRACE_STATUS_WRAPPED    (1u << 16)
+#define QAR_TRACE_STATUS_FROZEN     (1u << 17)
+
+/* Entry word0 fields; word1 is the address, word2 the mtime stamp */
+#define QAR_TRACE_KIND(word0)      ((word0) >> 30)
+#define QAR_TRACE_KIND_HIST        0u
+#define QAR_TRACE_KIND_JUMP        1u
+#define QAR_TRACE_KIND_TRAP        2u
+#define QAR_TRACE_KIND_SYNC        3u
+#define QAR_TRACE_HIST_COUNT(word0) (((word0) >> 25) & 0x1Fu)
+#define QAR_TRACE_HIST_BITS(word0)  (((word0) >> 5) & 0xFFFFFu)
+#define QAR_TRACE_CAUSE(word0)      ((((word0) & 0x10u) << 27) | ((word0) & 0xFu))
+
+static inline uint32_t qar_trace_depth(uint32_t base)
+{
+    return QAR_TRACE_DEPTH(base);
+}
+
+/* Empty the buffer and start recording. options = ONESHOT | FREEZE. */
+static inline void qar_trace_start(uint32_t base, uint32_t options)
+{
+    QAR_TRACE_CTRL(base) = QAR_TRACE_CTRL_ENABLE | QAR_TRACE_CTRL_CLEAR |
+                           (options & (QAR_TRACE_CTRL_ONESHOT | QAR_TRACE_CTRL_FREEZE));
+}
+
+/* Stop recording; pending branch bits are written out as a last entry. */
+static inline void qar_trace_stop(uint32_t base)
+{
+    QAR_TRACE_CTRL(base) = 0u;
+}
+
+/* Entries held, at most the depth */
+static inline uint32_t qar_trace_level(uint32_t base)
+{
+    return QAR_TRACE_STATUS(base) & QAR_TRACE_STATUS_LEVEL_MASK;
+}
+
+/* Recording was stopped by ONESHOT or FREEZE rather than by software */
+static inline int qar_trace_frozen(uint32_t base)
+{
+    return (QAR_TRACE_STATUS(base) & QAR_TRACE_STATUS_FROZEN) != 0u;
+}
+
+/* Entry index (0 = oldest held) into entry[0..2]; reads have no side effects. */
+static inline void qar_trace_read(uint32_t base, uint32_t index, uint32_t entry[3])
+{
+    QAR_TRACE_INDEX(base) = index;
+    entry[0] = QAR_TRACE_DATA0(base);
+    entry[1] = QAR_TRACE_DATA1(base);
+    entry[2] = QAR_TRACE_DATA2(base);
+}
+
+/* Copy up to max_entries entries, oldest first, three words each (the line
+ * format of `qarsim trace`). Stop recording first. Returns the count. */
+static inline uint32_t qar_trace_copy(uint32_t base, uint32_t *dst, uint32_t max_entries)
+{
+    uint32_t count = qar_trace_level(base);
+    uint32_t i;
+
+    if (count > max_entries)
+        count = max_entries;
+    for (i = 0; i < count; i++)
+        qar_trace_read(base, i, &dst[3 * i]);
+    return count;
+}
+
+#endif /* QAR_HAL_TRACE_H */
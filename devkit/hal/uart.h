@@ -7,6 +7,9 @@
 #define QAR_UART0_BASE 0x40001000u
 #define QAR_UART1_BASE 0x40002000u
 
+/* Depth of each RX/TX FIFO in qar_uart.v (FIFO_DEPTH). */
+#define QAR_UART_FIFO_DEPTH 8u
+
 #define QAR_UART_REG(base, offset) QAR_MMIO32((base), (offset))
 
 #define QAR_UART_DATA(base)       QAR_UART_REG((base), 0x00)
@@ -22,11 +25,15 @@
 #define QAR_UART_LIN_TX_ID(base)  QAR_UART_REG((base), 0x28)
 #define QAR_UART_LIN_HEADER(base) QAR_UART_REG((base), 0x2C)
 #define QAR_UART_LIN_SLAVE(base)  QAR_UART_REG((base), 0x30)
+#define QAR_UART_LIN_SCHED_CTRL(base)   QAR_UART_REG((base), 0x34)
+#define QAR_UART_LIN_SCHED_ENTRY(base)  QAR_UART_REG((base), 0x38)
+#define QAR_UART_LIN_SCHED_STATUS(base) QAR_UART_REG((base), 0x3C)
 
 #define QAR_UART_CTRL_ENABLE     (1u << 0)
 #define QAR_UART_CTRL_PARITY_EN  (1u << 1)
 #define QAR_UART_CTRL_PARITY_ODD (1u << 2)
 #define QAR_UART_CTRL_TWO_STOP   (1u << 3)
+#define QAR_UART_CTRL_LIN_MODE   (1u << 5)
 
 #define QAR_UART_STATUS_RX_READY (1u << 0)
 #define QAR_UART_STATUS_TX_SPACE (1u << 1)
@@ -48,6 +55,20 @@
 #define QAR_UART_IRQ_LIN_BREAK   (1u << 4)
 #define QAR_UART_IRQ_LIN_HEADER  (1u << 5)
 #define QAR_UART_IRQ_LIN_SLAVE   (1u << 6)
+#define QAR_UART_IRQ_LIN_SCHED_RESP (1u << 7)
+#define QAR_UART_IRQ_LIN_SCHED_ERR  (1u << 8)
+
+#define QAR_UART_LIN_SCHED_DEPTH      8u
+#define QAR_UART_LIN_SCHED_RUN        (1u << 0)
+#define QAR_UART_LIN_SCHED_ONE_SHOT   (1u << 1)
+
+#define QAR_UART_LIN_SCHED_RUNNING    (1u << 3)
+#define QAR_UART_LIN_SCHED_RESP_WAIT  (1u << 4)
+#define QAR_UART_LIN_SCHED_RESP_DONE  (1u << 8)
+#define QAR_UART_LIN_SCHED_TIMEOUT    (1u << 9)
+#define QAR_UART_LIN_SCHED_OVERRUN    (1u << 10)
+#define QAR_UART_LIN_SCHED_RX_ERROR   (1u << 11)
+#define QAR_UART_LIN_SCHED_FLAGS      0xF00u
 
 static inline void qar_uart_init(uint32_t base, uint32_t baud_divider, uint32_t ctrl_flags)
 {
@@ -136,6 +157,48 @@ static inline uint32_t qar_uart_lin_header(uint32_t base)
     return QAR_UART_LIN_HEADER(base);
 }
 
+/* Protected identifier: 6-bit frame ID plus parity bits P0/P1 */
+static inline uint8_t qar_uart_lin_pid(uint8_t id)
+{
+    uint32_t p0 = (id ^ (id >> 1) ^ (id >> 2) ^ (id >> 4)) & 1u;
+    uint32_t p1 = ~((id >> 1) ^ (id >> 3) ^ (id >> 4) ^ (id >> 5)) & 1u;
+    return (uint8_t)((id & 0x3Fu) | (p0 << 6) | (p1 << 7));
+}
+
+/* Schedule entry: header byte, slot length in lin_tick pulses and the number
+ * of response bytes to expect (0 = header only, no response monitoring). */
+static inline void qar_uart_lin_sched_set_entry(uint32_t base, uint32_t index, uint8_t header_id,
+                                                uint8_t slot_ticks, uint8_t resp_len)
+{
+    QAR_UART_LIN_SCHED_ENTRY(base) = ((index & 0x7u) << 24) |
+                                     ((uint32_t)(resp_len & 0xFu) << 16) |
+                                     ((uint32_t)slot_ticks << 8) | header_id;
+}
+
+/* Run entries 0..count-1 from entry 0; one_shot stops after the last slot. */
+static inline void qar_uart_lin_sched_start(uint32_t base, uint32_t count, int one_shot)
+{
+    uint32_t ctrl = (((count - 1u) & 0x7u) << 8) | QAR_UART_LIN_SCHED_RUN;
+    if (one_shot)
+        ctrl |= QAR_UART_LIN_SCHED_ONE_SHOT;
+    QAR_UART_LIN_SCHED_CTRL(base) = ctrl;
+}
+
+static inline void qar_uart_lin_sched_stop(uint32_t base)
+{
+    QAR_UART_LIN_SCHED_CTRL(base) = 0;
+}
+
+static inline uint32_t qar_uart_lin_sched_status(uint32_t base)
+{
+    return QAR_UART_LIN_SCHED_STATUS(base);
+}
+
+static inline void qar_uart_lin_sched_clear(uint32_t base, uint32_t flags)
+{
+    QAR_UART_LIN_SCHED_STATUS(base) = flags & QAR_UART_LIN_SCHED_FLAGS;
+}
+
 static inline uint32_t qar_uart_status(uint32_t base)
 {
     return QAR_UART_STATUS(base);
@@ -0,0 +1,135 @@
+#include <stdint.h>
+
+#include "dsp.h"
+#include "runtime.h"
+
+/* Right-shift base for Q31 terms: one more than the coefficient's
+ * fraction bits, because the Q31 kernels accumulate at half scale. */
+#define Q31_RIGHT_FIR    16u
+#define Q31_RIGHT_BIQUAD 15u
+
+typedef uint32_t (*fir_run_fn)(const qar_dsp_fir_t *fir, const int32_t *first,
+                               const int32_t *end, int32_t *out, uint32_t step);
+
+static void fir_init(qar_dsp_fir_t *fir, const int32_t *coefs, uint32_t taps,
+                     uint32_t *coef_buf, int32_t *state, uint32_t block_max, uint32_t right)
+{
+    uint32_t *words = coef_buf;
+    uint32_t i;
+
+    fir->bias = 0;
+    /* The state runs oldest sample first, so the last tap leads */
+    for (i = taps; i > 0; i--)
+        words += qar_dsp_encode(coefs[i - 1], right, words, right ? &fir->bias : 0);
+
+    fir->coefs = coef_buf;
+    fir->state = state;
+    fir->taps = taps;
+    fir->block_max = block_max;
+    memset(state, 0, QAR_DSP_FIR_STATE_WORDS(taps, block_max) * sizeof(int32_t));
+}
+
+void qar_dsp_fir_init_q15(qar_dsp_fir_t *fir, const int32_t *coefs, uint32_t taps,
+                          uint32_t *coef_buf, int32_t *state, uint32_t block_max)
+{
+    fir_init(fir, coefs, taps, coef_buf, state, block_max, 0);
+}
+
+void qar_dsp_fir_init_q31(qar_dsp_fir_t *fir, const int32_t *coefs, uint32_t taps,
+                          uint32_t *coef_buf, int32_t *state, uint32_t block_max)
+{
+    fir_init(fir, coefs, taps, coef_buf, state, block_max, Q31_RIGHT_FIR);
+}
+
+/* Append each chunk to the history, filter it in place and keep the last
+ * taps - 1 samples for the next one; outputs are the windows starting at
+ * factor - 1, 2 * factor - 1, ... of each chunk. */
+static uint32_t fir_blocks(qar_dsp_fir_t *fir, const int32_t *in, int32_t *out,
+                           uint32_t count, uint32_t factor, fir_run_fn run)
+{
+    uint32_t history = fir->taps - 1u;
+    uint32_t produced = 0;
+
+    while (count) {
+        uint32_t chunk = count < fir->block_max ? count : fir->block_max;
+
+        memcpy(fir->state + history, in, chunk * sizeof(int32_t));
+        produced += run(fir, fir->state + factor - 1u, fir->state + chunk, out + produced, factor);
+        memmove(fir->state, fir->state + chunk, history * sizeof(int32_t));
+        in += chunk;
+        count -= chunk;
+    }
+    return produced;
+}
+
+void qar_dsp_fir_q15(qar_dsp_fir_t *fir, const qar_q15_t *in, qar_q15_t *out, uint32_t count)
+{
+    fir_blocks(fir, in, out, count, 1, qar_dsp_fir_run_q15);
+}
+
+void qar_dsp_fir_q31(qar_dsp_fir_t *fir, const qar_q31_t *in, qar_q31_t *out, uint32_t count)
+{
+    fir_blocks(fir, in, out, count, 1, qar_dsp_fir_run_q31);
+}
+
+uint32_t qar_dsp_fir_decimate_q15(qar_dsp_fir_t *fir, const qar_q15_t *in, qar_q15_t *out,
+                                  uint32_t count, uint32_t factor)
+{
+    return fir_blocks(fir, in, out, count, factor, qar_dsp_fir_run_q15);
+}
+
+uint32_t qar_dsp_fir_decimate_q31(qar_dsp_fir_t *fir, const qar_q31_t *in, qar_q31_t *out,
+                                  uint32_t count, uint32_t factor)
+{
+    return fir_blocks(fir, in, out, count, factor, qar_dsp_fir_run_q31);
+}
+
+/* Per stage: b0, b1, b2, -a1, -a2 (the kernels only add), led by the
+ * stage's bias word for Q31. */
+static void biquad_init(qar_dsp_biquad_t *bq, const int32_t *coefs, uint32_t stages,
+                        uint32_t *coef_buf, int32_t *state, uint32_t right)
+{
+    uint32_t *words = coef_buf;
+    uint32_t s;
+    uint32_t i;
+
+    for (s = 0; s < stages; s++, coefs += 5) {
+        uint32_t *bias = right ? words++ : 0;
+
+        if (bias)
+            *bias = 0;
+        for (i = 0; i < 5u; i++) {
+            int32_t coef = i < 3u ? coefs[i] : -coefs[i];
+            words += qar_dsp_encode(coef, right, words, bias);
+        }
+    }
+
+    bq->coefs = coef_buf;
+    bq->state = state;
+    bq->stages = stages;
+    memset(state, 0, QAR_DSP_BIQUAD_STATE_WORDS(stages) * sizeof(int32_t));
+}
+
+void qar_dsp_biquad_init_q15(qar_dsp_biquad_t *bq, const int32_t *coefs, uint32_t stages,
+                             uint32_t *coef_buf, int32_t *state)
+{
+    biquad_init(bq, coefs, stages, coef_buf, state, 0);
+}
+
+void qar_dsp_biquad_init_q31(qar_dsp_biquad_t *bq, const int32_t *coefs, uint32_t stages,
+                             uint32_t *coef_buf, int32_t *state)
+{
+    biquad_init(bq, coefs, stages, coef_buf, state, Q31_RIGHT_BIQUAD);
+}
+
+void qar_dsp_mavg_init(qar_dsp_mavg_t *avg, int32_t *window, uint32_t log2_len)
+{
+    uint32_t len = 1u << log2_len;
+
+    avg->window = window;
+    avg->mask = (len - 1u) * sizeof(int32_t);
+    avg->pos = 0;
+    avg->sum = 0;
+    avg->shift = log2_len;
+    memset(window, 0, len * sizeof(int32_t));
+}
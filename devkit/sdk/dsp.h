@@ -0,0 +1,124 @@
+#ifndef QAR_SDK_DSP_H
+#define QAR_SDK_DSP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Fixed-point block filters for ADC post-processing.
+ *
+ * The core has no multiplier, so generic C filters spend most of their
+ * time in __mulsi3. Here each coefficient is encoded once, at init, into
+ * its canonical signed digits, and the kernels in dsp.S apply it with
+ * shifts and adds; the encoding is also where the Q31 kernels work around
+ * the missing SRA (see dsp.S).
+ *
+ * Samples are one per 32-bit word (the core only has LW/SW): Q15 values
+ * in [-32768, 32767], or Q31. Filters keep their own state, so a stream
+ * can be fed in blocks of any size, and in == out is allowed. Q15 outputs
+ * are rounded and Q15/Q31 outputs saturate. Q31 products are truncated
+ * per CSD term, which costs a few LSBs per tap.
+ *
+ * Link with `qarsim build --c app.c --dsp`.
+ */
+
+typedef int32_t qar_q15_t;
+typedef int32_t qar_q31_t;
+
+/* Encoded coefficient storage, worst case, for `count` Q15/Q14 coefficients */
+#define QAR_DSP_COEF_WORDS(count) (3u * (count))
+
+/* --- FIR ------------------------------------------------------------- */
+
+typedef struct {
+    const uint32_t *coefs;  /* encoded, last tap first */
+    int32_t *state;         /* taps - 1 history words, then block_max */
+    uint32_t taps;
+    uint32_t block_max;
+    uint32_t bias;          /* Q31 only, see dsp.S */
+} qar_dsp_fir_t;
+
+/* State storage for a FIR of `taps` fed at most `block_max` samples at once */
+#define QAR_DSP_FIR_STATE_WORDS(taps, block_max) ((taps) - 1u + (block_max))
+
+/*
+ * coefs are taps Q15 values, coefs[0] applying to the newest sample. Keep
+ * the sum of their magnitudes at or below 1.0 (32768) for full-scale
+ * input. coef_buf holds QAR_DSP_COEF_WORDS(taps) words; state holds
+ * QAR_DSP_FIR_STATE_WORDS(taps, block_max) words and is cleared here.
+ */
+void qar_dsp_fir_init_q15(qar_dsp_fir_t *fir, const int32_t *coefs, uint32_t taps,
+                          uint32_t *coef_buf, int32_t *state, uint32_t block_max);
+void qar_dsp_fir_init_q31(qar_dsp_fir_t *fir, const int32_t *coefs, uint32_t taps,
+                          uint32_t *coef_buf, int32_t *state, uint32_t block_max);
+
+void qar_dsp_fir_q15(qar_dsp_fir_t *fir, const qar_q15_t *in, qar_q15_t *out, uint32_t count);
+void qar_dsp_fir_q31(qar_dsp_fir_t *fir, const qar_q31_t *in, qar_q31_t *out, uint32_t count);
+
+/*
+ * FIR that only computes every factor-th output (the last sample of each
+ * group of factor inputs). count and block_max must be multiples of
+ * factor. Returns the number of outputs (count / factor).
+ */
+uint32_t qar_dsp_fir_decimate_q15(qar_dsp_fir_t *fir, const qar_q15_t *in, qar_q15_t *out,
+                                  uint32_t count, uint32_t factor);
+uint32_t qar_dsp_fir_decimate_q31(qar_dsp_fir_t *fir, const qar_q31_t *in, qar_q31_t *out,
+                                  uint32_t count, uint32_t factor);
+
+/* --- Biquad IIR -------------------------------------------------------- */
+
+typedef struct {
+    const uint32_t *coefs;  /* encoded, per stage */
+    int32_t *state;         /* 4 words per stage */
+    uint32_t stages;
+} qar_dsp_biquad_t;
+
+#define QAR_DSP_BIQUAD_COEF_WORDS(stages) ((stages) * (QAR_DSP_COEF_WORDS(5u) + 1u))
+#define QAR_DSP_BIQUAD_STATE_WORDS(stages) (4u * (stages))
+
+/*
+ * Direct form I cascade. coefs holds five Q14 values per stage,
+ * b0, b1, b2, a1, a2, for y = b0 x[n] + b1 x[n-1] + b2 x[n-2]
+ * - a1 y[n-1] - a2 y[n-2] (so |a1| < 2 fits). Keep the five magnitudes of
+ * a stage below 4.0 in sum for full-scale input. State is cleared here.
+ */
+void qar_dsp_biquad_init_q15(qar_dsp_biquad_t *bq, const int32_t *coefs, uint32_t stages,
+                             uint32_t *coef_buf, int32_t *state);
+void qar_dsp_biquad_init_q31(qar_dsp_biquad_t *bq, const int32_t *coefs, uint32_t stages,
+                             uint32_t *coef_buf, int32_t *state);
+
+void qar_dsp_biquad_q15(const qar_dsp_biquad_t *bq, const qar_q15_t *in, qar_q15_t *out,
+                        uint32_t count);
+void qar_dsp_biquad_q31(const qar_dsp_biquad_t *bq, const qar_q31_t *in, qar_q31_t *out,
+                        uint32_t count);
+
+/* --- Moving average ---------------------------------------------------- */
+
+typedef struct {
+    int32_t *window;
+    uint32_t mask;          /* (length - 1) * 4 */
+    uint32_t pos;           /* byte offset of the oldest sample */
+    int32_t sum;
+    uint32_t shift;         /* log2 of the length */
+} qar_dsp_mavg_t;
+
+/* Rounded mean of the last 2^log2_len samples; window holds 2^log2_len
+ * words (at most 2^15) and starts out zero. */
+void qar_dsp_mavg_init(qar_dsp_mavg_t *avg, int32_t *window, uint32_t log2_len);
+void qar_dsp_mavg_q15(qar_dsp_mavg_t *avg, const qar_q15_t *in, qar_q15_t *out, uint32_t count);
+
+/* Internal: dsp.S */
+uint32_t qar_dsp_encode(int32_t coef, uint32_t right, uint32_t *out, uint32_t *bias);
+uint32_t qar_dsp_fir_run_q15(const qar_dsp_fir_t *fir, const int32_t *first,
+                             const int32_t *end, int32_t *out, uint32_t step);
+uint32_t qar_dsp_fir_run_q31(const qar_dsp_fir_t *fir, const int32_t *first,
+                             const int32_t *end, int32_t *out, uint32_t step);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QAR_SDK_DSP_H */
@@ -2,6 +2,19 @@
 
 #include <stdint.h>
 
+#ifdef QAR_INIT_TABLE
+
+#include "sdk/init_table.h"
+
+/* Only the blocks listed in the project's peripheral config are touched;
+ * the sequences below are compiled out. */
+void qar_sdk_init(void)
+{
+    qar_init_apply(qar_init_table, qar_init_table_len);
+}
+
+#else /* !QAR_INIT_TABLE */
+
 #include "hal/gpio.h"
 #include "hal/uart.h"
 #include "hal/timer.h"
@@ -9,6 +22,9 @@
 #include "hal/spi.h"
 #include "hal/i2c.h"
 #include "hal/adc.h"
+#include "hal/evr.h"
+#include "hal/plic.h"
+#include "hal/crc.h"
 
 #define QAR_UART_BOOT_DIV      500u
 #define QAR_CAN_BOOT_BITTIME   0x00000013u
@@ -22,7 +38,9 @@
     QAR_UART_IRQ_IDLE       | \
     QAR_UART_IRQ_LIN_BREAK  | \
     QAR_UART_IRQ_LIN_HEADER | \
-    QAR_UART_IRQ_LIN_SLAVE)
+    QAR_UART_IRQ_LIN_SLAVE  | \
+    QAR_UART_IRQ_LIN_SCHED_RESP | \
+    QAR_UART_IRQ_LIN_SCHED_ERR)
 
 #define QAR_CAN_IRQ_ALL    (\
     QAR_CAN_IRQ_RX_READY | \
@@ -34,7 +52,10 @@
     QAR_TIMER_STATUS_CMP1     | \
     QAR_TIMER_STATUS_WDT      | \
     QAR_TIMER_STATUS_CAPTURE0 | \
-    QAR_TIMER_STATUS_CAPTURE1)
+    QAR_TIMER_STATUS_CAPTURE1 | \
+    QAR_TIMER_STATUS_ICAP0_WM | \
+    QAR_TIMER_STATUS_ICAP1_WM | \
+    QAR_TIMER_STATUS_ICAP_OVF)
 
 #define QAR_SPI_IRQ_ALL   (\
     QAR_SPI_IRQ_RX_READY  | \
@@ -50,11 +71,18 @@
     QAR_I2C_IRQ_FAULT    | \
     QAR_I2C_IRQ_TX_OVF   | \
     QAR_I2C_IRQ_RX_OVF   | \
-    QAR_I2C_IRQ_NACK)
+    QAR_I2C_IRQ_NACK     | \
+    QAR_I2C_IRQ_SEQ_DONE)
 
 #define QAR_ADC_IRQ_ALL   (\
-    QAR_ADC_IRQ_DATA_READY | \
-    QAR_ADC_IRQ_OVERRUN)
+    QAR_ADC_IRQ_DATA_READY     | \
+    QAR_ADC_IRQ_OVERRUN        | \
+    QAR_ADC_IRQ_FIFO_WATERMARK | \
+    QAR_ADC_IRQ_FIFO_OVERFLOW  | \
+    QAR_ADC_IRQ_WINDOW)
+
+/* devkit/cli/periphinit.go mirrors these sequences for generated tables;
+ * scripts/check_periphinit.sh fails when the two differ. */
 
 static void init_gpio_block(uint32_t base)
 {
@@ -64,6 +92,7 @@ static void init_gpio_block(uint32_t base)
     qar_gpio_config_irq(base, 0x0u, 0x0u, 0x0u);
     qar_gpio_config_debounce(base, 0x0u, 0);
     qar_gpio_clear_irq(base, 0xFFFFFFFFu);
+    qar_gpio_seq_stop(base);
 }
 
 static void init_timer_block(uint32_t base)
@@ -83,6 +112,8 @@ static void init_timer_block(uint32_t base)
     QAR_TIMER_WDT_LOAD(base) = 0x0u;
     QAR_TIMER_WDT_CTRL(base) = 0x0u;
     QAR_TIMER_CAPTURE_CTRL(base) = 0x0u;
+    QAR_TIMER_ICAP_CFG(base, 0) = QAR_TIMER_ICAP_FLUSH;
+    QAR_TIMER_ICAP_CFG(base, 1) = QAR_TIMER_ICAP_FLUSH;
 }
 
 static void init_uart_block(uint32_t base)
@@ -93,6 +124,8 @@ static void init_uart_block(uint32_t base)
     QAR_UART_IDLE_CFG(base) = 0x0u;
     QAR_UART_LIN_CTRL(base) = 13u; /* 13 bit-period break by default */
     QAR_UART_LIN_SLAVE(base) = 0x0u;
+    qar_uart_lin_sched_stop(base);
+    qar_uart_lin_sched_clear(base, QAR_UART_LIN_SCHED_FLAGS);
     qar_uart_disable_irq(base, QAR_UART_IRQ_ALL);
     qar_uart_clear_irq(base, QAR_UART_IRQ_ALL);
     qar_uart_lin_clear_break(base);
@@ -123,6 +156,7 @@ static void init_i2c_block(uint32_t base)
     QAR_I2C_CTRL(base) = 0x0u;
     QAR_I2C_CLKDIV(base) = QAR_I2C_BOOT_CLKDIV;
     QAR_I2C_IRQ_EN(base) = 0x0u;
+    QAR_I2C_SEQ_CTRL(base) = QAR_I2C_SEQ_CTRL_FLUSH | QAR_I2C_SEQ_CTRL_ABORT_ON_NACK;
     QAR_I2C_IRQ_STATUS(base) = QAR_I2C_IRQ_ALL;
 }
 
@@ -131,10 +165,36 @@ static void init_adc_block(uint32_t base)
     QAR_ADC_CTRL(base) = 0x0u;
     QAR_ADC_SEQ_MASK(base) = 0x0u;
     QAR_ADC_SAMPLE_DIV(base) = 0x0u;
+    QAR_ADC_FIFO_CTRL(base) = QAR_ADC_FIFO_CTRL_FLUSH;
+    QAR_ADC_OVERSAMPLE(base) = 0x0u;
+    QAR_ADC_WIN_EN(base) = 0x0u;
+    QAR_ADC_WIN_STATUS(base) = QAR_ADC_WIN_HIT_ALL;
     QAR_ADC_IRQ_EN(base) = 0x0u;
     QAR_ADC_IRQ_STATUS(base) = QAR_ADC_IRQ_ALL;
 }
 
+static void init_evr_block(uint32_t base)
+{
+    uint32_t action;
+
+    QAR_EVR_CTRL(base) = 0x0u;
+    for (action = 0; action < QAR_EVR_ACT_COUNT; ++action)
+        QAR_EVR_ROUTE(base, action) = QAR_EVR_SRC_NONE;
+    QAR_EVR_GPIO_SEL(base) = 0x0u;
+    qar_evr_clear_flags(base);
+}
+
+static void init_plic_block(uint32_t base)
+{
+    uint32_t source;
+
+    QAR_PLIC_CTRL(base) = 0x0u;
+    QAR_PLIC_ENABLE(base) = 0x0u;
+    QAR_PLIC_THRESHOLD(base) = 0x0u;
+    for (source = 1; source < QAR_PLIC_NUM_SOURCES; ++source)
+        QAR_PLIC_PRIORITY(base, source) = 0x0u;
+}
+
 void qar_sdk_init(void)
 {
     init_gpio_block(QAR_GPIO0_BASE);
@@ -142,7 +202,15 @@ void qar_sdk_init(void)
     init_uart_block(QAR_UART0_BASE);
     init_uart_block(QAR_UART1_BASE);
     init_can_block(QAR_CAN0_BASE);
+    init_can_block(QAR_CAN1_BASE);
     init_spi_block(QAR_SPI0_BASE);
+    init_spi_block(QAR_SPI1_BASE);
     init_i2c_block(QAR_I2C0_BASE);
+    init_i2c_block(QAR_I2C1_BASE);
     init_adc_block(QAR_ADC0_BASE);
+    init_evr_block(QAR_EVR0_BASE);
+    init_plic_block(QAR_PLIC0_BASE);
+    qar_crc_setup_crc32(QAR_CRC0_BASE);
 }
+
+#endif /* QAR_INIT_TABLE */
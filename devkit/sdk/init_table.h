@@ -0,0 +1,43 @@
+#ifndef QAR_SDK_INIT_TABLE_H
+#define QAR_SDK_INIT_TABLE_H
+
+#include <stdint.h>
+
+#include "hal/mmio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Peripheral init table: word-aligned MMIO address / value pairs, applied
+ * in order. `qarsim build --c ... --periph-config board.json` generates
+ * qar_init_table from the blocks listed in the config and builds
+ * hal_init.c with QAR_INIT_TABLE, so qar_sdk_init() replays the table
+ * instead of resetting every peripheral. The table is const (linked into
+ * IMEM and read with IMEM_DATA_LOADS=1); the flat layout also suits a
+ * future DMA engine.
+ */
+typedef struct {
+    uint32_t addr;
+    uint32_t value;
+} qar_init_entry_t;
+
+extern const qar_init_entry_t qar_init_table[];
+extern const uint32_t qar_init_table_len;
+
+/* Stores are posted on the peripheral bus, so this costs about one
+ * cycle per entry plus the two table loads. */
+static inline void qar_init_apply(const qar_init_entry_t *table, uint32_t count)
+{
+    while (count--) {
+        QAR_MMIO32(table->addr, 0) = table->value;
+        table++;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QAR_SDK_INIT_TABLE_H */
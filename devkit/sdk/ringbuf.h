@@ -0,0 +1,84 @@
+#ifndef QAR_SDK_RINGBUF_H
+#define QAR_SDK_RINGBUF_H
+
+#include <stdint.h>
+
+#include "hal/cpu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Lock-free single-producer/single-consumer word queue for passing data
+ * between one ISR and the main loop (either direction) without masking
+ * interrupts. head is written only by the producer and tail only by the
+ * consumer; both are free-running word counters, so each side publishes
+ * its progress with a single aligned store. The payload is written before
+ * head advances and read before tail advances (qar_compiler_barrier()
+ * keeps that order; the core never reorders DMEM accesses).
+ *
+ * The drop counter may be bumped from several contexts, so it uses
+ * qar_atomic_fetch_add() (one AMOADD.W on rv32ia builds).
+ */
+typedef struct {
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;
+    uint32_t mask;
+    uint32_t *data;
+} qar_ringbuf_t;
+
+/* size (in words) must be a power of two. Entries are whole words because
+ * the core only implements LW/SW. */
+static inline void qar_ringbuf_init(qar_ringbuf_t *rb, uint32_t *storage, uint32_t size)
+{
+    rb->head = 0;
+    rb->tail = 0;
+    rb->dropped = 0;
+    rb->mask = size - 1u;
+    rb->data = storage;
+}
+
+static inline uint32_t qar_ringbuf_count(const qar_ringbuf_t *rb)
+{
+    return rb->head - rb->tail;
+}
+
+/* Producer side. Returns 0 and counts a drop when the queue is full. */
+static inline int qar_ringbuf_push(qar_ringbuf_t *rb, uint32_t value)
+{
+    uint32_t head = rb->head;
+    if (head - rb->tail > rb->mask) {
+        qar_atomic_fetch_add(&rb->dropped, 1u);
+        return 0;
+    }
+    rb->data[head & rb->mask] = value;
+    qar_compiler_barrier();
+    rb->head = head + 1u;
+    return 1;
+}
+
+/* Consumer side. Returns 0 when the queue is empty. */
+static inline int qar_ringbuf_pop(qar_ringbuf_t *rb, uint32_t *value)
+{
+    uint32_t tail = rb->tail;
+    if (rb->head == tail)
+        return 0;
+    *value = rb->data[tail & rb->mask];
+    qar_compiler_barrier();
+    rb->tail = tail + 1u;
+    return 1;
+}
+
+/* Read and reset the drop counter atomically. */
+static inline uint32_t qar_ringbuf_take_dropped(qar_ringbuf_t *rb)
+{
+    return qar_atomic_swap(&rb->dropped, 0u);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QAR_SDK_RINGBUF_H */
@@ -7,3 +7,21 @@ __attribute__((constructor)) static void qar_call_init(void)
     if (qar_sdk_init)
         qar_sdk_init();
 }
+
+/* C++ ABI hooks for firmware built with -fno-exceptions -fno-rtti. main()
+ * never returns, so destructors of static objects are not registered. */
+__attribute__((weak)) void *__dso_handle = 0;
+
+__attribute__((weak)) int __cxa_atexit(void (*destructor)(void *), void *arg, void *dso)
+{
+    (void)destructor;
+    (void)arg;
+    (void)dso;
+    return 0;
+}
+
+__attribute__((weak)) void __cxa_pure_virtual(void)
+{
+    while (1)
+        ;
+}
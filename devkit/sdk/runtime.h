@@ -0,0 +1,30 @@
+#ifndef QAR_SDK_RUNTIME_H
+#define QAR_SDK_RUNTIME_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Freestanding runtime linked into every C build (firmware uses -nostdlib).
+ *
+ * devkit/sdk/string.S provides the C library buffer routines below. They
+ * move data as aligned words because the core only implements LW/SW;
+ * bytes at unaligned edges are read-modify-written within their word, so
+ * an ISR must not store to other bytes of a word a caller is copying into.
+ *
+ * devkit/sdk/muldiv.S provides __mulsi3, __udivsi3, __umodsi3, __divsi3
+ * and __modsi3, which GCC calls for '*', '/' and '%' on rv32i.
+ */
+void *memcpy(void *dst, const void *src, size_t n);
+void *memmove(void *dst, const void *src, size_t n);
+void *memset(void *dst, int c, size_t n);
+int memcmp(const void *a, const void *b, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QAR_SDK_RUNTIME_H */
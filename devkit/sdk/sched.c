@@ -0,0 +1,296 @@
+#include <stdint.h>
+
+#include "hal/cpu.h"
+#include "hal/timer.h"
+#include "sched.h"
+
+#define SCHED_TIMER QAR_TIMER0_BASE
+
+#define MCAUSE_ECALL     11u
+#define MCAUSE_TIMER_IRQ 0x80000007u
+#define MCAUSE_EXT_IRQ   0x8000000Bu
+
+#define MSTATUS_MPIE (1u << 7)
+
+/* Trap frame slots, see sched_switch.S: slot n holds xn */
+#define FRAME_MEPC    0
+#define FRAME_RA      1
+#define FRAME_MSTATUS 2
+#define FRAME_A0      10
+
+void qar_sched_trap_entry(void);
+void qar_sched_resume(uint32_t *frame) __attribute__((noreturn));
+
+static qar_task_t *ready_head[QAR_SCHED_PRIORITIES];
+static qar_task_t *ready_tail[QAR_SCHED_PRIORITIES];
+static uint32_t ready_mask;
+static qar_task_t *delay_head;
+static qar_task_t *current;
+static uint32_t in_trap;
+static volatile uint32_t tick_count;
+
+static qar_task_t idle_task;
+QAR_TASK_STACK(idle_stack, QAR_TASK_MIN_STACK_WORDS);
+
+static void ready_push(qar_task_t *task)
+{
+    uint32_t prio = task->priority;
+
+    task->state = QAR_TASK_READY;
+    task->next = 0;
+    if (ready_head[prio]) {
+        ready_tail[prio]->next = task;
+    } else {
+        ready_head[prio] = task;
+        ready_mask |= 1u << prio;
+    }
+    ready_tail[prio] = task;
+}
+
+/* The running task is always the head of its priority's queue */
+static void ready_pop_current(void)
+{
+    uint32_t prio = current->priority;
+
+    ready_head[prio] = current->next;
+    if (!ready_head[prio])
+        ready_mask &= ~(1u << prio);
+}
+
+static void ready_rotate(uint32_t prio)
+{
+    qar_task_t *head = ready_head[prio];
+
+    if (!head || !head->next)
+        return;
+    ready_head[prio] = head->next;
+    head->next = 0;
+    ready_tail[prio]->next = head;
+    ready_tail[prio] = head;
+}
+
+/* Index of the lowest set bit in five fixed steps (no CTZ, no multiply).
+ * The idle task keeps the mask non-zero. */
+static uint32_t lowest_set_bit(uint32_t mask)
+{
+    uint32_t bit = 0;
+
+    if (!(mask & 0xFFFFu)) {
+        bit += 16;
+        mask >>= 16;
+    }
+    if (!(mask & 0xFFu)) {
+        bit += 8;
+        mask >>= 8;
+    }
+    if (!(mask & 0xFu)) {
+        bit += 4;
+        mask >>= 4;
+    }
+    if (!(mask & 0x3u)) {
+        bit += 2;
+        mask >>= 2;
+    }
+    if (!(mask & 0x1u))
+        bit += 1;
+    return bit;
+}
+
+/* Enter the trap path; the frame records MIE as it is now */
+static inline void sched_switch(void)
+{
+    __asm__ volatile ("ecall" ::: "memory");
+}
+
+/* Sleeping tasks form a delta list: each entry stores the ticks after its
+ * predecessor, so the tick only ever looks at the head. */
+static void sched_tick(void)
+{
+    tick_count++;
+    if (delay_head) {
+        delay_head->delay--;
+        while (delay_head && delay_head->delay == 0) {
+            qar_task_t *task = delay_head;
+            delay_head = task->next;
+            ready_push(task);
+        }
+    }
+    /* Round robin among tasks sharing the running priority */
+    if (current->state == QAR_TASK_READY)
+        ready_rotate(current->priority);
+}
+
+uint32_t *qar_sched_dispatch(uint32_t mcause, uint32_t *frame)
+{
+    current->sp = frame;
+    in_trap = 1;
+
+    if (mcause == MCAUSE_TIMER_IRQ) {
+        /* The parked mtimecmp compare can also raise MTIP; only count
+         * CMP0 matches. */
+        if (QAR_TIMER_STATUS(SCHED_TIMER) & QAR_TIMER_STATUS_CMP0) {
+            qar_timer_clear_status(SCHED_TIMER, QAR_TIMER_STATUS_CMP0);
+            sched_tick();
+        }
+    } else if (mcause == MCAUSE_EXT_IRQ) {
+        qar_sched_external_irq();
+    } else if (mcause == MCAUSE_ECALL) {
+        frame[FRAME_MEPC] += 4;
+    } else {
+        qar_sched_fault(mcause, frame);
+    }
+
+    in_trap = 0;
+    current = ready_head[lowest_set_bit(ready_mask)];
+    return current->sp;
+}
+
+__attribute__((weak)) void qar_sched_external_irq(void)
+{
+}
+
+__attribute__((weak)) void qar_sched_fault(uint32_t mcause, uint32_t *frame)
+{
+    (void)mcause;
+    (void)frame;
+    while (1)
+        ;
+}
+
+static void task_exit(void)
+{
+    qar_irq_save();
+    ready_pop_current();
+    current->state = QAR_TASK_DEAD;
+    sched_switch();
+    while (1)
+        ;
+}
+
+static void idle_entry(void *arg)
+{
+    (void)arg;
+    while (1)
+        qar_wait_for_interrupt();
+}
+
+void qar_task_create(qar_task_t *task, qar_task_fn entry, void *arg,
+                     uint32_t *stack, uint32_t stack_words, uint32_t priority)
+{
+    uint32_t *frame = stack + (stack_words & ~3u) - QAR_SCHED_FRAME_WORDS;
+    uint32_t i;
+
+    for (i = 0; i < QAR_SCHED_FRAME_WORDS; i++)
+        frame[i] = 0;
+    frame[FRAME_MEPC] = (uint32_t)(uintptr_t)entry;
+    frame[FRAME_RA] = (uint32_t)(uintptr_t)task_exit;
+    frame[FRAME_A0] = (uint32_t)(uintptr_t)arg;
+    frame[FRAME_MSTATUS] = MSTATUS_MPIE;    /* interrupts on after MRET */
+
+    if (priority > QAR_SCHED_IDLE_PRIORITY)
+        priority = QAR_SCHED_IDLE_PRIORITY;
+    task->sp = frame;
+    task->delay = 0;
+    task->events = 0;
+    task->wait_mask = 0;
+    task->priority = priority;
+    ready_push(task);
+}
+
+void qar_sched_start(uint32_t tick_cycles)
+{
+    qar_irq_save();
+    qar_task_create(&idle_task, idle_entry, 0, idle_stack, QAR_TASK_MIN_STACK_WORDS,
+                    QAR_SCHED_IDLE_PRIORITY);
+
+    __asm__ volatile ("csrw mtvec, %0" :: "r"(qar_sched_trap_entry));
+    /* Park the mtime/mtimecmp compare (it shares MTIP with TIMER0) */
+    __asm__ volatile ("csrw 0x720, %0" :: "r"(0xFFFFFFFFu));
+    __asm__ volatile ("csrw 0x701, x0");
+
+    qar_timer_clear_status(SCHED_TIMER, QAR_TIMER_STATUS_CMP0);
+    qar_timer_set_compare0(SCHED_TIMER, qar_timer_counter(SCHED_TIMER) + tick_cycles, tick_cycles);
+    qar_timer_enable_irq(SCHED_TIMER, QAR_TIMER_STATUS_CMP0);
+    QAR_TIMER_CTRL(SCHED_TIMER) |= QAR_TIMER_CTRL_ENABLE | QAR_TIMER_CTRL_CMP0_AUTO;
+    qar_irq_enable_sources(QAR_MIE_MTIE);
+
+    current = ready_head[lowest_set_bit(ready_mask)];
+    qar_sched_resume(current->sp);
+}
+
+qar_task_t *qar_task_self(void)
+{
+    return current;
+}
+
+uint32_t qar_sched_ticks(void)
+{
+    return tick_count;
+}
+
+void qar_task_yield(void)
+{
+    uint32_t irq = qar_irq_save();
+
+    ready_rotate(current->priority);
+    sched_switch();
+    qar_irq_restore(irq);
+}
+
+void qar_task_sleep(uint32_t ticks)
+{
+    qar_task_t **link = &delay_head;
+    uint32_t irq;
+
+    if (ticks == 0) {
+        qar_task_yield();
+        return;
+    }
+
+    irq = qar_irq_save();
+    ready_pop_current();
+    current->state = QAR_TASK_SLEEPING;
+    while (*link && (*link)->delay <= ticks) {
+        ticks -= (*link)->delay;
+        link = &(*link)->next;
+    }
+    current->delay = ticks;
+    current->next = *link;
+    if (*link)
+        (*link)->delay -= ticks;
+    *link = current;
+    sched_switch();
+    qar_irq_restore(irq);
+}
+
+uint32_t qar_event_wait(uint32_t mask)
+{
+    uint32_t irq = qar_irq_save();
+    uint32_t hit = current->events & mask;
+
+    if (!hit) {
+        current->wait_mask = mask;
+        ready_pop_current();
+        current->state = QAR_TASK_WAITING;
+        sched_switch();
+        hit = current->events & mask;
+    }
+    current->events &= ~hit;
+    qar_irq_restore(irq);
+    return hit;
+}
+
+void qar_event_post(qar_task_t *task, uint32_t bits)
+{
+    uint32_t irq = qar_irq_save();
+
+    task->events |= bits;
+    if (task->state == QAR_TASK_WAITING && (task->events & task->wait_mask)) {
+        task->wait_mask = 0;
+        ready_push(task);
+        /* From an ISR the dispatcher picks the new task on the way out */
+        if (!in_trap && current && task->priority < current->priority)
+            sched_switch();
+    }
+    qar_irq_restore(irq);
+}
@@ -0,0 +1,101 @@
+#ifndef QAR_SDK_SCHED_H
+#define QAR_SDK_SCHED_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Preemptive priority scheduler (seed of the qar-os kernel).
+ *
+ * Tasks live in caller-provided static storage; there is no heap. Each
+ * priority has a FIFO ready queue and a bit in a ready mask, so picking
+ * the next task and posting an event are O(1). Priority 0 is the most
+ * urgent; QAR_SCHED_IDLE_PRIORITY is taken by the built-in idle task,
+ * which sleeps in WFI.
+ *
+ * The tick is TIMER0 CMP0 in auto-reload mode (QAR_TIMER_CTRL_CMP0_AUTO),
+ * taken as the machine timer interrupt. Every trap enters
+ * qar_sched_trap_entry (sched_switch.S): the full context is pushed on the
+ * running task's stack, qar_sched_dispatch() updates the queues and
+ * returns the stack of the task to resume. Kernel calls from task context
+ * run with MIE masked and use ECALL to switch, so MIE is part of each
+ * task's saved context.
+ *
+ * Link with `qarsim build --c app.c --sched`.
+ */
+
+#ifndef QAR_SCHED_PRIORITIES
+#define QAR_SCHED_PRIORITIES 8u            /* at most 32 */
+#endif
+#define QAR_SCHED_IDLE_PRIORITY (QAR_SCHED_PRIORITIES - 1u)
+
+/* Trap frame (32 words) plus the dispatcher's own stack use */
+#define QAR_SCHED_FRAME_WORDS     32u
+#define QAR_TASK_MIN_STACK_WORDS  64u
+
+#define QAR_TASK_READY    0u
+#define QAR_TASK_SLEEPING 1u
+#define QAR_TASK_WAITING  2u
+#define QAR_TASK_DEAD     3u
+
+typedef struct qar_task {
+    uint32_t *sp;               /* saved context; must stay first (sched_switch.S) */
+    struct qar_task *next;      /* ready queue or delay list link */
+    uint32_t delay;             /* ticks after the previous delay-list entry */
+    volatile uint32_t events;   /* posted, not yet consumed */
+    uint32_t wait_mask;
+    uint32_t priority;
+    uint32_t state;
+} qar_task_t;
+
+/* Stack storage for a task: 16-byte aligned, size in words (multiple of 4) */
+#define QAR_TASK_STACK(name, words) \
+    static uint32_t name[(words)] __attribute__((aligned(16)))
+
+typedef void (*qar_task_fn)(void *arg);
+
+/* Task setup happens before qar_sched_start(); returning from entry ends
+ * the task. */
+void qar_task_create(qar_task_t *task, qar_task_fn entry, void *arg,
+                     uint32_t *stack, uint32_t stack_words, uint32_t priority);
+
+/* Program TIMER0 for a tick every tick_cycles, install the trap entry and
+ * switch to the most urgent task. Does not return. */
+void qar_sched_start(uint32_t tick_cycles) __attribute__((noreturn));
+
+qar_task_t *qar_task_self(void);
+uint32_t qar_sched_ticks(void);
+
+/* Move to the back of this priority's ready queue */
+void qar_task_yield(void);
+
+/* Block for `ticks` scheduler ticks (0 behaves like qar_task_yield()) */
+void qar_task_sleep(uint32_t ticks);
+
+/* Block until one of the bits in mask has been posted; returns the matching
+ * bits and clears them. */
+uint32_t qar_event_wait(uint32_t mask);
+
+/* Set event bits on a task. Safe from ISRs (the qar_sched_external_irq()
+ * hook) and from tasks; a woken task that outranks the running one runs
+ * as soon as the caller returns from the ISR or immediately from a task. */
+void qar_event_post(qar_task_t *task, uint32_t bits);
+
+/* Hooks, both weak. qar_sched_external_irq() runs for machine external
+ * interrupts (enable them with qar_irq_enable_sources(QAR_MIE_MEIE)) and
+ * must clear its source; qar_sched_fault() runs for exceptions other than
+ * ECALL and by default stops in a loop. */
+void qar_sched_external_irq(void);
+void qar_sched_fault(uint32_t mcause, uint32_t *frame);
+
+/* Internal: called from sched_switch.S */
+uint32_t *qar_sched_dispatch(uint32_t mcause, uint32_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QAR_SDK_SCHED_H */
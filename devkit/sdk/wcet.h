@@ -0,0 +1,44 @@
+#ifndef QAR_SDK_WCET_H
+#define QAR_SDK_WCET_H
+
+/*
+ * Loop bounds for `qarsim wcet`, the static cycle estimator.
+ *
+ * QAR_LOOP_BOUND(n) at the top of a loop body states that the loop runs
+ * at most n iterations each time it is entered. It emits no code: the
+ * address and n go to the non-loaded .qar.wcet section, which elf2qar
+ * copies into the symbol map as "B" lines. An annotation belongs to the
+ * innermost loop around it; n must be a compile-time constant.
+ *
+ *     while (qar_uart_available(UART_BASE)) {
+ *         QAR_LOOP_BOUND(QAR_UART_FIFO_DEPTH);
+ *         qar_ringbuf_push(&rx_queue, qar_uart_read(UART_BASE));
+ *     }
+ *
+ * Assembly sources use the QAR_LOOP_BOUND macro the same way:
+ *
+ *     2:  QAR_LOOP_BOUND 16
+ */
+
+#ifdef __ASSEMBLER__
+
+    .macro QAR_LOOP_BOUND n
+.Lqar_loop_bound\@:
+    .pushsection .qar.wcet, "", @progbits
+    .balign 4
+    .word .Lqar_loop_bound\@, \n
+    .popsection
+    .endm
+
+#else
+
+#define QAR_LOOP_BOUND(n)                                          \
+    __asm__ volatile(".Lqar_loop_bound%=:\n\t"                     \
+                     ".pushsection .qar.wcet, \"\", @progbits\n\t" \
+                     ".balign 4\n\t"                               \
+                     ".word .Lqar_loop_bound%=, %c0\n\t"           \
+                     ".popsection" :: "i"(n))
+
+#endif
+
+#endif /* QAR_SDK_WCET_H */
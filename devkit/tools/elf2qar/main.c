@@ -37,8 +37,37 @@ typedef struct {
     uint32_t p_align;
 } Elf32_Phdr;
 
+typedef struct {
+    uint32_t sh_name;
+    uint32_t sh_type;
+    uint32_t sh_flags;
+    uint32_t sh_addr;
+    uint32_t sh_offset;
+    uint32_t sh_size;
+    uint32_t sh_link;
+    uint32_t sh_info;
+    uint32_t sh_addralign;
+    uint32_t sh_entsize;
+} Elf32_Shdr;
+
+typedef struct {
+    uint32_t st_name;
+    uint32_t st_value;
+    uint32_t st_size;
+    unsigned char st_info;
+    unsigned char st_other;
+    uint16_t st_shndx;
+} Elf32_Sym;
+
 #define PT_LOAD 1
+#define SHT_SYMTAB 2
+#define SHN_UNDEF 0
+#define SHN_ABS 0xfff1u
+#define STT_NOTYPE 0
+#define STT_OBJECT 1
+#define STT_FUNC 2
 #define EM_RISCV 243
+#define EF_RISCV_RVC 0x0001u
 
 typedef struct {
     uint32_t base_addr;
@@ -50,7 +79,9 @@ typedef struct {
 static void usage(const char *prog) {
     fprintf(stderr,
             "Usage: %s --elf <input.elf> --program program.hex --data data.hex "
-            "[--imem 64] [--dmem 64]\n",
+            "[--imem 64] [--dmem 64] [--rvc] [--symbols firmware.sym]\n"
+            "  --rvc      accept compressed (RV32C) code; the core must be built with RVC_ENABLE=1\n"
+            "  --symbols  write the function/object symbol map read by `qarsim profile`\n",
             prog);
     exit(1);
 }
@@ -66,12 +97,13 @@ static void image_init(image_t *img, uint32_t base, uint32_t size_words) {
     }
 }
 
-static void image_store(image_t *img, uint32_t addr, const uint8_t *data, uint32_t len) {
+static int image_store(image_t *img, uint32_t addr, const uint8_t *data, uint32_t len) {
     if (addr < img->base_addr || addr + len > img->base_addr + img->size_words * 4) {
-        return;
+        return 0;
     }
     uint32_t offset = addr - img->base_addr;
     memcpy(img->buffer + offset, data, len);
+    return 1;
 }
 
 static void image_write_hex(const image_t *img, const char *path) {
@@ -91,12 +123,150 @@ static void image_write_hex(const image_t *img, const char *path) {
     fclose(out);
 }
 
+typedef struct {
+    uint32_t addr;
+    uint32_t size;
+    char type;
+    const char *name;
+} symbol_t;
+
+static int symbol_cmp(const void *a, const void *b) {
+    const symbol_t *sa = (const symbol_t *)a;
+    const symbol_t *sb = (const symbol_t *)b;
+    if (sa->addr != sb->addr) {
+        return sa->addr < sb->addr ? -1 : 1;
+    }
+    /* A sized symbol wins over a bare label at the same address */
+    if (sa->size != sb->size) {
+        return sa->size > sb->size ? -1 : 1;
+    }
+    return strcmp(sa->name, sb->name);
+}
+
+static void *read_block(FILE *elf, uint32_t offset, uint32_t size, const char *what) {
+    uint8_t *buf = (uint8_t *)malloc(size ? size : 1);
+    if (!buf) {
+        fprintf(stderr, "elf2qar: out of memory\n");
+        exit(1);
+    }
+    if (fseek(elf, offset, SEEK_SET) != 0 || fread(buf, 1, size, elf) != size) {
+        fprintf(stderr, "elf2qar: failed to read %s\n", what);
+        exit(1);
+    }
+    return buf;
+}
+
+/* One line per function (F), data object (O) or untyped assembly label (N),
+ * sorted by address: "addr size type name". The program headers carry no
+ * names, so this reads .symtab and its string table from the section
+ * headers. Sections, files, ".L" locals and "$x"/"$d" mapping symbols are
+ * dropped. Loop bounds from QAR_LOOP_BOUND() (sdk/wcet.h), address/bound
+ * word pairs in the non-loaded .qar.wcet section, become B lines with the
+ * bound in the size column. */
+static void write_symbols(FILE *elf, const Elf32_Ehdr *ehdr, const char *elf_path, const char *path) {
+    if (ehdr->e_shoff == 0 || ehdr->e_shnum == 0 || ehdr->e_shentsize != sizeof(Elf32_Shdr)) {
+        fprintf(stderr, "elf2qar: %s has no section headers\n", elf_path);
+        exit(1);
+    }
+    Elf32_Shdr *shdrs = (Elf32_Shdr *)read_block(elf, ehdr->e_shoff,
+                                                 ehdr->e_shnum * (uint32_t)sizeof(Elf32_Shdr),
+                                                 "section headers");
+    const Elf32_Shdr *symtab = NULL;
+    const Elf32_Shdr *bounds = NULL;
+    char *shstrs = NULL;
+    uint32_t shstrs_size = 0;
+    if (ehdr->e_shstrndx < ehdr->e_shnum) {
+        const Elf32_Shdr *shstrtab = &shdrs[ehdr->e_shstrndx];
+        shstrs = (char *)read_block(elf, shstrtab->sh_offset, shstrtab->sh_size, "section names");
+        shstrs_size = shstrtab->sh_size;
+    }
+    for (uint16_t i = 0; i < ehdr->e_shnum; ++i) {
+        if (shdrs[i].sh_type == SHT_SYMTAB && !symtab) {
+            symtab = &shdrs[i];
+        }
+        if (shstrs && shdrs[i].sh_name < shstrs_size &&
+            strncmp(shstrs + shdrs[i].sh_name, ".qar.wcet", shstrs_size - shdrs[i].sh_name) == 0) {
+            bounds = &shdrs[i];
+        }
+    }
+    if (!symtab || symtab->sh_link >= ehdr->e_shnum) {
+        fprintf(stderr, "elf2qar: %s has no symbol table (was it stripped?)\n", elf_path);
+        exit(1);
+    }
+    const Elf32_Shdr *strtab = &shdrs[symtab->sh_link];
+    Elf32_Sym *syms = (Elf32_Sym *)read_block(elf, symtab->sh_offset, symtab->sh_size, "symbol table");
+    char *strs = (char *)read_block(elf, strtab->sh_offset, strtab->sh_size, "string table");
+    uint32_t count = symtab->sh_size / (uint32_t)sizeof(Elf32_Sym);
+    uint32_t bound_count = bounds ? bounds->sh_size / 8u : 0;
+    uint32_t *bound_words = bound_count ? (uint32_t *)read_block(elf, bounds->sh_offset, bound_count * 8u, "loop bounds")
+                                        : NULL;
+
+    symbol_t *out = (symbol_t *)calloc((count + bound_count) ? count + bound_count : 1, sizeof(symbol_t));
+    if (!out) {
+        fprintf(stderr, "elf2qar: out of memory\n");
+        exit(1);
+    }
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const Elf32_Sym *sym = &syms[i];
+        unsigned type = sym->st_info & 0xfu;
+        if (sym->st_name >= strtab->sh_size || sym->st_shndx == SHN_UNDEF) {
+            continue;
+        }
+        const char *name = strs + sym->st_name;
+        if (name[0] == '\0' || name[0] == '$' || strncmp(name, ".L", 2) == 0) {
+            continue;
+        }
+        if (type == STT_FUNC) {
+            out[kept].type = 'F';
+        } else if (type == STT_OBJECT) {
+            out[kept].type = 'O';
+        } else if (type == STT_NOTYPE && sym->st_shndx != SHN_ABS) {
+            out[kept].type = 'N';
+        } else {
+            continue;
+        }
+        out[kept].addr = sym->st_value;
+        out[kept].size = sym->st_size;
+        out[kept].name = name;
+        ++kept;
+    }
+    for (uint32_t i = 0; i < bound_count; ++i) {
+        out[kept].addr = bound_words[2 * i];
+        out[kept].size = bound_words[2 * i + 1];
+        out[kept].type = 'B';
+        out[kept].name = "loop_bound";
+        ++kept;
+    }
+    qsort(out, kept, sizeof(symbol_t), symbol_cmp);
+
+    FILE *map = fopen(path, "w");
+    if (!map) {
+        fprintf(stderr, "elf2qar: failed to open %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    fprintf(map, "# qar symbols: addr size type name\n");
+    for (uint32_t i = 0; i < kept; ++i) {
+        fprintf(map, "%08x %u %c %s\n", out[i].addr, out[i].size, out[i].type, out[i].name);
+    }
+    fclose(map);
+
+    free(out);
+    free(bound_words);
+    free(shstrs);
+    free(strs);
+    free(syms);
+    free(shdrs);
+}
+
 int main(int argc, char **argv) {
     const char *elf_path = NULL;
     const char *program_hex = "program.hex";
     const char *data_hex = "data.hex";
+    const char *symbols_path = NULL;
     uint32_t imem_words = 64;
     uint32_t dmem_words = 64;
+    int allow_rvc = 0;
 
     for (int i = 1; i < argc; ++i) {
         if (strcmp(argv[i], "--elf") == 0) {
@@ -114,6 +284,11 @@ int main(int argc, char **argv) {
         } else if (strcmp(argv[i], "--dmem") == 0) {
             if (++i >= argc) usage(argv[0]);
             dmem_words = (uint32_t)strtoul(argv[i], NULL, 0);
+        } else if (strcmp(argv[i], "--rvc") == 0) {
+            allow_rvc = 1;
+        } else if (strcmp(argv[i], "--symbols") == 0) {
+            if (++i >= argc) usage(argv[0]);
+            symbols_path = argv[i];
         } else {
             usage(argv[0]);
         }
@@ -147,6 +322,13 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    if ((ehdr.e_flags & EF_RISCV_RVC) && !allow_rvc) {
+        fprintf(stderr, "elf2qar: %s contains compressed (RVC) code; pass --rvc "
+                        "and build the core with RVC_ENABLE=1\n", elf_path);
+        fclose(elf);
+        return 1;
+    }
+
     image_t imem, dmem;
     image_init(&imem, 0x00000000u, imem_words);
     image_init(&dmem, 0x00000000u, dmem_words);
@@ -188,12 +370,31 @@ int main(int argc, char **argv) {
         }
         fseek(elf, curr, SEEK_SET);
 
+        /* .text and .rodata both live below DMEM and stay in program.hex;
+         * the core reads constants there through its IMEM data port. */
+        int stored;
         if (phdr.p_vaddr < 0x20000000u) {
-            image_store(&imem, phdr.p_vaddr, segment, phdr.p_filesz);
+            stored = image_store(&imem, phdr.p_vaddr, segment, phdr.p_filesz);
         } else {
-            image_store(&dmem, phdr.p_vaddr - 0x20000000u, segment, phdr.p_filesz);
+            stored = image_store(&dmem, phdr.p_vaddr - 0x20000000u, segment, phdr.p_filesz);
+        }
+        /* An initialized-data segment linked 'AT > IMEM' also gets its load
+         * image in program.hex, which crt0 copies after a reset. */
+        if (stored && phdr.p_paddr != phdr.p_vaddr && phdr.p_paddr < 0x20000000u) {
+            stored = image_store(&imem, phdr.p_paddr, segment, phdr.p_filesz);
         }
         free(segment);
+        if (!stored) {
+            fprintf(stderr, "elf2qar: segment at 0x%08x (%u bytes) does not fit %s\n",
+                    phdr.p_vaddr, phdr.p_filesz,
+                    phdr.p_vaddr < 0x20000000u ? "IMEM" : "DMEM");
+            fclose(elf);
+            return 1;
+        }
+    }
+
+    if (symbols_path) {
+        write_symbols(elf, &ehdr, elf_path, symbols_path);
     }
 
     fclose(elf);
@@ -0,0 +1,40 @@
+// Runs the hand-written qar_sdk_init() (devkit/sdk/hal_init.c) on the host
+// and prints every MMIO store as "addr value", one per line, in order.
+// scripts/check_periphinit.sh compares the output with `qarsim periphinit`
+// so the generated init tables cannot drift from the C sequences.
+#include <cstdint>
+#include <cstdio>
+#include <map>
+
+namespace {
+
+std::map<uint32_t, uint32_t> regs;
+
+// Stands in for a volatile register: stores are logged, loads return the
+// last value stored (0 before that).
+struct HostReg {
+    uint32_t addr;
+
+    HostReg &operator=(uint32_t value)
+    {
+        std::printf("0x%08X 0x%08X\n", addr, value);
+        regs[addr] = value;
+        return *this;
+    }
+    HostReg &operator|=(uint32_t value) { return *this = regs[addr] | value; }
+    HostReg &operator&=(uint32_t value) { return *this = regs[addr] & value; }
+    HostReg &operator^=(uint32_t value) { return *this = regs[addr] ^ value; }
+    operator uint32_t() const { return regs[addr]; }
+};
+
+} // namespace
+
+#define QAR_MMIO32(base, offset) (HostReg{static_cast<uint32_t>((uintptr_t)(base) + (offset))})
+
+#include "sdk/hal_init.c"
+
+int main()
+{
+    qar_sdk_init();
+    return 0;
+}
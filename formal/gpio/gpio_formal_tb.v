@@ -45,6 +45,7 @@ module gpio_formal_tb;
         .gpio_in(gpio_in),
         .alt_pwm0(alt_pwm0),
         .alt_pwm1(alt_pwm1),
+        .seq_tick(1'b0),
         .gpio_out(gpio_out),
         .gpio_dir(gpio_dir),
         .irq(irq)
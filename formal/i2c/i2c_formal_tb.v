@@ -70,7 +70,7 @@ module i2c_formal_tb;
         end
     end
 
-    wire irq_expected = |(m_irq_en[5:0] & m_irq_status[5:0]);
+    wire irq_expected = |(m_irq_en[6:0] & m_irq_status[6:0]);
 
     always @(posedge clk) begin
         if (rst_n && got_init) begin
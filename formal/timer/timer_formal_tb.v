@@ -41,7 +41,13 @@ module timer_formal_tb;
         .rdata(rdata),
         .irq(irq),
         .pwm0(pwm0),
-        .pwm1(pwm1)
+        .pwm1(pwm1),
+        .evt_cmp0(),
+        .evt_cmp1(),
+        .trig_capture0(1'b0),
+        .trig_capture1(1'b0),
+        .trig_pwm_update(1'b0),
+        .cap_in(32'b0)
     );
 
     // Model registers when timer is halted.
@@ -113,9 +119,9 @@ module timer_formal_tb;
                             m_wdt_counter <= m_wdt_load;
                     end
                     6'hC: m_pwm0_period <= wdata;
-                    6'hD: m_pwm0_duty <= wdata;
+                    6'hD: if (!m_ctrl[3]) m_pwm0_duty <= wdata; // PWM_SYNC defers to shadow
                     6'hE: m_pwm1_period <= wdata;
-                    6'hF: m_pwm1_duty <= wdata;
+                    6'hF: if (!m_ctrl[3]) m_pwm1_duty <= wdata;
                     6'h11: begin
                         m_capture_ctrl <= wdata;
                         if (wdata[0]) begin
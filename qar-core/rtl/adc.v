@@ -3,7 +3,8 @@
 module qar_adc #(
     parameter integer CHANNELS = 4,
     parameter integer WIDTH    = 12,
-    parameter integer CONV_LATENCY = 8
+    parameter integer CONV_LATENCY = 8,
+    parameter integer FIFO_DEPTH = 16
 ) (
     input  wire                     clk,
     input  wire                     rst_n,
@@ -16,10 +17,26 @@ module qar_adc #(
     input  wire [WIDTH-1:0]         ch1,
     input  wire [WIDTH-1:0]         ch2,
     input  wire [WIDTH-1:0]         ch3,
-    output wire                     irq
+    output wire                     irq,
+    input  wire                     trig_start,
+    output reg                      evt_done,
+    output reg                      evt_window
 );
 
+    function integer clog2;
+        input integer value;
+        integer i;
+        begin
+            value = value - 1;
+            for (i = 0; value > 0; i = i + 1)
+                value = value >> 1;
+            clog2 = i;
+        end
+    endfunction
+
     localparam integer CH_BITS = 2;
+    localparam integer FIFO_ADDR_BITS = clog2(FIFO_DEPTH);
+    localparam integer ACC_WIDTH = WIDTH + 7;
 
     reg        ctrl_enable;
     reg        ctrl_continuous;
@@ -44,6 +61,42 @@ module qar_adc #(
     reg [31:0] irq_en;
     reg [31:0] irq_status;
 
+    // Oversampling: 2^os_shift back-to-back conversions per channel slot.
+    reg [2:0]           os_shift;
+    reg [6:0]           os_count;
+    reg [ACC_WIDTH-1:0] os_acc;
+
+    // Sample FIFO of {channel, value} entries.
+    reg                      fifo_enable;
+    reg [FIFO_ADDR_BITS:0]   fifo_watermark;
+    reg                      fifo_overflow;
+    reg [FIFO_ADDR_BITS:0]   fifo_head, fifo_tail;
+    reg [CH_BITS+WIDTH-1:0]  fifo_mem [0:FIFO_DEPTH-1];
+
+    // Window comparators: low/high thresholds and current zone per channel.
+    reg [WIDTH-1:0]    win_low  [0:CHANNELS-1];
+    reg [WIDTH-1:0]    win_high [0:CHANNELS-1];
+    reg [CHANNELS-1:0] win_enable;
+    reg [CHANNELS-1:0] win_below;
+    reg [CHANNELS-1:0] win_above;
+    reg [CHANNELS-1:0] win_below_hit;
+    reg [CHANNELS-1:0] win_above_hit;
+
+    wire [FIFO_ADDR_BITS:0] fifo_level = fifo_head - fifo_tail;
+    wire fifo_empty = (fifo_head == fifo_tail);
+    wire fifo_full  = (fifo_level == FIFO_DEPTH);
+    wire fifo_at_watermark = (fifo_level >= fifo_watermark) && !fifo_empty;
+    wire [4:0] fifo_watermark_field = fifo_watermark;
+    wire [7:0] fifo_level_field = fifo_level;
+    wire [CH_BITS+WIDTH-1:0] fifo_head_entry = fifo_mem[fifo_tail[FIFO_ADDR_BITS-1:0]];
+
+    wire [6:0] os_last = (7'd1 << os_shift) - 7'd1;
+    wire [ACC_WIDTH-1:0] os_sum = os_acc + {{(ACC_WIDTH-WIDTH){1'b0}}, sample_hold};
+    wire [ACC_WIDTH-1:0] os_avg = os_sum >> os_shift;
+    wire [WIDTH-1:0] conv_value = os_avg[WIDTH-1:0];
+    wire conv_below = conv_value < win_low[active_channel];
+    wire conv_above = conv_value > win_high[active_channel];
+
     wire [15:0] effective_sample_div = (sample_div == 16'd0) ? 16'd1 : sample_div;
     wire continuous_ready = ctrl_enable && ctrl_continuous && (seq_mask != 0);
 
@@ -104,6 +157,8 @@ module qar_adc #(
         end
     endfunction
 
+    integer w;
+
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             ctrl_enable          <= 1'b0;
@@ -124,7 +179,29 @@ module qar_adc #(
             data_overrun         <= 1'b0;
             irq_en               <= 32'b0;
             irq_status           <= 32'b0;
+            evt_done             <= 1'b0;
+            evt_window           <= 1'b0;
+            os_shift             <= 3'd0;
+            os_count             <= 7'd0;
+            os_acc               <= {ACC_WIDTH{1'b0}};
+            fifo_enable          <= 1'b0;
+            fifo_watermark       <= 1;
+            fifo_overflow        <= 1'b0;
+            fifo_head            <= 0;
+            fifo_tail            <= 0;
+            win_enable           <= {CHANNELS{1'b0}};
+            win_below            <= {CHANNELS{1'b0}};
+            win_above            <= {CHANNELS{1'b0}};
+            win_below_hit        <= {CHANNELS{1'b0}};
+            win_above_hit        <= {CHANNELS{1'b0}};
+            for (w = 0; w < CHANNELS; w = w + 1) begin
+                win_low[w]  <= {WIDTH{1'b0}};
+                win_high[w] <= {WIDTH{1'b1}};
+            end
         end else begin
+            evt_done   <= 1'b0;
+            evt_window <= 1'b0;
+
             if (bus_write) begin
                 case (addr_word)
                     5'h0: begin
@@ -147,6 +224,34 @@ module qar_adc #(
                         seq_channel <= first_channel(wdata[CHANNELS-1:0]);
                     end
                     5'h6: sample_div <= wdata[15:0];
+                    5'h8: begin
+                        fifo_enable <= wdata[0];
+                        fifo_watermark <= (wdata[12:8] == 5'd0) ? 1 : wdata[FIFO_ADDR_BITS+8:8];
+                        if (wdata[1])
+                            fifo_tail <= fifo_head;
+                    end
+                    5'h9: begin
+                        if (wdata[10])
+                            fifo_overflow <= 1'b0;
+                    end
+                    5'hA: begin
+                        os_shift <= wdata[2:0];
+                        os_count <= 7'd0;
+                        os_acc   <= {ACC_WIDTH{1'b0}};
+                    end
+                    5'hB: begin
+                        win_enable <= wdata[CHANNELS-1:0];
+                        win_below  <= win_below & wdata[CHANNELS-1:0];
+                        win_above  <= win_above & wdata[CHANNELS-1:0];
+                    end
+                    5'hC: begin
+                        win_below_hit <= win_below_hit & ~wdata[CHANNELS-1:0];
+                        win_above_hit <= win_above_hit & ~wdata[CHANNELS+3:4];
+                    end
+                    5'hD, 5'hE, 5'hF, 5'h10: begin
+                        win_low[addr_word - 5'hD]  <= wdata[WIDTH-1:0];
+                        win_high[addr_word - 5'hD] <= wdata[WIDTH+15:16];
+                    end
                     default: ;
                 endcase
             end
@@ -156,6 +261,12 @@ module qar_adc #(
                 irq_status[0] <= 1'b0;
             end
 
+            if (bus_read && addr_word == 5'h7 && !fifo_empty)
+                fifo_tail <= fifo_tail + 1;
+
+            if (trig_start)
+                manual_start_pending <= 1'b1;
+
             if (!ctrl_continuous)
                 sample_counter <= 16'd0;
 
@@ -185,16 +296,51 @@ module qar_adc #(
                     sample_counter <= 16'd0;
                 end
             end else begin
-                if (conv_counter >= (CONV_LATENCY - 1)) begin
+                if (conv_counter >= (CONV_LATENCY - 1) && os_count != os_last) begin
+                    // Accumulate and convert the same channel again.
+                    os_acc       <= os_sum;
+                    os_count     <= os_count + 1'b1;
+                    sample_hold  <= channel_value(active_channel);
+                    conv_counter <= 8'd0;
+                end else if (conv_counter >= (CONV_LATENCY - 1)) begin
                     busy         <= 1'b0;
-                    result_value <= sample_hold;
+                    os_acc       <= {ACC_WIDTH{1'b0}};
+                    os_count     <= 7'd0;
+                    result_value <= conv_value;
                     result_channel <= active_channel;
-                    if (data_valid) begin
-                        data_overrun <= 1'b1;
-                        irq_status[1] <= 1'b1;
+                    evt_done     <= 1'b1;
+                    if (fifo_enable) begin
+                        if (!fifo_full) begin
+                            fifo_mem[fifo_head[FIFO_ADDR_BITS-1:0]] <= {active_channel, conv_value};
+                            fifo_head <= fifo_head + 1;
+                            if ((fifo_level + 1'b1) >= fifo_watermark)
+                                irq_status[2] <= 1'b1;
+                        end else begin
+                            fifo_overflow <= 1'b1;
+                            irq_status[3] <= 1'b1;
+                        end
+                    end else begin
+                        if (data_valid) begin
+                            data_overrun <= 1'b1;
+                            irq_status[1] <= 1'b1;
+                        end
+                        data_valid   <= 1'b1;
+                        irq_status[0] <= 1'b1;
+                    end
+                    if (win_enable[active_channel]) begin
+                        win_below[active_channel] <= conv_below;
+                        win_above[active_channel] <= conv_above;
+                        if (conv_below && !win_below[active_channel]) begin
+                            win_below_hit[active_channel] <= 1'b1;
+                            irq_status[4] <= 1'b1;
+                            evt_window <= 1'b1;
+                        end
+                        if (conv_above && !win_above[active_channel]) begin
+                            win_above_hit[active_channel] <= 1'b1;
+                            irq_status[4] <= 1'b1;
+                            evt_window <= 1'b1;
+                        end
                     end
-                    data_valid   <= 1'b1;
-                    irq_status[0] <= 1'b1;
                     conv_counter <= 8'd0;
                 end else begin
                     conv_counter <= conv_counter + 1;
@@ -214,6 +360,13 @@ module qar_adc #(
                 5'h4: rdata = irq_status;
                 5'h5: rdata = {28'b0, seq_mask};
                 5'h6: rdata = {16'b0, sample_div};
+                5'h7: rdata = {!fifo_empty, 11'b0, {(4-CH_BITS){1'b0}}, fifo_head_entry[CH_BITS+WIDTH-1:WIDTH], 4'b0, fifo_head_entry[WIDTH-1:0]};
+                5'h8: rdata = {19'b0, fifo_watermark_field, 7'b0, fifo_enable};
+                5'h9: rdata = {21'b0, fifo_overflow, fifo_at_watermark, fifo_empty, fifo_level_field};
+                5'hA: rdata = {29'b0, os_shift};
+                5'hB: rdata = {{(32-CHANNELS){1'b0}}, win_enable};
+                5'hC: rdata = {16'b0, win_above, win_below, win_above_hit, win_below_hit};
+                5'hD, 5'hE, 5'hF, 5'h10: rdata = {{(16-WIDTH){1'b0}}, win_high[addr_word - 5'hD], {(16-WIDTH){1'b0}}, win_low[addr_word - 5'hD]};
                 default: rdata = 32'b0;
             endcase
         end
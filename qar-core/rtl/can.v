@@ -10,7 +10,8 @@ module qar_can #(
     input  wire [5:0]  addr_word,
     input  wire [31:0] wdata,
     output reg  [31:0] rdata,
-    output wire        irq
+    output wire        irq,
+    output reg         evt_rx
 );
 
     reg [31:0] ctrl;
@@ -56,7 +57,9 @@ module qar_can #(
             tx_data1    <= 32'h0;
             rx_head     <= 0;
             rx_tail     <= 0;
+            evt_rx      <= 1'b0;
         end else begin
+            evt_rx <= 1'b0;
             if (bus_write) begin
                 case (addr_word)
                     6'h0: ctrl <= wdata;
@@ -87,6 +90,7 @@ module qar_can #(
                                     rx_fifo_data0[rx_head[1:0]] <= tx_data0;
                                     rx_fifo_data1[rx_head[1:0]] <= tx_data1;
                                     rx_head <= rx_head + 1;
+                                    evt_rx <= 1'b1;
                                     status[0] <= 1'b1;
                                     irq_status[0] <= 1'b1;
                                 end else begin
@@ -0,0 +1,136 @@
+`default_nettype none
+
+// CRC accelerator with a programmable polynomial (8/16/32-bit), init value,
+// output XOR and input/output reflection (Rocksoft model). Each write to a
+// DATA register folds 1, 2 or 4 bytes (least significant byte first) into
+// the running CRC in a single cycle, so a buffer costs one store per word.
+module qar_crc (
+    input  wire        clk,
+    input  wire        rst_n,
+    input  wire        bus_write,
+    input  wire        bus_read,
+    input  wire [3:0]  addr_word,
+    input  wire [31:0] wdata,
+    output reg  [31:0] rdata
+);
+
+    localparam WIDTH_8  = 2'd0;
+    localparam WIDTH_16 = 2'd1;
+    localparam WIDTH_32 = 2'd2;
+
+    reg [1:0]  width_sel;
+    reg        refin;
+    reg        refout;
+    reg [31:0] poly;
+    reg [31:0] init_value;
+    reg [31:0] xorout;
+    // Running CRC kept MSB-aligned in 32 bits so one shift register serves
+    // every width; narrower CRCs use the top 8/16 bits.
+    reg [31:0] state;
+
+    function [4:0] width_shift;
+        input [1:0] sel;
+        begin
+            case (sel)
+                WIDTH_8:  width_shift = 5'd24;
+                WIDTH_16: width_shift = 5'd16;
+                default:  width_shift = 5'd0;
+            endcase
+        end
+    endfunction
+
+    function [7:0] reflect8;
+        input [7:0] value;
+        integer i;
+        begin
+            for (i = 0; i < 8; i = i + 1)
+                reflect8[i] = value[7 - i];
+        end
+    endfunction
+
+    function [31:0] reflect32;
+        input [31:0] value;
+        integer i;
+        begin
+            for (i = 0; i < 32; i = i + 1)
+                reflect32[i] = value[31 - i];
+        end
+    endfunction
+
+    function [31:0] crc_byte;
+        input [31:0] crc_in;
+        input [7:0]  data;
+        input [31:0] poly_aligned;
+        integer b;
+        begin
+            crc_byte = crc_in ^ {data, 24'b0};
+            for (b = 0; b < 8; b = b + 1)
+                crc_byte = crc_byte[31] ? ((crc_byte << 1) ^ poly_aligned) : (crc_byte << 1);
+        end
+    endfunction
+
+    wire [4:0]  shift        = width_shift(width_sel);
+    wire [31:0] poly_aligned = poly << shift;
+    wire [31:0] width_mask   = 32'hFFFF_FFFF >> shift;
+
+    wire [7:0] byte0 = refin ? reflect8(wdata[7:0])   : wdata[7:0];
+    wire [7:0] byte1 = refin ? reflect8(wdata[15:8])  : wdata[15:8];
+    wire [7:0] byte2 = refin ? reflect8(wdata[23:16]) : wdata[23:16];
+    wire [7:0] byte3 = refin ? reflect8(wdata[31:24]) : wdata[31:24];
+
+    wire [31:0] after1 = crc_byte(state,  byte0, poly_aligned);
+    wire [31:0] after2 = crc_byte(after1, byte1, poly_aligned);
+    wire [31:0] after4 = crc_byte(crc_byte(after2, byte2, poly_aligned), byte3, poly_aligned);
+
+    wire [31:0] state_value = state >> shift;
+    wire [31:0] result = ((refout ? (reflect32(state) & width_mask) : state_value) ^ xorout) & width_mask;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            width_sel  <= WIDTH_32;
+            refin      <= 1'b0;
+            refout     <= 1'b0;
+            poly       <= 32'h04C1_1DB7;
+            init_value <= 32'hFFFF_FFFF;
+            xorout     <= 32'h0000_0000;
+            state      <= 32'hFFFF_FFFF;
+        end else if (bus_write) begin
+            case (addr_word)
+                4'h0: begin
+                    width_sel <= (wdata[1:0] == 2'd3) ? WIDTH_32 : wdata[1:0];
+                    refin     <= wdata[2];
+                    refout    <= wdata[3];
+                    // Bit4: restart from INIT using the width written here.
+                    if (wdata[4])
+                        state <= init_value << width_shift((wdata[1:0] == 2'd3) ? WIDTH_32 : wdata[1:0]);
+                end
+                4'h1: poly       <= wdata;
+                4'h2: init_value <= wdata;
+                4'h3: xorout     <= wdata;
+                4'h4: state      <= after1;
+                4'h5: state      <= after2;
+                4'h6: state      <= after4;
+                4'h7: state      <= wdata << shift;
+                default: ;
+            endcase
+        end
+    end
+
+    always @(*) begin
+        rdata = 32'b0;
+        if (bus_read) begin
+            case (addr_word)
+                4'h0: rdata = {27'b0, 1'b0, refout, refin, width_sel};
+                4'h1: rdata = poly & width_mask;
+                4'h2: rdata = init_value & width_mask;
+                4'h3: rdata = xorout & width_mask;
+                4'h7: rdata = state_value;
+                4'h8: rdata = result;
+                default: rdata = 32'b0;
+            endcase
+        end
+    end
+
+endmodule
+
+`default_nettype wire
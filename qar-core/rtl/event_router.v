@@ -0,0 +1,130 @@
+`default_nettype none
+
+// Peripheral event routing matrix: each action input of a peripheral selects
+// one hardware event source. Matched events are re-timed by one register so
+// every route has a fixed one-cycle latency.
+module qar_event_router #(
+    parameter GPIO_WIDTH = 32
+) (
+    input  wire                  clk,
+    input  wire                  rst_n,
+    input  wire                  bus_write,
+    input  wire                  bus_read,
+    input  wire [3:0]            addr_word,
+    input  wire [31:0]           wdata,
+    output reg  [31:0]           rdata,
+
+    // Event sources (single-cycle pulses)
+    input  wire                  timer0_cmp0,
+    input  wire                  timer0_cmp1,
+    input  wire [GPIO_WIDTH-1:0] gpio_events,
+    input  wire                  can0_rx,
+    input  wire                  uart0_rx,
+    input  wire                  adc0_done,
+    input  wire                  adc0_window,
+
+    // Actions (single-cycle pulses)
+    output reg                   adc0_start,
+    output reg                   timer0_capture0,
+    output reg                   timer0_capture1,
+    output reg                   timer0_pwm_update,
+    output reg                   uart0_lin_tick,
+    output reg                   gpio_seq_step
+);
+
+    localparam SRC_NONE        = 4'd0;
+    localparam SRC_TIMER0_CMP0 = 4'd1;
+    localparam SRC_TIMER0_CMP1 = 4'd2;
+    localparam SRC_GPIO_EDGE   = 4'd3;
+    localparam SRC_CAN0_RX     = 4'd4;
+    localparam SRC_UART0_RX    = 4'd5;
+    localparam SRC_ADC0_DONE   = 4'd6;
+    localparam SRC_ADC0_WINDOW = 4'd7;
+    localparam SRC_SOFTWARE    = 4'd8;
+
+    localparam ACTIONS = 6;
+
+    reg        ctrl_enable;
+    reg [4:0]  gpio_sel;
+    reg [15:0] src_flags;
+    reg [ACTIONS-1:0] act_flags;
+    reg [3:0]  route [0:ACTIONS-1];
+
+    wire sw_trigger = bus_write && (addr_word == 4'h2) && wdata[0];
+
+    wire [15:0] src_vec;
+    assign src_vec[SRC_NONE]        = 1'b0;
+    assign src_vec[SRC_TIMER0_CMP0] = timer0_cmp0;
+    assign src_vec[SRC_TIMER0_CMP1] = timer0_cmp1;
+    assign src_vec[SRC_GPIO_EDGE]   = gpio_events[gpio_sel];
+    assign src_vec[SRC_CAN0_RX]     = can0_rx;
+    assign src_vec[SRC_UART0_RX]    = uart0_rx;
+    assign src_vec[SRC_ADC0_DONE]   = adc0_done;
+    assign src_vec[SRC_ADC0_WINDOW] = adc0_window;
+    assign src_vec[SRC_SOFTWARE]    = sw_trigger;
+    assign src_vec[15:9]            = 7'b0;
+
+    wire [ACTIONS-1:0] act_fire;
+    genvar g;
+    generate
+        for (g = 0; g < ACTIONS; g = g + 1) begin : gen_route
+            assign act_fire[g] = ctrl_enable && src_vec[route[g]];
+        end
+    endgenerate
+
+    integer r;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            ctrl_enable       <= 1'b0;
+            gpio_sel          <= 5'd0;
+            src_flags         <= 16'b0;
+            act_flags         <= {ACTIONS{1'b0}};
+            adc0_start        <= 1'b0;
+            timer0_capture0   <= 1'b0;
+            timer0_capture1   <= 1'b0;
+            timer0_pwm_update <= 1'b0;
+            uart0_lin_tick    <= 1'b0;
+            gpio_seq_step     <= 1'b0;
+            for (r = 0; r < ACTIONS; r = r + 1)
+                route[r] <= SRC_NONE;
+        end else begin
+            if (bus_write) begin
+                case (addr_word)
+                    4'h0: ctrl_enable <= wdata[0];
+                    4'h1: gpio_sel <= wdata[4:0];
+                    4'h8, 4'h9, 4'hA, 4'hB, 4'hC, 4'hD: route[addr_word[2:0]] <= wdata[3:0];
+                    default: ;
+                endcase
+            end
+
+            // Sticky observation flags (write-1-to-clear at 0x0C / 0x10).
+            src_flags <= ((bus_write && addr_word == 4'h3) ? (src_flags & ~wdata[15:0]) : src_flags) | src_vec;
+            act_flags <= ((bus_write && addr_word == 4'h4) ? (act_flags & ~wdata[ACTIONS-1:0]) : act_flags) | act_fire;
+
+            adc0_start        <= act_fire[0];
+            timer0_capture0   <= act_fire[1];
+            timer0_capture1   <= act_fire[2];
+            timer0_pwm_update <= act_fire[3];
+            uart0_lin_tick    <= act_fire[4];
+            gpio_seq_step     <= act_fire[5];
+        end
+    end
+
+    always @(*) begin
+        rdata = 32'b0;
+        if (bus_read) begin
+            case (addr_word)
+                4'h0: rdata = {31'b0, ctrl_enable};
+                4'h1: rdata = {27'b0, gpio_sel};
+                4'h3: rdata = {16'b0, src_flags};
+                4'h4: rdata = {{(32-ACTIONS){1'b0}}, act_flags};
+                4'h8, 4'h9, 4'hA, 4'hB, 4'hC, 4'hD: rdata = {28'b0, route[addr_word[2:0]]};
+                default: rdata = 32'b0;
+            endcase
+        end
+    end
+
+endmodule
+
+`default_nettype wire
@@ -13,9 +13,11 @@ module qar_gpio #(
     input  wire [WIDTH-1:0] gpio_in,
     input  wire             alt_pwm0,
     input  wire             alt_pwm1,
+    input  wire             seq_tick,
     output wire [WIDTH-1:0] gpio_out,
     output reg  [WIDTH-1:0] gpio_dir,
-    output wire             irq
+    output wire             irq,
+    output wire [WIDTH-1:0] edge_events
 );
 
     localparam ADDR_DIR     = 5'd0;
@@ -30,6 +32,16 @@ module qar_gpio #(
     localparam ADDR_IRQ_FALL    = 5'd9;
     localparam ADDR_DB_EN       = 5'd10;
     localparam ADDR_DB_CYCLES   = 5'd11;
+    localparam ADDR_SEQ_CTRL    = 5'd12;
+    localparam ADDR_SEQ_DIV     = 5'd13;
+    localparam ADDR_SEQ_MASK    = 5'd14;
+    localparam ADDR_SEQ_LEN     = 5'd15;
+    localparam ADDR_SEQ_PTR     = 5'd16;
+    localparam ADDR_SEQ_DATA    = 5'd17;
+    localparam ADDR_SEQ_STATUS  = 5'd18;
+
+    localparam SEQ_DEPTH    = 16;
+    localparam SEQ_PTR_BITS = 4;
 
     reg  [WIDTH-1:0] gpio_out_reg;
     reg  [WIDTH-1:0] alt_pwm_sel;
@@ -49,7 +61,33 @@ module qar_gpio #(
         end
     end
 
-    wire [WIDTH-1:0] gpio_hw_out = (gpio_out_reg & ~pwm_override_mask) | pwm_override_values;
+    // Pattern sequencer: plays SEQ_LEN buffered pin states (or samples the
+    // pins into the buffer) one entry per step. A step is SEQ_DIV core
+    // cycles, or one seq_tick pulse routed from the event router.
+    reg  [WIDTH-1:0] seq_buf [0:SEQ_DEPTH-1];
+    reg  [WIDTH-1:0] seq_out;
+    reg  [WIDTH-1:0] seq_mask;
+    reg  [4:0]       seq_ctrl;
+    reg  [31:0]      seq_div;
+    reg  [31:0]      seq_div_cnt;
+    reg  [SEQ_PTR_BITS:0]   seq_len;
+    reg  [SEQ_PTR_BITS-1:0] seq_step;
+    reg  [SEQ_PTR_BITS-1:0] seq_ptr;
+    reg              seq_busy;
+    reg              seq_done;
+
+    wire seq_enable   = seq_ctrl[0];
+    wire seq_capture  = seq_ctrl[1];
+    wire seq_loop     = seq_ctrl[2];
+    wire seq_ext_tick = seq_ctrl[3];
+    wire seq_irq_en   = seq_ctrl[4];
+    wire [SEQ_PTR_BITS-1:0] seq_last = (seq_len == 0) ? {SEQ_PTR_BITS{1'b0}} : seq_len - 1;
+    wire seq_step_now = seq_busy &&
+        (seq_ext_tick ? seq_tick : (seq_div_cnt + 1 >= ((seq_div == 32'd0) ? 32'd1 : seq_div)));
+    wire [WIDTH-1:0] seq_drive_mask = (seq_enable && !seq_capture) ? seq_mask : {WIDTH{1'b0}};
+
+    wire [WIDTH-1:0] gpio_seq_out = (gpio_out_reg & ~seq_drive_mask) | (seq_out & seq_drive_mask);
+    wire [WIDTH-1:0] gpio_hw_out = (gpio_seq_out & ~pwm_override_mask) | pwm_override_values;
 
     reg  [WIDTH-1:0] irq_enable;
     reg  [WIDTH-1:0] irq_status;
@@ -61,7 +99,7 @@ module qar_gpio #(
     reg  [WIDTH-1:0] debounced_input;
     reg  [15:0]      debounce_counter [0:WIDTH-1];
 
-    assign irq = |(irq_enable & irq_status);
+    assign irq = |(irq_enable & irq_status) || (seq_irq_en && seq_done);
 
     integer i;
     wire [WIDTH-1:0] input_only = (~gpio_dir) & gpio_in;
@@ -70,6 +108,7 @@ module qar_gpio #(
     wire [WIDTH-1:0] rising_edges = (~last_input) & filtered_input_only;
     wire [WIDTH-1:0] falling_edges = last_input & (~filtered_input_only);
     wire [WIDTH-1:0] irq_events = (rising_edges & irq_rise_mask) | (falling_edges & irq_fall_mask);
+    assign edge_events = irq_events;
     wire [WIDTH-1:0] clear_irq_mask =
         (write_en && addr_word == ADDR_IRQ_STATUS) ? wdata[WIDTH-1:0] : {WIDTH{1'b0}};
 
@@ -88,6 +127,16 @@ module qar_gpio #(
             debounced_input <= {WIDTH{1'b0}};
             for (i = 0; i < WIDTH; i = i + 1)
                 debounce_counter[i] <= 16'd0;
+            seq_out     <= {WIDTH{1'b0}};
+            seq_mask    <= {WIDTH{1'b0}};
+            seq_ctrl    <= 5'b0;
+            seq_div     <= 32'd1;
+            seq_div_cnt <= 32'd0;
+            seq_len     <= SEQ_DEPTH;
+            seq_step    <= {SEQ_PTR_BITS{1'b0}};
+            seq_ptr     <= {SEQ_PTR_BITS{1'b0}};
+            seq_busy    <= 1'b0;
+            seq_done    <= 1'b0;
         end else begin
             if (write_en) begin
                 case (addr_word)
@@ -102,9 +151,52 @@ module qar_gpio #(
                     ADDR_IRQ_FALL: irq_fall_mask <= wdata[WIDTH-1:0];
                     ADDR_DB_EN:    debounce_enable <= wdata[WIDTH-1:0];
                     ADDR_DB_CYCLES: debounce_cycles <= wdata[15:0];
+                    ADDR_SEQ_DIV:   seq_div <= wdata;
+                    ADDR_SEQ_MASK:  seq_mask <= wdata[WIDTH-1:0];
+                    ADDR_SEQ_LEN:   seq_len <= (wdata[SEQ_PTR_BITS:0] > SEQ_DEPTH) ? SEQ_DEPTH : wdata[SEQ_PTR_BITS:0];
+                    ADDR_SEQ_PTR:   seq_ptr <= wdata[SEQ_PTR_BITS-1:0];
+                    ADDR_SEQ_DATA: begin
+                        seq_buf[seq_ptr] <= wdata[WIDTH-1:0];
+                        seq_ptr <= seq_ptr + 1'b1;
+                    end
+                    ADDR_SEQ_STATUS: if (wdata[1]) seq_done <= 1'b0;
                     default: ;
                 endcase
             end
+            if (read_en && addr_word == ADDR_SEQ_DATA)
+                seq_ptr <= seq_ptr + 1'b1;
+
+            // Playback drives entry 0 as soon as it is enabled and moves to
+            // the next entry on every step; capture stores one sample per
+            // step, so samples stay aligned to the routed timer events.
+            if (write_en && addr_word == ADDR_SEQ_CTRL) begin
+                seq_ctrl <= wdata[4:0];
+                seq_div_cnt <= 32'd0;
+                seq_step <= {SEQ_PTR_BITS{1'b0}};
+                seq_busy <= wdata[0];
+                seq_done <= 1'b0;
+                if (wdata[0] && !wdata[1])
+                    seq_out <= seq_buf[0];
+            end else if (seq_busy) begin
+                seq_div_cnt <= seq_step_now ? 32'd0 : seq_div_cnt + 1;
+                if (seq_step_now) begin
+                    if (seq_capture)
+                        seq_buf[seq_step] <= (gpio_dir & gpio_hw_out) | filtered_input_only;
+                    if (seq_step == seq_last) begin
+                        seq_done <= 1'b1;
+                        seq_step <= {SEQ_PTR_BITS{1'b0}};
+                        if (!seq_loop)
+                            seq_busy <= 1'b0;
+                        else if (!seq_capture)
+                            seq_out <= seq_buf[0];
+                    end else begin
+                        seq_step <= seq_step + 1'b1;
+                        if (!seq_capture)
+                            seq_out <= seq_buf[seq_step + 1'b1];
+                    end
+                end
+            end
+
             for (i = 0; i < WIDTH; i = i + 1) begin
                 if (gpio_dir[i]) begin
                     debounced_input[i] <= gpio_hw_out[i];
@@ -143,6 +235,13 @@ module qar_gpio #(
                 ADDR_IRQ_FALL: rdata = {{(32-WIDTH){1'b0}}, irq_fall_mask};
                 ADDR_DB_EN:    rdata = {{(32-WIDTH){1'b0}}, debounce_enable};
                 ADDR_DB_CYCLES:rdata = {16'b0, debounce_cycles};
+                ADDR_SEQ_CTRL: rdata = {27'b0, seq_ctrl};
+                ADDR_SEQ_DIV:  rdata = seq_div;
+                ADDR_SEQ_MASK: rdata = {{(32-WIDTH){1'b0}}, seq_mask};
+                ADDR_SEQ_LEN:  rdata = {{(31-SEQ_PTR_BITS){1'b0}}, seq_len};
+                ADDR_SEQ_PTR:  rdata = {{(32-SEQ_PTR_BITS){1'b0}}, seq_ptr};
+                ADDR_SEQ_DATA: rdata = {{(32-WIDTH){1'b0}}, seq_buf[seq_ptr]};
+                ADDR_SEQ_STATUS: rdata = {{(24-SEQ_PTR_BITS){1'b0}}, seq_step, 6'b0, seq_done, seq_busy};
                 default:  rdata = 32'b0;
             endcase
         end
@@ -1,7 +1,8 @@
 `default_nettype none
 
 module qar_i2c #(
-    parameter FIFO_DEPTH = 4
+    parameter FIFO_DEPTH = 8,
+    parameter SEQ_DEPTH  = 16
 ) (
     input  wire        clk,
     input  wire        rst_n,
@@ -29,6 +30,12 @@ module qar_i2c #(
     endfunction
 
     localparam FIFO_ADDR_BITS = clog2(FIFO_DEPTH);
+    localparam SEQ_ADDR_BITS  = clog2(SEQ_DEPTH);
+
+    localparam SEQ_OP_START = 3'd1;
+    localparam SEQ_OP_WRITE = 3'd2;
+    localparam SEQ_OP_READ  = 3'd3;
+    localparam SEQ_OP_STOP  = 3'd4;
 
     reg [31:0] ctrl;
     reg [31:0] clkdiv;
@@ -52,6 +59,27 @@ module qar_i2c #(
     wire rx_fifo_full  = (rx_head - rx_tail) == FIFO_DEPTH;
     wire rx_fifo_empty = (rx_head == rx_tail);
 
+    // Command sequencer: queue of {op[10:8], data[7:0]} entries executed
+    // back-to-back by the bit engine without CPU involvement.
+    reg [SEQ_ADDR_BITS:0] seq_head, seq_tail;
+    reg [10:0] seq_queue [0:SEQ_DEPTH-1];
+    reg        seq_running;
+    reg        seq_done_flag;
+    reg        seq_nack_flag;
+    reg        seq_overflow_flag;
+    reg        seq_abort_on_nack;
+    reg        seq_stop_pending;
+    reg [7:0]  seq_read_left;
+    reg [7:0]  seq_rx_count;
+
+    wire seq_full  = (seq_head - seq_tail) == SEQ_DEPTH;
+    wire seq_empty = (seq_head == seq_tail);
+    wire [SEQ_ADDR_BITS:0] seq_level = seq_head - seq_tail;
+    wire [10:0] seq_entry = seq_queue[seq_tail[SEQ_ADDR_BITS-1:0]];
+    wire [2:0]  seq_entry_op = seq_entry[10:8];
+    wire [7:0]  seq_entry_data = seq_entry[7:0];
+    wire seq_flush_req = bus_write && (addr_word == 6'hA) && wdata[1];
+
     reg [2:0]  state;
     reg        scl_state;
     reg        sda_state;
@@ -74,7 +102,7 @@ module qar_i2c #(
     wire ctrl_enable   = ctrl[0];
     wire ctrl_loopback = ctrl[4];
 
-    assign irq = |(irq_en[5:0] & irq_status[5:0]);
+    assign irq = |(irq_en[6:0] & irq_status[6:0]);
 
     wire busy_flag    = (state != STATE_IDLE);
     wire rx_ready_flag = (rx_head != rx_tail);
@@ -82,6 +110,13 @@ module qar_i2c #(
 
     wire [31:0] status_value = {26'b0, tx_overflow_flag, rx_overflow_flag, ack_error_flag, tx_empty_flag, rx_ready_flag, busy_flag};
     wire [31:0] fault_status_value = {8'b0, last_fault_byte, 4'b0, last_fault_cmd, last_fault_code, ack_error_flag, rx_overflow_flag, tx_overflow_flag, 3'b0};
+    wire [31:0] seq_ctrl_value = {29'b0, seq_abort_on_nack, 1'b0, seq_running};
+    wire [31:0] seq_status_value;
+    assign seq_status_value[3:0]   = {seq_overflow_flag, seq_nack_flag, seq_done_flag, seq_running};
+    assign seq_status_value[7:4]   = 4'b0;
+    assign seq_status_value[15:8]  = {{(7-SEQ_ADDR_BITS){1'b0}}, seq_level};
+    assign seq_status_value[23:16] = seq_rx_count;
+    assign seq_status_value[31:24] = 8'b0;
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
@@ -107,6 +142,16 @@ module qar_i2c #(
             bit_index   <= 4'd0;
             shift_reg   <= 8'h0;
             div_counter <= 16'd0;
+            seq_head    <= 0;
+            seq_tail    <= 0;
+            seq_running <= 1'b0;
+            seq_done_flag <= 1'b0;
+            seq_nack_flag <= 1'b0;
+            seq_overflow_flag <= 1'b0;
+            seq_abort_on_nack <= 1'b1;
+            seq_stop_pending <= 1'b0;
+            seq_read_left <= 8'd0;
+            seq_rx_count  <= 8'd0;
         end else begin
             if (bus_write) begin
                 case (addr_word)
@@ -150,6 +195,37 @@ module qar_i2c #(
                         end
                     end
                     6'h7: cmd_reg <= wdata;
+                    6'h9: begin
+                        if (!seq_full) begin
+                            seq_queue[seq_head[SEQ_ADDR_BITS-1:0]] <= wdata[10:0];
+                            seq_head <= seq_head + 1;
+                        end else begin
+                            seq_overflow_flag <= 1'b1;
+                            irq_status[2] <= 1'b1;
+                        end
+                    end
+                    6'hA: begin
+                        seq_abort_on_nack <= wdata[2];
+                        if (wdata[1]) begin
+                            seq_tail <= seq_head;
+                            seq_running <= 1'b0;
+                            seq_read_left <= 8'd0;
+                            seq_stop_pending <= 1'b0;
+                        end else if (wdata[0] && !seq_running) begin
+                            seq_running <= 1'b1;
+                            seq_done_flag <= 1'b0;
+                            seq_nack_flag <= 1'b0;
+                            seq_rx_count <= 8'd0;
+                        end
+                    end
+                    6'hB: begin
+                        if (wdata[1])
+                            seq_done_flag <= 1'b0;
+                        if (wdata[2])
+                            seq_nack_flag <= 1'b0;
+                        if (wdata[3])
+                            seq_overflow_flag <= 1'b0;
+                    end
                     default: ;
                 endcase
             end
@@ -165,7 +241,63 @@ module qar_i2c #(
                     sda_state <= 1'b1;
                     scl_state <= 1'b1;
                     div_counter <= 16'd0;
-                    if (ctrl_enable) begin
+                    if (ctrl_enable && seq_running) begin
+                        if (seq_flush_req) begin
+                            // Flush in progress this cycle; leave the queue alone.
+                        end else if (seq_stop_pending) begin
+                            seq_stop_pending <= 1'b0;
+                            sda_drive <= 1'b1;
+                            sda_state <= 1'b0;
+                            last_fault_cmd <= 3'd4;
+                            state <= STATE_STOP;
+                        end else if (seq_read_left != 8'd0) begin
+                            if (!rx_fifo_full) begin
+                                seq_read_left <= seq_read_left - 1'b1;
+                                bit_index <= 4'd7;
+                                sda_drive <= 1'b0;
+                                scl_state <= 1'b0;
+                                state <= STATE_READ;
+                            end else begin
+                                // Stretch SCL low until firmware pops RXDATA.
+                                scl_state <= 1'b0;
+                            end
+                        end else if (!seq_empty) begin
+                            seq_tail <= seq_tail + 1;
+                            case (seq_entry_op)
+                                SEQ_OP_START: begin
+                                    sda_drive <= 1'b1;
+                                    sda_state <= 1'b0;
+                                    last_fault_cmd <= 3'd1;
+                                    state <= STATE_START;
+                                end
+                                SEQ_OP_WRITE: begin
+                                    shift_reg <= seq_entry_data;
+                                    bit_index <= 4'd7;
+                                    sda_drive <= 1'b1;
+                                    sda_state <= seq_entry_data[7];
+                                    scl_state <= 1'b0;
+                                    last_fault_cmd <= 3'd2;
+                                    state <= STATE_WRITE;
+                                end
+                                SEQ_OP_READ: begin
+                                    // Bytes are clocked from the read_left branch; 0 is a no-op.
+                                    seq_read_left <= seq_entry_data;
+                                    last_fault_cmd <= 3'd3;
+                                end
+                                SEQ_OP_STOP: begin
+                                    sda_drive <= 1'b1;
+                                    sda_state <= 1'b0;
+                                    last_fault_cmd <= 3'd4;
+                                    state <= STATE_STOP;
+                                end
+                                default: ;
+                            endcase
+                        end else begin
+                            seq_running <= 1'b0;
+                            seq_done_flag <= 1'b1;
+                            irq_status[6] <= 1'b1;
+                        end
+                    end else if (ctrl_enable) begin
                         if (cmd_reg[0]) begin
                             cmd_reg[0] <= 1'b0;
                             sda_drive <= 1'b1;
@@ -238,6 +370,12 @@ module qar_i2c #(
                                 irq_status[5] <= 1'b1;
                                 last_fault_code <= 3'd3;
                                 last_fault_byte <= shift_reg;
+                                if (seq_running && seq_abort_on_nack) begin
+                                    seq_tail <= seq_head;
+                                    seq_read_left <= 8'd0;
+                                    seq_stop_pending <= 1'b1;
+                                    seq_nack_flag <= 1'b1;
+                                end
                             end
                         end else begin
                             state <= STATE_IDLE;
@@ -259,6 +397,8 @@ module qar_i2c #(
                                     rx_fifo[rx_head[FIFO_ADDR_BITS-1:0]] <= shift_reg;
                                     rx_head <= rx_head + 1;
                                     irq_status[0] <= 1'b1;
+                                    if (seq_running)
+                                        seq_rx_count <= seq_rx_count + 1'b1;
                                 end else begin
                                     rx_overflow_flag <= 1'b1;
                                     irq_status[2] <= 1'b1;
@@ -303,6 +443,9 @@ module qar_i2c #(
                 6'h6: rdata = {24'b0, rx_fifo[rx_tail[FIFO_ADDR_BITS-1:0]]};
                 6'h7: rdata = cmd_reg;
                 6'h8: rdata = fault_status_value;
+                6'h9: rdata = 32'b0;
+                6'hA: rdata = seq_ctrl_value;
+                6'hB: rdata = seq_status_value;
                 default: rdata = 32'b0;
             endcase
         end
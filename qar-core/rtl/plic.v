@@ -0,0 +1,146 @@
+`default_nettype none
+
+// Platform-level interrupt controller: per-source enable and priority,
+// claim/complete handshake and a small threshold stack so that a claimed
+// interrupt can only be preempted by a strictly higher priority source.
+// Source 0 is reserved ("no interrupt"); sources are level-sensitive.
+module qar_plic #(
+    parameter NUM_SOURCES = 16,
+    parameter PRIO_BITS   = 3,
+    parameter STACK_DEPTH = 4
+) (
+    input  wire                   clk,
+    input  wire                   rst_n,
+    input  wire                   bus_write,
+    input  wire                   bus_read,
+    input  wire [5:0]             addr_word,
+    input  wire [31:0]            wdata,
+    output reg  [31:0]            rdata,
+    input  wire [NUM_SOURCES-1:0] sources,
+    output wire                   enabled,
+    output wire                   irq
+);
+
+    function integer clog2;
+        input integer value;
+        integer i;
+        begin
+            value = value - 1;
+            for (i = 0; value > 0; i = i + 1)
+                value = value >> 1;
+            clog2 = i;
+        end
+    endfunction
+
+    localparam integer ID_BITS    = clog2(NUM_SOURCES);
+    localparam integer DEPTH_BITS = clog2(STACK_DEPTH + 1);
+
+    reg                   ctrl_enable;
+    reg [NUM_SOURCES-1:0] enable_mask;
+    reg [NUM_SOURCES-1:0] in_service;
+    reg [PRIO_BITS-1:0]   base_threshold;
+    reg [PRIO_BITS-1:0]   src_priority [0:NUM_SOURCES-1];
+    reg [PRIO_BITS-1:0]   prio_stack [0:STACK_DEPTH-1];
+    reg [DEPTH_BITS-1:0]  stack_depth;
+
+    // Effective threshold = priority of the innermost claimed interrupt, or
+    // the software threshold when nothing is in service.
+    reg  [PRIO_BITS-1:0] priority_of_top;
+    wire [PRIO_BITS-1:0] active_threshold =
+        (stack_depth != 0) ? priority_of_top : base_threshold;
+
+    wire [NUM_SOURCES-1:0] pending = sources & ~in_service & {{(NUM_SOURCES-1){1'b1}}, 1'b0};
+    wire [31:0] pending_field    = pending;
+    wire [31:0] enable_field     = enable_mask;
+    wire [31:0] in_service_field = in_service;
+
+    reg [ID_BITS-1:0]   best_id;
+    reg [PRIO_BITS-1:0] best_prio;
+    integer s;
+
+    always @(*) begin
+        priority_of_top = prio_stack[stack_depth - 1'b1];
+        best_id   = {ID_BITS{1'b0}};
+        best_prio = {PRIO_BITS{1'b0}};
+        for (s = NUM_SOURCES - 1; s > 0; s = s - 1) begin
+            if (pending[s] && enable_mask[s] && src_priority[s] >= best_prio && src_priority[s] != 0) begin
+                best_id   = s;
+                best_prio = src_priority[s];
+            end
+        end
+    end
+
+    wire claimable = (best_id != 0) && (best_prio > active_threshold);
+    wire stack_full = (stack_depth == STACK_DEPTH);
+
+    assign enabled = ctrl_enable;
+    assign irq     = ctrl_enable && claimable && !stack_full;
+
+    wire claim_read = bus_read && (addr_word == 6'h4);
+    wire [ID_BITS-1:0] claim_id = (claimable && !stack_full) ? best_id : {ID_BITS{1'b0}};
+    wire [ID_BITS-1:0] complete_id = wdata[ID_BITS-1:0];
+
+    integer i;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            ctrl_enable    <= 1'b0;
+            enable_mask    <= {NUM_SOURCES{1'b0}};
+            in_service     <= {NUM_SOURCES{1'b0}};
+            base_threshold <= {PRIO_BITS{1'b0}};
+            stack_depth    <= {DEPTH_BITS{1'b0}};
+            for (i = 0; i < NUM_SOURCES; i = i + 1)
+                src_priority[i] <= {PRIO_BITS{1'b0}};
+            for (i = 0; i < STACK_DEPTH; i = i + 1)
+                prio_stack[i] <= {PRIO_BITS{1'b0}};
+        end else begin
+            if (bus_write) begin
+                case (addr_word)
+                    6'h0: ctrl_enable <= wdata[0];
+                    6'h2: enable_mask <= wdata[NUM_SOURCES-1:0] & {{(NUM_SOURCES-1){1'b1}}, 1'b0};
+                    6'h3: base_threshold <= wdata[PRIO_BITS-1:0];
+                    6'h4: begin
+                        // Complete: release the source and restore the outer threshold.
+                        if (complete_id != 0 && in_service[complete_id]) begin
+                            in_service[complete_id] <= 1'b0;
+                            if (stack_depth != 0)
+                                stack_depth <= stack_depth - 1'b1;
+                        end
+                    end
+                    default: begin
+                        if (addr_word >= 6'h10 && addr_word < 6'h10 + NUM_SOURCES && addr_word != 6'h10)
+                            src_priority[addr_word - 6'h10] <= wdata[PRIO_BITS-1:0];
+                    end
+                endcase
+            end
+
+            if (claim_read && claim_id != 0) begin
+                in_service[claim_id] <= 1'b1;
+                prio_stack[stack_depth] <= best_prio;
+                stack_depth <= stack_depth + 1'b1;
+            end
+        end
+    end
+
+    always @(*) begin
+        rdata = 32'b0;
+        if (bus_read) begin
+            case (addr_word)
+                6'h0: rdata = {31'b0, ctrl_enable};
+                6'h1: rdata = pending_field;
+                6'h2: rdata = enable_field;
+                6'h3: rdata = {{(32-PRIO_BITS){1'b0}}, base_threshold};
+                6'h4: rdata = {{(32-ID_BITS){1'b0}}, claim_id};
+                6'h5: rdata = {{(24-DEPTH_BITS){1'b0}}, stack_depth, {(8-PRIO_BITS){1'b0}}, active_threshold};
+                6'h6: rdata = in_service_field;
+                default: begin
+                    if (addr_word > 6'h10 && addr_word < 6'h10 + NUM_SOURCES)
+                        rdata = {{(32-PRIO_BITS){1'b0}}, src_priority[addr_word - 6'h10]};
+                end
+            endcase
+        end
+    end
+
+endmodule
+
+`default_nettype wire
@@ -1,8 +1,13 @@
 // =============================================
-// QAR-Core v0.6 - Three-Stage Pipeline Core
+// QAR-Core v0.6 - Three/Five-Stage Pipeline Core
 // - RV32I subset with arithmetic/logic, load/store, branches, CSR ops
+// - PIPELINE_STAGES=5 splits EX into EX/MEM/WB with full forwarding
+// - RV32A atomics (LR/SC, AMOs) on the data memory path
+// - Optional RV32C (RVC_ENABLE) with a halfword aligner ahead of ID
 // - Streaming instruction/data interfaces with basic hazard + forwarding
 // - CSR/timer subsystem with ECALL/MRET and external interrupts
+// - WFI halts fetch until an enabled interrupt is pending (core_sleep)
+// - Optional branch/exception trace buffer (TRACE_DEPTH) at 0x4000_A000
 // =============================================
 `default_nettype none
 
@@ -13,7 +18,26 @@ module qar_core #(
     parameter USE_INTERNAL_DMEM = 0,
     parameter IMEM_DATA_WIDTH   = 32,
     parameter DMEM_DATA_WIDTH   = 32,
-    parameter ICACHE_ENTRIES    = 0
+    parameter ICACHE_ENTRIES    = 0,
+    // RV32C: 16-bit instructions are expanded between IF and ID. IMEM and
+    // the I-cache stay word-addressed; an aligner splits/joins halfwords.
+    parameter RVC_ENABLE        = 0,
+    // 3: IF/ID/EX, EX does ALU, branches, CSRs and starts memory accesses.
+    // 5: IF/ID/EX/MEM/WB for a shorter critical path; same interfaces.
+    parameter PIPELINE_STAGES   = 3,
+    // 1: LW below 0x2000_0000 (the linker's IMEM region) reads IMEM over
+    // the fetch port, so .rodata stays in program.hex; DMEM then sits at
+    // 0x2000_0000 and up. Stores/AMOs to that region fault.
+    parameter IMEM_DATA_LOADS   = 0,
+    // Peripheral instance counts (1 or 2). Instance n of a type sits at
+    // <TYPE>0 base + n * <TYPE>_STRIDE and owns a fixed PLIC source slot.
+    parameter UART_COUNT        = 1,
+    parameter SPI_COUNT         = 1,
+    parameter I2C_COUNT         = 1,
+    parameter CAN_COUNT         = 1,
+    // Branch/exception trace buffer entries (power of two >= 2); 0 leaves
+    // the unit out and its registers read as zero.
+    parameter TRACE_DEPTH       = 0
 ) (
     input  wire        clk,
     input  wire        rst_n,
@@ -38,25 +62,28 @@ module qar_core #(
     output reg         irq_timer_ack,
     output reg         irq_external_ack,
 
+    // High while WFI waits; SoC may gate the fetch/decode clock with it
+    output wire        core_sleep,
+
     // GPIO interface
     input  wire [31:0] gpio_in,
     output wire [31:0] gpio_out,
     output wire [31:0] gpio_dir,
     output wire        gpio_irq,
 
-    // UART interface
-    output wire        uart_tx,
-    input  wire        uart_rx,
-    output wire        uart_de,
-    output wire        uart_re,
-    output wire        spi_sck,
-    output wire        spi_mosi,
-    input  wire        spi_miso,
-    output wire [3:0]  spi_cs_n,
-    output wire        i2c_scl,
-    output wire        i2c_sda_out,
-    input  wire        i2c_sda_in,
-    output wire        i2c_sda_oe,
+    // Serial interfaces: bit n (or chip-select nibble n) belongs to instance n
+    output wire [UART_COUNT-1:0]  uart_tx,
+    input  wire [UART_COUNT-1:0]  uart_rx,
+    output wire [UART_COUNT-1:0]  uart_de,
+    output wire [UART_COUNT-1:0]  uart_re,
+    output wire [SPI_COUNT-1:0]   spi_sck,
+    output wire [SPI_COUNT-1:0]   spi_mosi,
+    input  wire [SPI_COUNT-1:0]   spi_miso,
+    output wire [4*SPI_COUNT-1:0] spi_cs_n,
+    output wire [I2C_COUNT-1:0]   i2c_scl,
+    output wire [I2C_COUNT-1:0]   i2c_sda_out,
+    input  wire [I2C_COUNT-1:0]   i2c_sda_in,
+    output wire [I2C_COUNT-1:0]   i2c_sda_oe,
     input  wire [11:0] adc_ch0,
     input  wire [11:0] adc_ch1,
     input  wire [11:0] adc_ch2,
@@ -82,6 +109,8 @@ module qar_core #(
     localparam DMEM_ADDR_WIDTH = clog2(DMEM_DEPTH);
     localparam DMEM_ADDR_MSB   = DMEM_ADDR_WIDTH + 1;
 
+    // Elaboration checks; Yosys defines SYNTHESIS and skips them
+`ifndef SYNTHESIS
     initial begin
         if (IMEM_DATA_WIDTH != 32) begin
             $fatal("IMEM_DATA_WIDTH values other than 32 are not supported in this prototype");
@@ -92,7 +121,18 @@ module qar_core #(
         if (ICACHE_ENTRIES == 1) begin
             $fatal("ICACHE_ENTRIES must be 0 (disabled) or a power-of-two >= 2");
         end
+        if (UART_COUNT < 1 || UART_COUNT > 2 || SPI_COUNT < 1 || SPI_COUNT > 2 ||
+            I2C_COUNT < 1 || I2C_COUNT > 2 || CAN_COUNT < 1 || CAN_COUNT > 2) begin
+            $fatal("UART/SPI/I2C/CAN_COUNT must be 1 or 2");
+        end
+        if (TRACE_DEPTH == 1 || (TRACE_DEPTH & (TRACE_DEPTH - 1)) != 0) begin
+            $fatal("TRACE_DEPTH must be 0 (disabled) or a power-of-two >= 2");
+        end
+        if (PIPELINE_STAGES != 3 && PIPELINE_STAGES != 5) begin
+            $fatal("PIPELINE_STAGES must be 3 or 5");
+        end
     end
+`endif
 
     localparam PREFETCH_DEPTH = 2;
     localparam ICACHE_ENABLED      = (ICACHE_ENTRIES > 0) ? 1 : 0;
@@ -103,16 +143,32 @@ module qar_core #(
     localparam GPIO_ADDR_MASK      = 32'hFFFF_FF00;
     localparam UART0_BASE_ADDR     = 32'h4000_1000;
     localparam UART_ADDR_MASK      = 32'hFFFF_FF00;
+    localparam UART_STRIDE         = 32'h0000_1000;
     localparam SPI0_BASE_ADDR      = 32'h4000_4000;
     localparam SPI_ADDR_MASK       = 32'hFFFF_FF00;
+    localparam SPI_STRIDE          = 32'h0000_0100;
     localparam CAN0_BASE_ADDR      = 32'h4000_3000;
     localparam CAN_ADDR_MASK       = 32'hFFFF_FF00;
+    localparam CAN_STRIDE          = 32'h0000_0100;
     localparam TIMER0_BASE_ADDR    = 32'h4000_5000;
     localparam TIMER_ADDR_MASK     = 32'hFFFF_FF00;
     localparam I2C0_BASE_ADDR      = 32'h4000_4400;
     localparam I2C_ADDR_MASK       = 32'hFFFF_FF00;
+    localparam I2C_STRIDE          = 32'h0000_0100;
     localparam ADC0_BASE_ADDR      = 32'h4000_6000;
     localparam ADC_ADDR_MASK       = 32'hFFFF_FF00;
+    localparam EVR0_BASE_ADDR      = 32'h4000_7000;
+    localparam EVR_ADDR_MASK       = 32'hFFFF_FF00;
+    localparam PLIC0_BASE_ADDR     = 32'h4000_8000;
+    localparam PLIC_ADDR_MASK      = 32'hFFFF_FF00;
+    localparam CRC0_BASE_ADDR      = 32'h4000_9000;
+    localparam CRC_ADDR_MASK       = 32'hFFFF_FF00;
+    localparam TRACE0_BASE_ADDR    = 32'h4000_A000;
+    localparam TRACE_ADDR_MASK     = 32'hFFFF_FF00;
+    localparam IMEM_LOAD_BASE      = 32'h0000_0000;
+    localparam IMEM_LOAD_MASK      = 32'hE000_0000;
+    localparam PBUS_BASE_ADDR      = 32'h4000_0000;
+    localparam PBUS_ADDR_MASK      = 32'hFFFF_0000;
 
     // ------------------------------------------------------------
     // Fetch / Decode / Execute pipeline state
@@ -120,6 +176,9 @@ module qar_core #(
     reg [31:0] pc_fetch;
     reg        fetch_req_pending;
     reg [31:0] fetch_req_addr;
+    // IMEM data port: a load owns the fetch bus while iload_pending
+    reg        iload_pending;
+    reg [31:0] iload_addr;
 
     reg        if_valid;
     reg [31:0] if_instr;
@@ -128,73 +187,145 @@ module qar_core #(
     reg [31:0] prefetch_slot_instr;
     reg [31:0] prefetch_slot_pc;
     integer icache_init_idx;
-    reg        start_gpio;
-    reg        start_gpio_is_load;
-    reg [31:0] start_gpio_addr;
-    reg [31:0] start_gpio_wdata;
-    reg        start_uart0;
-    reg        start_uart0_is_load;
-    reg [31:0] start_uart0_addr;
-    reg [31:0] start_uart0_wdata;
-    reg        start_spi0;
-    reg        start_spi0_is_load;
-    reg [31:0] start_spi0_addr;
-    reg [31:0] start_spi0_wdata;
-    reg        start_i2c0;
-    reg        start_i2c0_is_load;
-    reg [31:0] start_i2c0_addr;
-    reg [31:0] start_i2c0_wdata;
-    reg        start_adc0;
-    reg        start_adc0_is_load;
-    reg [31:0] start_adc0_addr;
-    reg [31:0] start_adc0_wdata;
-    reg        start_can0;
-    reg        start_can0_is_load;
-    reg [31:0] start_can0_addr;
-    reg [31:0] start_can0_wdata;
-    reg        start_timer0;
-    reg        start_timer0_is_load;
-    reg [31:0] start_timer0_addr;
-    reg [31:0] start_timer0_wdata;
     reg [31:0] icache_data [0:REAL_ICACHE_ENTRIES-1];
     reg [ICACHE_TAG_BITS-1:0] icache_tag [0:REAL_ICACHE_ENTRIES-1];
     reg                       icache_valid [0:REAL_ICACHE_ENTRIES-1];
-    wire        gpio_write_en    = start_gpio && !start_gpio_is_load;
-    wire        gpio_read_en     = start_gpio && start_gpio_is_load;
-    wire [4:0]  gpio_addr_word   = start_gpio_addr[6:2];
+
+    // ------------------------------------------------------------
+    // Peripheral bus (APB-like). EX posts at most one request per cycle
+    // into a registered address/data stage; the access phase decodes the
+    // registered address. Stores retire from EX immediately (posted),
+    // loads complete one cycle later. The stage is single-entry and in
+    // order, so a load always observes every earlier posted store.
+    // ------------------------------------------------------------
+    reg        pbus_req;
+    reg        pbus_req_write;
+    reg [31:0] pbus_req_addr;
+    reg [31:0] pbus_req_wdata;
+    reg        pb_valid;
+    reg        pb_write;
+    reg [31:0] pb_addr;
+    reg [31:0] pb_wdata;
+    wire        pb_write_strobe = pb_valid && pb_write;
+    wire        pb_read_strobe  = pb_valid && !pb_write;
+    wire        pb_sel_gpio   = ((pb_addr & GPIO_ADDR_MASK) == GPIO_BASE_ADDR);
+    wire        pb_sel_adc0   = ((pb_addr & ADC_ADDR_MASK) == ADC0_BASE_ADDR);
+    wire        pb_sel_timer0 = ((pb_addr & TIMER_ADDR_MASK) == TIMER0_BASE_ADDR);
+    wire        pb_sel_evr0   = ((pb_addr & EVR_ADDR_MASK) == EVR0_BASE_ADDR);
+    wire        pb_sel_plic0  = ((pb_addr & PLIC_ADDR_MASK) == PLIC0_BASE_ADDR);
+    wire        pb_sel_crc0   = ((pb_addr & CRC_ADDR_MASK) == CRC0_BASE_ADDR);
+    wire        pb_sel_trace0 = ((pb_addr & TRACE_ADDR_MASK) == TRACE0_BASE_ADDR);
+    wire        gpio_write_en    = pb_write_strobe && pb_sel_gpio;
+    wire        gpio_read_en     = pb_read_strobe && pb_sel_gpio;
+    wire [4:0]  gpio_addr_word   = pb_addr[6:2];
     wire [31:0] gpio_read_data;
-    wire        uart0_write_en = start_uart0 && !start_uart0_is_load;
-    wire        uart0_read_en  = start_uart0 && start_uart0_is_load;
-    wire [3:0]  uart0_addr_word = start_uart0_addr[5:2];
-    wire [31:0] uart0_read_data;
-    wire        uart0_irq;
-    wire        spi0_write_en = start_spi0 && !start_spi0_is_load;
-    wire        spi0_read_en  = start_spi0 && start_spi0_is_load;
-    wire [5:0]  spi0_addr_word = start_spi0_addr[7:2];
-    wire [31:0] spi0_read_data;
-    wire        spi0_irq;
-    wire        can0_write_en = start_can0 && !start_can0_is_load;
-    wire        can0_read_en  = start_can0 && start_can0_is_load;
-    wire [5:0]  can0_addr_word = start_can0_addr[7:2];
-    wire [31:0] can0_read_data;
-    wire        can0_irq;
-    wire        i2c0_write_en = start_i2c0 && !start_i2c0_is_load;
-    wire        i2c0_read_en  = start_i2c0 && start_i2c0_is_load;
-    wire [5:0]  i2c0_addr_word = start_i2c0_addr[7:2];
-    wire [31:0] i2c0_read_data;
-    wire        i2c0_irq;
-    wire        adc0_write_en = start_adc0 && !start_adc0_is_load;
-    wire        adc0_read_en  = start_adc0 && start_adc0_is_load;
-    wire [4:0]  adc0_addr_word = start_adc0_addr[6:2];
+    // Replicated serial blocks: one select/read-data/irq slice per instance.
+    wire [UART_COUNT-1:0]    pb_sel_uart;
+    wire [32*UART_COUNT-1:0] uart_read_bus;
+    wire [UART_COUNT-1:0]    uart_irq;
+    wire [UART_COUNT-1:0]    uart_evt_rx;
+    wire [3:0]               uart_addr_word = pb_addr[5:2];
+    wire [SPI_COUNT-1:0]     pb_sel_spi;
+    wire [32*SPI_COUNT-1:0]  spi_read_bus;
+    wire [SPI_COUNT-1:0]     spi_irq;
+    wire [5:0]               spi_addr_word = pb_addr[7:2];
+    wire [I2C_COUNT-1:0]     pb_sel_i2c;
+    wire [32*I2C_COUNT-1:0]  i2c_read_bus;
+    wire [I2C_COUNT-1:0]     i2c_irq;
+    wire [5:0]               i2c_addr_word = pb_addr[7:2];
+    wire [CAN_COUNT-1:0]     pb_sel_can;
+    wire [32*CAN_COUNT-1:0]  can_read_bus;
+    wire [CAN_COUNT-1:0]     can_irq;
+    wire [CAN_COUNT-1:0]     can_evt_rx;
+    wire [5:0]               can_addr_word = pb_addr[7:2];
+    reg  [31:0]              serial_read_data;
+    integer                  serial_idx;
+
+    always @(*) begin
+        serial_read_data = 32'b0;
+        for (serial_idx = 0; serial_idx < UART_COUNT; serial_idx = serial_idx + 1)
+            serial_read_data = serial_read_data | uart_read_bus[serial_idx*32 +: 32];
+        for (serial_idx = 0; serial_idx < SPI_COUNT; serial_idx = serial_idx + 1)
+            serial_read_data = serial_read_data | spi_read_bus[serial_idx*32 +: 32];
+        for (serial_idx = 0; serial_idx < I2C_COUNT; serial_idx = serial_idx + 1)
+            serial_read_data = serial_read_data | i2c_read_bus[serial_idx*32 +: 32];
+        for (serial_idx = 0; serial_idx < CAN_COUNT; serial_idx = serial_idx + 1)
+            serial_read_data = serial_read_data | can_read_bus[serial_idx*32 +: 32];
+    end
+
+    // Fixed two-slot views used by the PLIC map (missing instances read as 0).
+    wire [1:0]  uart_irq_slots = uart_irq;
+    wire [1:0]  spi_irq_slots  = spi_irq;
+    wire [1:0]  i2c_irq_slots  = i2c_irq;
+    wire [1:0]  can_irq_slots  = can_irq;
+    wire        adc0_write_en = pb_write_strobe && pb_sel_adc0;
+    wire        adc0_read_en  = pb_read_strobe && pb_sel_adc0;
+    wire [4:0]  adc0_addr_word = pb_addr[6:2];
     wire [31:0] adc0_read_data;
     wire        adc0_irq;
-    wire        timer0_write_en = start_timer0 && !start_timer0_is_load;
-    wire        timer0_read_en  = start_timer0 && start_timer0_is_load;
-    wire [5:0]  timer0_addr_word = start_timer0_addr[7:2];
+    wire        timer0_write_en = pb_write_strobe && pb_sel_timer0;
+    wire        timer0_read_en  = pb_read_strobe && pb_sel_timer0;
+    wire [5:0]  timer0_addr_word = pb_addr[7:2];
     wire [31:0] timer0_read_data;
     wire        timer0_irq;
     wire        timer_pwm0;
     wire        timer_pwm1;
+    wire        evr0_write_en = pb_write_strobe && pb_sel_evr0;
+    wire        evr0_read_en  = pb_read_strobe && pb_sel_evr0;
+    wire [3:0]  evr0_addr_word = pb_addr[5:2];
+    wire [31:0] evr0_read_data;
+    wire        plic0_write_en = pb_write_strobe && pb_sel_plic0;
+    wire        plic0_read_en  = pb_read_strobe && pb_sel_plic0;
+    wire [5:0]  plic0_addr_word = pb_addr[7:2];
+    wire [31:0] plic0_read_data;
+    wire        plic0_enabled;
+    wire        plic0_irq;
+    wire        crc0_write_en = pb_write_strobe && pb_sel_crc0;
+    wire        crc0_read_en  = pb_read_strobe && pb_sel_crc0;
+    wire [3:0]  crc0_addr_word = pb_addr[5:2];
+    wire [31:0] crc0_read_data;
+    wire        trace0_write_en = pb_write_strobe && pb_sel_trace0;
+    wire        trace0_read_en  = pb_read_strobe && pb_sel_trace0;
+    wire [3:0]  trace0_addr_word = pb_addr[5:2];
+    wire [31:0] trace0_read_data;
+
+    // Unselected peripherals return zero, so the read mux is a plain OR.
+    wire [31:0] pb_rdata = gpio_read_data | serial_read_data | adc0_read_data |
+                           timer0_read_data | evr0_read_data | plic0_read_data |
+                           crc0_read_data | trace0_read_data;
+
+    // PLIC source map (0 = none). Instances left out by the *_COUNT
+    // parameters keep their slot tied low so the numbering never shifts.
+    wire [15:0] plic0_sources = {
+        4'b0,               // 15..12 reserved
+        irq_external,       // 11 external pin
+        adc0_irq,           // 10 ADC0
+        i2c_irq_slots[1],   //  9 I2C1
+        i2c_irq_slots[0],   //  8 I2C0
+        spi_irq_slots[1],   //  7 SPI1
+        spi_irq_slots[0],   //  6 SPI0
+        gpio_irq,           //  5 GPIO
+        can_irq_slots[1],   //  4 CAN1
+        can_irq_slots[0],   //  3 CAN0
+        uart_irq_slots[1],  //  2 UART1
+        uart_irq_slots[0],  //  1 UART0
+        1'b0                //  0 no interrupt
+    };
+
+    // Peripheral event fabric (sources -> event router -> actions)
+    wire [31:0] gpio_edge_events;
+    wire        uart0_evt_rx = uart_evt_rx[0];
+    wire        can0_evt_rx  = can_evt_rx[0];
+    wire        timer0_evt_cmp0;
+    wire        timer0_evt_cmp1;
+    wire        adc0_evt_done;
+    wire        adc0_evt_window;
+    wire        evr_adc0_start;
+    wire        evr_timer0_capture0;
+    wire        evr_timer0_capture1;
+    wire        evr_timer0_pwm_update;
+    wire        evr_uart0_lin_tick;
+    wire        evr_gpio_seq_step;
 
     always @(*) begin
         if ((ICACHE_ENABLED != 0) &&
@@ -214,13 +345,27 @@ module qar_core #(
     reg        id_valid;
     reg [31:0] id_instr;
     reg [31:0] id_pc;
+    reg        id_is_rvc;
 
     reg        ex_valid;
     reg [31:0] ex_instr;
     reg [31:0] ex_pc;
+    reg        ex_is_rvc;
     reg [31:0] ex_rs1_val;
     reg [31:0] ex_rs2_val;
 
+    // Five-stage build only: exu_* is the EX stage and ex_* becomes MEM,
+    // carrying the EX results below instead of recomputing them.
+    reg        exu_valid;
+    reg [31:0] exu_instr;
+    reg [31:0] exu_pc;
+    reg        exu_is_rvc;
+    reg [31:0] exu_rs1_val;
+    reg [31:0] exu_rs2_val;
+    reg [31:0] ex_result;
+    reg [31:0] ex_agu_addr;
+    reg        ex_branch_cond;
+
     wire       imem_ready_in;
     wire [IMEM_DATA_WIDTH-1:0] imem_rdata_in;
     wire [31:0] imem_instr_word = imem_rdata_in[31:0];
@@ -231,6 +376,11 @@ module qar_core #(
     reg                          icache_lookup_hit;
     reg  [31:0]                  icache_lookup_word;
 
+    // Fetch and IMEM data loads never overlap: a load waits for the fetch
+    // in flight and blocks new fetches until its word returns.
+    wire        imem_bus_valid = fetch_req_pending || iload_pending;
+    wire [31:0] imem_bus_addr  = iload_pending ? iload_addr : fetch_req_addr;
+
     generate
         if (USE_INTERNAL_IMEM) begin : gen_internal_imem
             reg [31:0] imem_array [0:IMEM_DEPTH-1];
@@ -241,16 +391,48 @@ module qar_core #(
                 $display("QAR-Core: loading internal instruction memory from program.hex ...");
                 $readmemh("program.hex", imem_array);
             end
-            assign imem_ready_in = fetch_req_pending;
-            assign imem_rdata_in = imem_array[fetch_req_addr[IMEM_ADDR_MSB:2]];
+            assign imem_ready_in = imem_bus_valid;
+            assign imem_rdata_in = imem_array[imem_bus_addr[IMEM_ADDR_MSB:2]];
         end else begin : gen_external_imem
             assign imem_ready_in = imem_ready;
             assign imem_rdata_in = imem_rdata;
         end
     endgenerate
 
-    assign imem_valid = fetch_req_pending;
-    assign imem_addr  = fetch_req_addr;
+    assign imem_valid = imem_bus_valid;
+    assign imem_addr  = imem_bus_addr;
+
+    // ------------------------------------------------------------
+    // Instruction aligner. if_instr holds the oldest fetched word and the
+    // prefetch slot the next one; align_off selects the halfword where the
+    // next instruction starts. A 32-bit instruction at offset 2 is joined
+    // from both words, so it waits until the prefetch slot is filled.
+    // With RVC_ENABLE=0 this collapses to a plain word pass-through.
+    // ------------------------------------------------------------
+    reg         align_off;
+    wire [15:0] align_half   = align_off ? if_instr[31:16] : if_instr[15:0];
+    wire        align_is_rvc = (RVC_ENABLE != 0) && (align_half[1:0] != 2'b11);
+    wire        align_split  = (RVC_ENABLE != 0) && align_off && !align_is_rvc;
+    wire        align_ready  = if_valid && (!align_split || prefetch_slot_valid);
+    // IF word fully consumed by the instruction handed to ID
+    wire        align_pop    = !align_is_rvc || align_off;
+    wire [31:0] align_pc     = (RVC_ENABLE != 0) ? {if_pc[31:2], align_off, 1'b0} : if_pc;
+    // Resume point for an interrupt taken while IF holds nothing: the
+    // oldest word still in flight, not the already-advanced pc_fetch.
+    wire [31:0] fetch_resume_word = prefetch_slot_valid ? prefetch_slot_pc :
+                                    fetch_req_pending   ? fetch_req_addr :
+                                    pc_fetch;
+    wire [31:0] fetch_resume_pc = (RVC_ENABLE != 0) ? {fetch_resume_word[31:2], align_off, 1'b0} :
+                                  fetch_resume_word;
+    wire [31:0] rvc_expanded;
+    wire [31:0] align_instr  = align_is_rvc ? rvc_expanded :
+                               align_split  ? {prefetch_slot_instr[15:0], if_instr[31:16]} :
+                               if_instr;
+
+    qar_rvc_expand rvc_expand_inst (
+        .c    (align_half),
+        .instr(rvc_expanded)
+    );
 
     // ------------------------------------------------------------
     // Data memory interface wires (internal RAM optional)
@@ -306,11 +488,16 @@ module qar_core #(
     wire [31:0] rf_rdata1;
     wire [31:0] rf_rdata2;
 
+    // Five-stage build: the register file is written from the WB register
+    reg         wb_we;
+    reg  [4:0]  wb_waddr;
+    reg  [31:0] wb_wdata;
+
     regfile rf_inst (
         .clk   (clk),
-        .we    (rf_we),
-        .waddr (rf_waddr),
-        .wdata (rf_wdata),
+        .we    ((PIPELINE_STAGES == 5) ? wb_we    : rf_we),
+        .waddr ((PIPELINE_STAGES == 5) ? wb_waddr : rf_waddr),
+        .wdata ((PIPELINE_STAGES == 5) ? wb_wdata : rf_wdata),
         .raddr1(rf_raddr1),
         .raddr2(rf_raddr2),
         .rdata1(rf_rdata1),
@@ -325,56 +512,95 @@ module qar_core #(
         .write_en (gpio_write_en),
         .read_en  (gpio_read_en),
         .addr_word(gpio_addr_word),
-        .wdata    (start_gpio_wdata),
+        .wdata    (pb_wdata),
         .rdata    (gpio_read_data),
         .gpio_in  (gpio_in),
         .alt_pwm0 (timer_pwm0),
         .alt_pwm1 (timer_pwm1),
+        .seq_tick (evr_gpio_seq_step),
         .gpio_out (gpio_out),
         .gpio_dir (gpio_dir),
-        .irq      (gpio_irq)
+        .irq      (gpio_irq),
+        .edge_events(gpio_edge_events)
     );
 
-    qar_uart uart0 (
-        .clk       (clk),
-        .rst_n     (rst_n),
-        .bus_write (uart0_write_en),
-        .bus_read  (uart0_read_en),
-        .addr_word (uart0_addr_word),
-        .wdata     (start_uart0_wdata),
-        .rdata     (uart0_read_data),
-        .tx        (uart_tx),
-        .rx        (uart_rx),
-        .rs485_de  (uart_de),
-        .rs485_re  (uart_re),
-        .irq       (uart0_irq)
-    );
+    genvar pi;
+    generate
+        for (pi = 0; pi < UART_COUNT; pi = pi + 1) begin : gen_uart
+            assign pb_sel_uart[pi] = ((pb_addr & UART_ADDR_MASK) == UART0_BASE_ADDR + pi * UART_STRIDE);
+
+            qar_uart uart (
+                .clk       (clk),
+                .rst_n     (rst_n),
+                .bus_write (pb_write_strobe && pb_sel_uart[pi]),
+                .bus_read  (pb_read_strobe && pb_sel_uart[pi]),
+                .addr_word (uart_addr_word),
+                .wdata     (pb_wdata),
+                .rdata     (uart_read_bus[pi*32 +: 32]),
+                .tx        (uart_tx[pi]),
+                .rx        (uart_rx[pi]),
+                .rs485_de  (uart_de[pi]),
+                .rs485_re  (uart_re[pi]),
+                .irq       (uart_irq[pi]),
+                .evt_rx    (uart_evt_rx[pi]),
+                .lin_tick  ((pi == 0) ? evr_uart0_lin_tick : 1'b0)
+            );
+        end
 
-    qar_spi spi0 (
-        .clk       (clk),
-        .rst_n     (rst_n),
-        .bus_write (spi0_write_en),
-        .bus_read  (spi0_read_en),
-        .addr_word (spi0_addr_word),
-        .wdata     (start_spi0_wdata),
-        .rdata     (spi0_read_data),
-        .irq       (spi0_irq),
-        .spi_sck   (spi_sck),
-        .spi_mosi  (spi_mosi),
-        .spi_miso  (spi_miso),
-        .spi_cs_n  (spi_cs_n)
-    );
+        for (pi = 0; pi < SPI_COUNT; pi = pi + 1) begin : gen_spi
+            assign pb_sel_spi[pi] = ((pb_addr & SPI_ADDR_MASK) == SPI0_BASE_ADDR + pi * SPI_STRIDE);
+
+            qar_spi spi (
+                .clk       (clk),
+                .rst_n     (rst_n),
+                .bus_write (pb_write_strobe && pb_sel_spi[pi]),
+                .bus_read  (pb_read_strobe && pb_sel_spi[pi]),
+                .addr_word (spi_addr_word),
+                .wdata     (pb_wdata),
+                .rdata     (spi_read_bus[pi*32 +: 32]),
+                .irq       (spi_irq[pi]),
+                .spi_sck   (spi_sck[pi]),
+                .spi_mosi  (spi_mosi[pi]),
+                .spi_miso  (spi_miso[pi]),
+                .spi_cs_n  (spi_cs_n[pi*4 +: 4])
+            );
+        end
 
-    qar_can can0 (
-        .clk       (clk),
-        .rst_n     (rst_n),
-        .bus_write (can0_write_en),
-        .bus_read  (can0_read_en),
-        .addr_word (can0_addr_word),
-        .wdata     (start_can0_wdata),
-        .rdata     (can0_read_data),
-        .irq       (can0_irq)
-    );
+        for (pi = 0; pi < CAN_COUNT; pi = pi + 1) begin : gen_can
+            assign pb_sel_can[pi] = ((pb_addr & CAN_ADDR_MASK) == CAN0_BASE_ADDR + pi * CAN_STRIDE);
+
+            qar_can can (
+                .clk       (clk),
+                .rst_n     (rst_n),
+                .bus_write (pb_write_strobe && pb_sel_can[pi]),
+                .bus_read  (pb_read_strobe && pb_sel_can[pi]),
+                .addr_word (can_addr_word),
+                .wdata     (pb_wdata),
+                .rdata     (can_read_bus[pi*32 +: 32]),
+                .irq       (can_irq[pi]),
+                .evt_rx    (can_evt_rx[pi])
+            );
+        end
+
+        for (pi = 0; pi < I2C_COUNT; pi = pi + 1) begin : gen_i2c
+            assign pb_sel_i2c[pi] = ((pb_addr & I2C_ADDR_MASK) == I2C0_BASE_ADDR + pi * I2C_STRIDE);
+
+            qar_i2c i2c (
+                .clk       (clk),
+                .rst_n     (rst_n),
+                .bus_write (pb_write_strobe && pb_sel_i2c[pi]),
+                .bus_read  (pb_read_strobe && pb_sel_i2c[pi]),
+                .addr_word (i2c_addr_word),
+                .wdata     (pb_wdata),
+                .rdata     (i2c_read_bus[pi*32 +: 32]),
+                .irq       (i2c_irq[pi]),
+                .scl       (i2c_scl[pi]),
+                .sda_out   (i2c_sda_out[pi]),
+                .sda_in    (i2c_sda_in[pi]),
+                .sda_oe    (i2c_sda_oe[pi])
+            );
+        end
+    endgenerate
 
     qar_timer timer0 (
         .clk       (clk),
@@ -382,26 +608,17 @@ module qar_core #(
         .bus_write (timer0_write_en),
         .bus_read  (timer0_read_en),
         .addr_word (timer0_addr_word),
-        .wdata     (start_timer0_wdata),
+        .wdata     (pb_wdata),
         .rdata     (timer0_read_data),
         .irq       (timer0_irq),
         .pwm0      (timer_pwm0),
-        .pwm1      (timer_pwm1)
-    );
-
-    qar_i2c i2c0 (
-        .clk       (clk),
-        .rst_n     (rst_n),
-        .bus_write (i2c0_write_en),
-        .bus_read  (i2c0_read_en),
-        .addr_word (i2c0_addr_word),
-        .wdata     (start_i2c0_wdata),
-        .rdata     (i2c0_read_data),
-        .irq       (i2c0_irq),
-        .scl       (i2c_scl),
-        .sda_out   (i2c_sda_out),
-        .sda_in    (i2c_sda_in),
-        .sda_oe    (i2c_sda_oe)
+        .pwm1      (timer_pwm1),
+        .evt_cmp0  (timer0_evt_cmp0),
+        .evt_cmp1  (timer0_evt_cmp1),
+        .trig_capture0(evr_timer0_capture0),
+        .trig_capture1(evr_timer0_capture1),
+        .trig_pwm_update(evr_timer0_pwm_update),
+        .cap_in    (gpio_in)
     );
 
     qar_adc adc0 (
@@ -410,13 +627,68 @@ module qar_core #(
         .bus_write (adc0_write_en),
         .bus_read  (adc0_read_en),
         .addr_word (adc0_addr_word),
-        .wdata     (start_adc0_wdata),
+        .wdata     (pb_wdata),
         .rdata     (adc0_read_data),
         .ch0       (adc_ch0),
         .ch1       (adc_ch1),
         .ch2       (adc_ch2),
         .ch3       (adc_ch3),
-        .irq       (adc0_irq)
+        .irq       (adc0_irq),
+        .trig_start(evr_adc0_start),
+        .evt_done  (adc0_evt_done),
+        .evt_window(adc0_evt_window)
+    );
+
+    qar_plic #(
+        .NUM_SOURCES(16),
+        .PRIO_BITS  (3),
+        .STACK_DEPTH(4)
+    ) plic0 (
+        .clk       (clk),
+        .rst_n     (rst_n),
+        .bus_write (plic0_write_en),
+        .bus_read  (plic0_read_en),
+        .addr_word (plic0_addr_word),
+        .wdata     (pb_wdata),
+        .rdata     (plic0_read_data),
+        .sources   (plic0_sources),
+        .enabled   (plic0_enabled),
+        .irq       (plic0_irq)
+    );
+
+    qar_event_router #(
+        .GPIO_WIDTH(32)
+    ) evr0 (
+        .clk       (clk),
+        .rst_n     (rst_n),
+        .bus_write (evr0_write_en),
+        .bus_read  (evr0_read_en),
+        .addr_word (evr0_addr_word),
+        .wdata     (pb_wdata),
+        .rdata     (evr0_read_data),
+        .timer0_cmp0(timer0_evt_cmp0),
+        .timer0_cmp1(timer0_evt_cmp1),
+        .gpio_events(gpio_edge_events),
+        .can0_rx   (can0_evt_rx),
+        .uart0_rx  (uart0_evt_rx),
+        .adc0_done (adc0_evt_done),
+        .adc0_window(adc0_evt_window),
+        .adc0_start(evr_adc0_start),
+        .timer0_capture0(evr_timer0_capture0),
+        .timer0_capture1(evr_timer0_capture1),
+        .timer0_pwm_update(evr_timer0_pwm_update),
+        .uart0_lin_tick(evr_uart0_lin_tick),
+        .gpio_seq_step(evr_gpio_seq_step)
+    );
+
+    qar_crc crc0 (
+        .clk       (clk),
+        .rst_n     (rst_n),
+        .bus_write (crc0_write_en),
+        .bus_read  (crc0_read_en),
+        .addr_word (crc0_addr_word),
+        .wdata     (pb_wdata),
+        .rdata     (crc0_read_data)
     );
 
     // ------------------------------------------------------------
@@ -454,6 +726,7 @@ module qar_core #(
     reg [31:0] csr_mtimecmp;
     reg [31:0] csr_mtime;
     reg        csr_irq_priority;
+    reg [31:0] csr_idle_cycles;
 
     localparam CSR_ADDR_MSTATUS  = 12'h300;
     localparam CSR_ADDR_MIE      = 12'h304;
@@ -465,9 +738,14 @@ module qar_core #(
     localparam CSR_ADDR_MTIMECMP = 12'h720;
     localparam CSR_ADDR_IRQ_PRIORITY = 12'hBC0;
     localparam CSR_ADDR_IRQ_ACK      = 12'hBC1;
+    localparam CSR_ADDR_IDLE_CYCLES  = 12'hBC2;
 
     localparam MCAUSE_ECALL = 32'd11;
     localparam MCAUSE_ILLEGAL = 32'd2;
+    localparam MCAUSE_LOAD_MISALIGNED  = 32'd4;
+    localparam MCAUSE_LOAD_FAULT       = 32'd5;
+    localparam MCAUSE_STORE_MISALIGNED = 32'd6;
+    localparam MCAUSE_STORE_FAULT      = 32'd7;
     localparam MCAUSE_TIMER_IRQ = 32'h8000_0007;
     localparam MCAUSE_EXT_IRQ   = 32'h8000_000B;
 
@@ -481,17 +759,49 @@ module qar_core #(
     wire [4:0]  id_rs2     = id_instr[24:20];
     wire [4:0]  id_rd      = id_instr[11:7];
 
-    wire id_uses_rs1 = (id_opcode == 7'b0110011) || // OP
-                       (id_opcode == 7'b0010011) || // OP-IMM
-                       (id_opcode == 7'b0000011) || // LOAD
-                       (id_opcode == 7'b0100011) || // STORE
-                       (id_opcode == 7'b1100011) || // BRANCH
-                       (id_opcode == 7'b1100111) || // JALR
-                       (id_opcode == 7'b1110011 && id_funct3 != 3'b000); // CSR register forms
+    function reads_rs1;
+        input [31:0] instr;
+        begin
+            reads_rs1 = (instr[6:0] == 7'b0110011) || // OP
+                        (instr[6:0] == 7'b0010011) || // OP-IMM
+                        (instr[6:0] == 7'b0000011) || // LOAD
+                        (instr[6:0] == 7'b0100011) || // STORE
+                        (instr[6:0] == 7'b0101111) || // AMO
+                        (instr[6:0] == 7'b1100011) || // BRANCH
+                        (instr[6:0] == 7'b1100111) || // JALR
+                        (instr[6:0] == 7'b1110011 && instr[14:12] != 3'b000); // CSR register forms
+        end
+    endfunction
+
+    function reads_rs2;
+        input [31:0] instr;
+        begin
+            reads_rs2 = (instr[6:0] == 7'b0110011) || // OP
+                        (instr[6:0] == 7'b0100011) || // STORE
+                        (instr[6:0] == 7'b0101111) || // AMO
+                        (instr[6:0] == 7'b1100011);   // BRANCH
+        end
+    endfunction
+
+    function branch_cond;
+        input [2:0]  f3;
+        input [31:0] a;
+        input [31:0] b;
+        begin
+            case (f3)
+                3'b000:  branch_cond = (a == b);                   // BEQ
+                3'b001:  branch_cond = (a != b);                   // BNE
+                3'b100:  branch_cond = ($signed(a) < $signed(b));  // BLT
+                3'b101:  branch_cond = ($signed(a) >= $signed(b)); // BGE
+                3'b110:  branch_cond = (a < b);                    // BLTU
+                3'b111:  branch_cond = (a >= b);                   // BGEU
+                default: branch_cond = 1'b0;
+            endcase
+        end
+    endfunction
 
-    wire id_uses_rs2 = (id_opcode == 7'b0110011) || // OP
-                       (id_opcode == 7'b0100011) || // STORE
-                       (id_opcode == 7'b1100011);   // BRANCH
+    wire id_uses_rs1 = reads_rs1(id_instr);
+    wire id_uses_rs2 = reads_rs2(id_instr);
 
     wire [31:0] id_rs1_raw = rf_rdata1;
     wire [31:0] id_rs2_raw = rf_rdata2;
@@ -508,25 +818,87 @@ module qar_core #(
     wire [31:0] imm_b = {{19{ex_instr[31]}}, ex_instr[31], ex_instr[7], ex_instr[30:25], ex_instr[11:8], 1'b0};
     wire [31:0] imm_j = {{11{ex_instr[31]}}, ex_instr[31], ex_instr[19:12], ex_instr[20], ex_instr[30:21], 1'b0};
     wire [31:0] imm_u = {ex_instr[31:12], 12'b0};
-    wire [31:0] jalr_sum = ex_rs1_val + imm_i;
-    wire [31:0] addr_load_candidate  = ex_rs1_val + imm_i;
-    wire [31:0] addr_store_candidate = ex_rs1_val + imm_s;
-    wire        load_hits_gpio  = ((addr_load_candidate & GPIO_ADDR_MASK) == GPIO_BASE_ADDR);
-    wire        store_hits_gpio = ((addr_store_candidate & GPIO_ADDR_MASK) == GPIO_BASE_ADDR);
-    wire        load_hits_uart0  = ((addr_load_candidate & UART_ADDR_MASK) == UART0_BASE_ADDR);
-    wire        store_hits_uart0 = ((addr_store_candidate & UART_ADDR_MASK) == UART0_BASE_ADDR);
-    wire        load_hits_can0   = ((addr_load_candidate & CAN_ADDR_MASK) == CAN0_BASE_ADDR);
-    wire        store_hits_can0  = ((addr_store_candidate & CAN_ADDR_MASK) == CAN0_BASE_ADDR);
-    wire        load_hits_spi0   = ((addr_load_candidate & SPI_ADDR_MASK) == SPI0_BASE_ADDR);
-    wire        store_hits_spi0  = ((addr_store_candidate & SPI_ADDR_MASK) == SPI0_BASE_ADDR);
-    wire        load_hits_timer0 = ((addr_load_candidate & TIMER_ADDR_MASK) == TIMER0_BASE_ADDR);
-    wire        store_hits_timer0= ((addr_store_candidate & TIMER_ADDR_MASK) == TIMER0_BASE_ADDR);
-    wire        load_hits_i2c0   = ((addr_load_candidate & I2C_ADDR_MASK) == I2C0_BASE_ADDR);
-    wire        store_hits_i2c0  = ((addr_store_candidate & I2C_ADDR_MASK) == I2C0_BASE_ADDR);
-    wire        load_hits_adc0   = ((addr_load_candidate & ADC_ADDR_MASK) == ADC0_BASE_ADDR);
-    wire        store_hits_adc0  = ((addr_store_candidate & ADC_ADDR_MASK) == ADC0_BASE_ADDR);
-
-    wire [31:0] pc_plus4 = ex_pc + 32'd4;
+    // Five-stage: address and branch outcome were computed a stage earlier
+    wire [31:0] addr_load_candidate  = (PIPELINE_STAGES == 5) ? ex_agu_addr : ex_rs1_val + imm_i;
+    wire [31:0] addr_store_candidate = (PIPELINE_STAGES == 5) ? ex_agu_addr : ex_rs1_val + imm_s;
+    wire [31:0] jalr_sum             = addr_load_candidate;
+    wire        ex_cond_met = (PIPELINE_STAGES == 5) ? ex_branch_cond :
+                              branch_cond(funct3, ex_rs1_val, ex_rs2_val);
+    wire [31:0] ex_alu_value = (PIPELINE_STAGES == 5) ? ex_result : alu_result;
+    wire        load_hits_pbus  = ((addr_load_candidate & PBUS_ADDR_MASK) == PBUS_BASE_ADDR);
+    wire        store_hits_pbus = ((addr_store_candidate & PBUS_ADDR_MASK) == PBUS_BASE_ADDR);
+    wire        load_hits_imem  = (IMEM_DATA_LOADS != 0) &&
+                                  ((addr_load_candidate & IMEM_LOAD_MASK) == IMEM_LOAD_BASE);
+    wire        store_hits_imem = (IMEM_DATA_LOADS != 0) &&
+                                  ((addr_store_candidate & IMEM_LOAD_MASK) == IMEM_LOAD_BASE);
+
+    wire [31:0] pc_next = ex_pc + (ex_is_rvc ? 32'd2 : 32'd4);
+
+    // WFI: EX holds the instruction until an enabled interrupt is pending
+    // and no new fetches are issued meanwhile. An interrupt that wakes the
+    // core reports the following instruction as mepc.
+    wire wfi_in_ex = ex_valid && (opcode == 7'b1110011) && (funct3 == 3'b000) &&
+                     (ex_instr[31:20] == 12'h105) && (rs1 == 5'd0) && (rd == 5'd0);
+    assign core_sleep = wfi_in_ex && !wfi_wake;
+
+    // ------------------------------------------------------------
+    // RV32A: LR/SC and AMOs on DMEM. A read-modify-write runs as a DMEM
+    // read followed by a DMEM write while EX stays stalled; interrupts are
+    // held off for the whole sequence so it is atomic with respect to
+    // handlers on this single hart. Any trap drops the reservation.
+    // ------------------------------------------------------------
+    localparam AMO_IDLE  = 2'd0;
+    localparam AMO_READ  = 2'd1;
+    localparam AMO_WRITE = 2'd2;
+    localparam AMO_DONE  = 2'd3;
+
+    localparam AMO_F5_LR   = 5'b00010;
+    localparam AMO_F5_SC   = 5'b00011;
+    localparam AMO_F5_SWAP = 5'b00001;
+    localparam AMO_F5_ADD  = 5'b00000;
+    localparam AMO_F5_XOR  = 5'b00100;
+    localparam AMO_F5_AND  = 5'b01100;
+    localparam AMO_F5_OR   = 5'b01000;
+    localparam AMO_F5_MIN  = 5'b10000;
+    localparam AMO_F5_MAX  = 5'b10100;
+    localparam AMO_F5_MINU = 5'b11000;
+    localparam AMO_F5_MAXU = 5'b11100;
+
+    reg  [1:0]  amo_state;
+    reg  [31:0] amo_loaded;
+    reg         resv_valid;
+    reg  [31:0] resv_addr;
+    reg  [31:0] amo_result;
+
+    wire [4:0]  amo_funct5   = ex_instr[31:27];
+    wire        amo_in_ex    = ex_valid && (opcode == 7'b0101111);
+    wire        amo_is_lr    = (amo_funct5 == AMO_F5_LR) && (rs2 == 5'd0);
+    wire        amo_is_sc    = (amo_funct5 == AMO_F5_SC);
+    wire        amo_is_rmw   = (amo_funct5 == AMO_F5_SWAP) || (amo_funct5 == AMO_F5_ADD) ||
+                               (amo_funct5 == AMO_F5_XOR)  || (amo_funct5 == AMO_F5_AND) ||
+                               (amo_funct5 == AMO_F5_OR)   || (amo_funct5 == AMO_F5_MIN) ||
+                               (amo_funct5 == AMO_F5_MAX)  || (amo_funct5 == AMO_F5_MINU) ||
+                               (amo_funct5 == AMO_F5_MAXU);
+    wire        amo_legal    = (funct3 == 3'b010) && (amo_is_lr || amo_is_sc || amo_is_rmw);
+    wire        amo_hits_pbus   = ((ex_rs1_val & PBUS_ADDR_MASK) == PBUS_BASE_ADDR);
+    wire        amo_hits_imem   = (IMEM_DATA_LOADS != 0) &&
+                                  ((ex_rs1_val & IMEM_LOAD_MASK) == IMEM_LOAD_BASE);
+    wire        amo_misaligned  = (ex_rs1_val[1:0] != 2'b00);
+    wire        sc_hit       = resv_valid && (resv_addr == ex_rs1_val);
+
+    always @(*) begin
+        case (amo_funct5)
+            AMO_F5_ADD:  amo_result = amo_loaded + ex_rs2_val;
+            AMO_F5_XOR:  amo_result = amo_loaded ^ ex_rs2_val;
+            AMO_F5_AND:  amo_result = amo_loaded & ex_rs2_val;
+            AMO_F5_OR:   amo_result = amo_loaded | ex_rs2_val;
+            AMO_F5_MIN:  amo_result = ($signed(amo_loaded) < $signed(ex_rs2_val)) ? amo_loaded : ex_rs2_val;
+            AMO_F5_MAX:  amo_result = ($signed(amo_loaded) > $signed(ex_rs2_val)) ? amo_loaded : ex_rs2_val;
+            AMO_F5_MINU: amo_result = (amo_loaded < ex_rs2_val) ? amo_loaded : ex_rs2_val;
+            AMO_F5_MAXU: amo_result = (amo_loaded > ex_rs2_val) ? amo_loaded : ex_rs2_val;
+            default:     amo_result = ex_rs2_val; // AMOSWAP
+        endcase
+    end
 
     // ------------------------------------------------------------
     // Control + hazard wires
@@ -546,6 +918,8 @@ module qar_core #(
     reg [31:0] trap_cause;
     reg [31:0] trap_mepc_value;
 
+    reg        iload_start;
+
     reg        start_mem;
     reg        start_mem_is_load;
     reg [31:0] start_mem_addr;
@@ -559,15 +933,89 @@ module qar_core #(
 
     wire       ex_active = ex_valid;
 
-    // Forwarding assistance
-    wire       wb_en_forward = ex_active && !stall_ex && rf_we && (rf_waddr != 0);
+    // Forwarding assistance: into ID from the register file write port
+    // (EX in the three-stage build, the WB register in the five-stage one)
+    wire        wb_en_forward = (PIPELINE_STAGES == 5) ? (wb_we && (wb_waddr != 0)) :
+                                (ex_active && !stall_ex && rf_we && (rf_waddr != 0));
+    wire [4:0]  wb_fwd_addr   = (PIPELINE_STAGES == 5) ? wb_waddr : rf_waddr;
+    wire [31:0] wb_fwd_data   = (PIPELINE_STAGES == 5) ? wb_wdata : rf_wdata;
 
-    wire [31:0] forward_rs1 = (wb_en_forward && (rf_waddr == id_rs1) && id_uses_rs1) ? rf_wdata : id_rs1_raw;
-    wire [31:0] forward_rs2 = (wb_en_forward && (rf_waddr == id_rs2) && id_uses_rs2) ? rf_wdata : id_rs2_raw;
+    wire [31:0] forward_rs1 = (wb_en_forward && (wb_fwd_addr == id_rs1) && id_uses_rs1) ? wb_fwd_data : id_rs1_raw;
+    wire [31:0] forward_rs2 = (wb_en_forward && (wb_fwd_addr == id_rs2) && id_uses_rs2) ? wb_fwd_data : id_rs2_raw;
 
     wire hazard_load_rs1 = dmem_pending && dmem_is_load && id_uses_rs1 && (id_rs1 != 0) && (id_rs1 == dmem_rd);
     wire hazard_load_rs2 = dmem_pending && dmem_is_load && id_uses_rs2 && (id_rs2 != 0) && (id_rs2 == dmem_rd);
-    wire load_use_hazard = id_valid && (hazard_load_rs1 || hazard_load_rs2);
+    wire load_use_hazard = (PIPELINE_STAGES != 5) && id_valid && (hazard_load_rs1 || hazard_load_rs2);
+
+    // ------------------------------------------------------------
+    // Five-stage EX: ALU, branch compare and address generation on
+    // forwarded operands, registered into MEM (ex_*). MEM then starts
+    // DMEM/peripheral accesses, runs CSR ops and takes traps from
+    // registered values, and its register writes go through WB.
+    // ALU-class results forward from MEM, anything else from WB; a
+    // consumer of a load, AMO or CSR result waits in EX for one cycle
+    // after the producer leaves MEM. Optimised away at three stages.
+    // ------------------------------------------------------------
+    wire [6:0]  exu_opcode = exu_instr[6:0];
+    wire [4:0]  exu_rs1    = exu_instr[19:15];
+    wire [4:0]  exu_rs2    = exu_instr[24:20];
+    wire [31:0] exu_imm_i  = {{20{exu_instr[31]}}, exu_instr[31:20]};
+    wire [31:0] exu_imm_s  = {{20{exu_instr[31]}}, exu_instr[31:25], exu_instr[11:7]};
+    wire [31:0] exu_imm_u  = {exu_instr[31:12], 12'b0};
+
+    // Result known when MEM is entered (OP, OP-IMM, LUI, AUIPC, JAL, JALR)
+    wire ex_result_early = ex_valid && ((opcode == 7'b0110011) || (opcode == 7'b0010011) ||
+                                        (opcode == 7'b0110111) || (opcode == 7'b0010111) ||
+                                        (opcode == 7'b1101111) || (opcode == 7'b1100111));
+    // Result produced by MEM itself (LOAD, AMO, CSR)
+    wire ex_result_late  = ex_valid && ((opcode == 7'b0000011) || (opcode == 7'b0101111) ||
+                                        (opcode == 7'b1110011));
+
+    wire exu_mem_rs1 = ex_result_early && (rd != 5'd0) && (rd == exu_rs1);
+    wire exu_mem_rs2 = ex_result_early && (rd != 5'd0) && (rd == exu_rs2);
+    wire exu_wb_rs1  = wb_we && (wb_waddr != 5'd0) && (wb_waddr == exu_rs1);
+    wire exu_wb_rs2  = wb_we && (wb_waddr != 5'd0) && (wb_waddr == exu_rs2);
+
+    wire [31:0] exu_op1 = exu_mem_rs1 ? ex_result : exu_wb_rs1 ? wb_wdata : exu_rs1_val;
+    wire [31:0] exu_op2 = exu_mem_rs2 ? ex_result : exu_wb_rs2 ? wb_wdata : exu_rs2_val;
+
+    wire exu_hazard = exu_valid && ex_result_late && (rd != 5'd0) &&
+                      ((reads_rs1(exu_instr) && (rd == exu_rs1)) ||
+                       (reads_rs2(exu_instr) && (rd == exu_rs2)));
+
+    wire [31:0] exu_agu_addr = exu_op1 + ((exu_opcode == 7'b0100011) ? exu_imm_s : exu_imm_i);
+    reg  [31:0] exu_result;
+
+    always @(*) begin
+        case (exu_opcode)
+            7'b0110111: exu_result = exu_imm_u;                                       // LUI
+            7'b0010111: exu_result = exu_pc + exu_imm_u;                              // AUIPC
+            7'b1101111,
+            7'b1100111: exu_result = exu_pc + (exu_is_rvc ? 32'd2 : 32'd4);          // JAL/JALR
+            default:    exu_result = alu_result;
+        endcase
+    end
+
+    // ALU operation select; runs on EX operands in either build. Illegal
+    // funct3/funct7 combinations are rejected by the EX/MEM decode below.
+    wire [31:0] alu_instr = (PIPELINE_STAGES == 5) ? exu_instr : ex_instr;
+
+    always @(*) begin
+        alu_op_a   = (PIPELINE_STAGES == 5) ? exu_op1 : ex_rs1_val;
+        alu_op_b   = (PIPELINE_STAGES == 5) ? exu_op2 : ex_rs2_val;
+        alu_op_sel = ALU_ADD;
+        if (alu_instr[6:0] == 7'b0010011)
+            alu_op_b = {{20{alu_instr[31]}}, alu_instr[31:20]};
+        case (alu_instr[14:12])
+            3'b000: alu_op_sel = ((alu_instr[6:0] == 7'b0110011) && alu_instr[30]) ? ALU_SUB : ALU_ADD;
+            3'b100: alu_op_sel = ALU_XOR;
+            3'b110: alu_op_sel = ALU_OR;
+            3'b111: alu_op_sel = ALU_AND;
+            3'b001: alu_op_sel = ALU_SLL;
+            3'b101: alu_op_sel = ALU_SRL;
+            default: alu_op_sel = ALU_ADD;
+        endcase
+    end
 
     // CSR read helper
     always @(*) begin
@@ -582,6 +1030,7 @@ module qar_core #(
             CSR_ADDR_MTIMECMP: csr_read_data = csr_mtimecmp;
             CSR_ADDR_IRQ_PRIORITY: csr_read_data = {31'b0, csr_irq_priority};
             CSR_ADDR_IRQ_ACK:      csr_read_data = 32'b0;
+            CSR_ADDR_IDLE_CYCLES:  csr_read_data = csr_idle_cycles;
             default:           csr_read_data = 32'b0;
         endcase
     end
@@ -592,14 +1041,11 @@ module qar_core #(
     always @(*) begin
         rf_we        = 1'b0;
         rf_waddr     = rd;
-        rf_wdata     = alu_result;
+        rf_wdata     = ex_alu_value;
         rf_raddr1    = id_valid ? id_rs1 : 5'd0;
         rf_raddr2    = id_valid ? id_rs2 : 5'd0;
-        alu_op_a     = ex_rs1_val;
-        alu_op_b     = ex_rs2_val;
-        alu_op_sel   = ALU_ADD;
         branch_taken = 1'b0;
-        branch_target= pc_plus4;
+        branch_target= pc_next;
         flush_pipe   = 1'b0;
         stall_ex     = 1'b0;
         start_mem         = 1'b0;
@@ -607,34 +1053,11 @@ module qar_core #(
         start_mem_addr    = 32'b0;
         start_mem_wdata   = 32'b0;
         start_mem_rd      = rd;
-        start_gpio         = 1'b0;
-        start_gpio_is_load = 1'b0;
-        start_gpio_addr    = 32'b0;
-        start_gpio_wdata   = 32'b0;
-        start_uart0         = 1'b0;
-        start_uart0_is_load = 1'b0;
-        start_uart0_addr    = 32'b0;
-        start_uart0_wdata   = 32'b0;
-        start_spi0          = 1'b0;
-        start_spi0_is_load  = 1'b0;
-        start_spi0_addr     = 32'b0;
-        start_spi0_wdata    = 32'b0;
-        start_i2c0          = 1'b0;
-        start_i2c0_is_load  = 1'b0;
-        start_i2c0_addr     = 32'b0;
-        start_i2c0_wdata    = 32'b0;
-        start_adc0          = 1'b0;
-        start_adc0_is_load  = 1'b0;
-        start_adc0_addr     = 32'b0;
-        start_adc0_wdata    = 32'b0;
-        start_can0          = 1'b0;
-        start_can0_is_load  = 1'b0;
-        start_can0_addr     = 32'b0;
-        start_can0_wdata    = 32'b0;
-        start_timer0        = 1'b0;
-        start_timer0_is_load= 1'b0;
-        start_timer0_addr   = 32'b0;
-        start_timer0_wdata  = 32'b0;
+        pbus_req          = 1'b0;
+        pbus_req_write    = 1'b0;
+        pbus_req_addr     = 32'b0;
+        pbus_req_wdata    = 32'b0;
+        iload_start       = 1'b0;
         load_commit       = 1'b0;
         load_commit_rd    = dmem_rd;
         csr_write_en      = 1'b0;
@@ -658,98 +1081,56 @@ module qar_core #(
 
         if (ex_active) begin
             case (opcode)
-                7'b0010011: begin // OP-IMM
+                7'b0010011: begin // OP-IMM (ADDI/XORI/ORI/ANDI/SLLI/SRLI)
                     rf_we    = 1'b1;
                     rf_waddr = rd;
-                    alu_op_a = ex_rs1_val;
-                    alu_op_sel = ALU_ADD;
-                    alu_op_b = imm_i;
+                    case (funct3)
+                        3'b000, 3'b100, 3'b110, 3'b111: ;
+                        3'b001, 3'b101: illegal_instr = (funct7 != 7'b0000000);
+                        default: illegal_instr = 1'b1;
+                    endcase
                 end
 
-                7'b0110011: begin // OP
+                7'b0110011: begin // OP (ADD/SUB/AND/OR/XOR/SLL/SRL)
                     rf_we    = 1'b1;
                     rf_waddr = rd;
                     case (funct3)
-                        3'b000: begin
-                            if (funct7 == 7'b0000000)
-                                alu_op_sel = ALU_ADD;
-                            else if (funct7 == 7'b0100000)
-                                alu_op_sel = ALU_SUB;
-                            else
-                                illegal_instr = 1'b1;
-                        end
-                        3'b111: alu_op_sel = ALU_AND;
-                        3'b110: alu_op_sel = ALU_OR;
-                        3'b100: alu_op_sel = ALU_XOR;
-                        3'b001: alu_op_sel = ALU_SLL;
-                        3'b101: begin
-                            if (funct7 == 7'b0000000)
-                                alu_op_sel = ALU_SRL;
-                            else
-                                illegal_instr = 1'b1;
-                        end
+                        3'b000: illegal_instr = (funct7 != 7'b0000000) && (funct7 != 7'b0100000);
+                        3'b111, 3'b110, 3'b100, 3'b001: ;
+                        3'b101: illegal_instr = (funct7 != 7'b0000000);
                         default: illegal_instr = 1'b1;
                     endcase
                 end
 
                 7'b0000011: begin // LOAD
                     if (funct3 == 3'b010) begin
-                        if (load_hits_gpio) begin
-                            start_gpio         = 1'b1;
-                            start_gpio_is_load = 1'b1;
-                            start_gpio_addr    = addr_load_candidate;
-                            rf_we              = 1'b1;
-                            rf_waddr           = rd;
-                            rf_wdata           = gpio_read_data;
-                        end else if (load_hits_uart0) begin
-                            start_uart0         = 1'b1;
-                            start_uart0_is_load = 1'b1;
-                            start_uart0_addr    = addr_load_candidate;
-                            rf_we               = 1'b1;
-                            rf_waddr            = rd;
-                            rf_wdata            = uart0_read_data;
-                        end else if (load_hits_spi0) begin
-                            start_spi0         = 1'b1;
-                            start_spi0_is_load = 1'b1;
-                            start_spi0_addr    = addr_load_candidate;
-                            rf_we              = 1'b1;
-                            rf_waddr           = rd;
-                            rf_wdata           = spi0_read_data;
-                        end else if (load_hits_i2c0) begin
-                            start_i2c0         = 1'b1;
-                            start_i2c0_is_load = 1'b1;
-                            start_i2c0_addr    = addr_load_candidate;
-                            rf_we              = 1'b1;
-                            rf_waddr           = rd;
-                            rf_wdata           = i2c0_read_data;
-                        end else if (load_hits_can0) begin
-                            start_can0         = 1'b1;
-                            start_can0_is_load = 1'b1;
-                            start_can0_addr    = addr_load_candidate;
-                            rf_we              = 1'b1;
-                            rf_waddr           = rd;
-                            rf_wdata           = can0_read_data;
-                        end else if (load_hits_timer0) begin
-                            start_timer0         = 1'b1;
-                            start_timer0_is_load = 1'b1;
-                            start_timer0_addr    = addr_load_candidate;
-                            rf_we                = 1'b1;
-                            rf_waddr             = rd;
-                            rf_wdata             = timer0_read_data;
-                        end else if (load_hits_adc0) begin
-                            start_adc0         = 1'b1;
-                            start_adc0_is_load = 1'b1;
-                            start_adc0_addr    = addr_load_candidate;
-                            rf_we              = 1'b1;
-                            rf_waddr           = rd;
-                            rf_wdata           = adc0_read_data;
+                        if (load_hits_pbus) begin
+                            if (pb_read_strobe) begin
+                                rf_we          = 1'b1;
+                                rf_waddr       = rd;
+                                rf_wdata       = pb_rdata;
+                            end else begin
+                                pbus_req       = 1'b1;
+                                pbus_req_write = 1'b0;
+                                pbus_req_addr  = addr_load_candidate;
+                                stall_ex       = 1'b1;
+                            end
+                        end else if (load_hits_imem) begin
+                            if (iload_pending && imem_ready_in) begin
+                                rf_we          = 1'b1;
+                                rf_waddr       = rd;
+                                rf_wdata       = imem_instr_word;
+                            end else begin
+                                iload_start    = !iload_pending && !fetch_req_pending;
+                                stall_ex       = 1'b1;
+                            end
                         end else if (!dmem_pending) begin
                             start_mem         = 1'b1;
                             start_mem_is_load = 1'b1;
                             start_mem_addr    = addr_load_candidate;
                             start_mem_rd      = rd;
                         end
-                        if (!load_hits_gpio && !load_hits_uart0 && !load_hits_spi0 && !load_hits_i2c0 && !load_hits_can0 && !load_hits_timer0 && !load_hits_adc0)
+                        if (!load_hits_pbus && !load_hits_imem)
                             stall_ex = (dmem_pending && !mem_ready_in) || start_mem;
                     end else begin
                         illegal_instr = 1'b1;
@@ -758,64 +1139,84 @@ module qar_core #(
 
                 7'b0100011: begin // STORE
                     if (funct3 == 3'b010) begin
-                        if (store_hits_gpio) begin
-                            start_gpio         = 1'b1;
-                            start_gpio_is_load = 1'b0;
-                            start_gpio_addr    = addr_store_candidate;
-                            start_gpio_wdata   = ex_rs2_val;
-                        end else if (store_hits_uart0) begin
-                            start_uart0         = 1'b1;
-                            start_uart0_is_load = 1'b0;
-                            start_uart0_addr    = addr_store_candidate;
-                            start_uart0_wdata   = ex_rs2_val;
-                        end else if (store_hits_spi0) begin
-                            start_spi0         = 1'b1;
-                            start_spi0_is_load = 1'b0;
-                            start_spi0_addr    = addr_store_candidate;
-                            start_spi0_wdata   = ex_rs2_val;
-                        end else if (store_hits_i2c0) begin
-                            start_i2c0         = 1'b1;
-                            start_i2c0_is_load = 1'b0;
-                            start_i2c0_addr    = addr_store_candidate;
-                            start_i2c0_wdata   = ex_rs2_val;
-                        end else if (store_hits_can0) begin
-                            start_can0         = 1'b1;
-                            start_can0_is_load = 1'b0;
-                            start_can0_addr    = addr_store_candidate;
-                            start_can0_wdata   = ex_rs2_val;
-                        end else if (store_hits_timer0) begin
-                            start_timer0         = 1'b1;
-                            start_timer0_is_load = 1'b0;
-                            start_timer0_addr    = addr_store_candidate;
-                            start_timer0_wdata   = ex_rs2_val;
-                        end else if (store_hits_adc0) begin
-                            start_adc0         = 1'b1;
-                            start_adc0_is_load = 1'b0;
-                            start_adc0_addr    = addr_store_candidate;
-                            start_adc0_wdata   = ex_rs2_val;
+                        if (store_hits_pbus) begin
+                            pbus_req       = 1'b1;
+                            pbus_req_write = 1'b1;
+                            pbus_req_addr  = addr_store_candidate;
+                            pbus_req_wdata = ex_rs2_val;
+                        end else if (store_hits_imem) begin
+                            // IMEM is read-only from the data side
+                            trap_request    = 1'b1;
+                            trap_target     = csr_mtvec;
+                            trap_cause      = MCAUSE_STORE_FAULT;
+                            trap_mepc_value = ex_pc;
                         end else if (!dmem_pending) begin
                             start_mem         = 1'b1;
                             start_mem_is_load = 1'b0;
                             start_mem_addr    = addr_store_candidate;
                             start_mem_wdata   = ex_rs2_val;
                         end
-                        if (!store_hits_gpio && !store_hits_uart0 && !store_hits_spi0 && !store_hits_i2c0 && !store_hits_can0 && !store_hits_timer0 && !store_hits_adc0)
+                        if (!store_hits_pbus && !store_hits_imem)
                             stall_ex = (dmem_pending && !mem_ready_in) || start_mem;
                     end else begin
                         illegal_instr = 1'b1;
                     end
                 end
 
+                7'b0101111: begin // AMO
+                    if (!amo_legal) begin
+                        illegal_instr = 1'b1;
+                    end else if (amo_misaligned || amo_hits_pbus || amo_hits_imem) begin
+                        // Atomics are only defined on DMEM; peripherals and IMEM fault.
+                        trap_request    = 1'b1;
+                        trap_target     = csr_mtvec;
+                        trap_mepc_value = ex_pc;
+                        if (amo_is_lr)
+                            trap_cause = amo_misaligned ? MCAUSE_LOAD_MISALIGNED : MCAUSE_LOAD_FAULT;
+                        else
+                            trap_cause = amo_misaligned ? MCAUSE_STORE_MISALIGNED : MCAUSE_STORE_FAULT;
+                    end else begin
+                        case (amo_state)
+                            AMO_IDLE: begin
+                                if (dmem_pending) begin
+                                    stall_ex = 1'b1;
+                                end else if (amo_is_sc && !sc_hit) begin
+                                    rf_we    = 1'b1;
+                                    rf_waddr = rd;
+                                    rf_wdata = 32'd1;
+                                end else begin
+                                    // LR / RMW read, or a successful SC write.
+                                    start_mem         = 1'b1;
+                                    start_mem_is_load = !amo_is_sc;
+                                    start_mem_addr    = ex_rs1_val;
+                                    start_mem_wdata   = ex_rs2_val;
+                                    start_mem_rd      = rd;
+                                    stall_ex          = 1'b1;
+                                    if (amo_is_sc) begin
+                                        rf_we    = 1'b1;
+                                        rf_waddr = rd;
+                                        rf_wdata = 32'd0;
+                                    end
+                                end
+                            end
+                            AMO_READ: stall_ex = 1'b1; // old value commits to rd
+                            AMO_WRITE: begin
+                                start_mem         = 1'b1;
+                                start_mem_is_load = 1'b0;
+                                start_mem_addr    = ex_rs1_val;
+                                start_mem_wdata   = amo_result;
+                                stall_ex          = 1'b1;
+                            end
+                            default: stall_ex = dmem_pending && !mem_ready_in;
+                        endcase
+                    end
+                end
+
                 7'b1100011: begin // BRANCH
-                    case (funct3)
-                        3'b000: branch_taken = (ex_rs1_val == ex_rs2_val); // BEQ
-                        3'b001: branch_taken = (ex_rs1_val != ex_rs2_val); // BNE
-                        3'b100: branch_taken = ($signed(ex_rs1_val) < $signed(ex_rs2_val)); // BLT
-                        3'b101: branch_taken = ($signed(ex_rs1_val) >= $signed(ex_rs2_val)); // BGE
-                        3'b110: branch_taken = (ex_rs1_val < ex_rs2_val);   // BLTU
-                        3'b111: branch_taken = (ex_rs1_val >= ex_rs2_val);  // BGEU
-                        default: illegal_instr = 1'b1;
-                    endcase
+                    if (funct3 == 3'b010 || funct3 == 3'b011)
+                        illegal_instr = 1'b1;
+                    else
+                        branch_taken = ex_cond_met;
                     if (branch_taken) begin
                         branch_target = ex_pc + imm_b;
                         flush_pipe    = 1'b1;
@@ -825,7 +1226,7 @@ module qar_core #(
                 7'b1101111: begin // JAL
                     rf_we        = 1'b1;
                     rf_waddr     = rd;
-                    rf_wdata     = pc_plus4;
+                    rf_wdata     = pc_next;
                     branch_taken = 1'b1;
                     branch_target= ex_pc + imm_j;
                     flush_pipe   = 1'b1;
@@ -835,7 +1236,7 @@ module qar_core #(
                     if (funct3 == 3'b000) begin
                         rf_we        = 1'b1;
                         rf_waddr     = rd;
-                        rf_wdata     = pc_plus4;
+                        rf_wdata     = pc_next;
                         branch_taken = 1'b1;
                         branch_target= { jalr_sum[31:1], 1'b0 };
                         flush_pipe   = 1'b1;
@@ -871,15 +1272,32 @@ module qar_core #(
                         trap_target     = csr_mtvec;
                         trap_cause      = MCAUSE_ECALL;
                         trap_mepc_value = ex_pc;
+                    end else if (wfi_in_ex) begin
+                        // Retires once any enabled interrupt is pending,
+                        // whether or not mstatus.MIE lets it trap.
+                        stall_ex = !wfi_wake;
                     end else if (funct3 == 3'b000 && ex_instr[31:20] == 12'h302) begin
-                        branch_taken = 1'b1;
-                        branch_target= csr_mepc;
-                        flush_pipe   = 1'b1;
+                        // Drain posted stores first so a handler's final
+                        // IRQ-status clear lands before MIE is restored.
+                        if (pb_write_strobe) begin
+                            stall_ex = 1'b1;
+                        end else begin
+                            branch_taken = 1'b1;
+                            branch_target= csr_mepc;
+                            flush_pipe   = 1'b1;
+                        end
                     end else begin
                         illegal_instr = 1'b1;
                     end
                 end
 
+                7'b0001111: begin // FENCE
+                    if (funct3 == 3'b000)
+                        stall_ex = pb_valid;
+                    else
+                        illegal_instr = 1'b1;
+                end
+
                 7'b0110111: begin // LUI
                     rf_we    = 1'b1;
                     rf_waddr = rd;
@@ -918,25 +1336,29 @@ module qar_core #(
                 trap_target     = csr_mtvec;
                 trap_cause      = MCAUSE_TIMER_IRQ;
                 if (ex_valid)
-                    trap_mepc_value = ex_pc;
+                    trap_mepc_value = wfi_in_ex ? pc_next : ex_pc;
+                else if (exu_valid)
+                    trap_mepc_value = exu_pc;
                 else if (id_valid)
                     trap_mepc_value = id_pc;
                 else if (if_valid)
-                    trap_mepc_value = if_pc;
+                    trap_mepc_value = align_pc;
                 else
-                    trap_mepc_value = pc_fetch;
+                    trap_mepc_value = fetch_resume_pc;
             end else if (take_ext_irq) begin
                 trap_request    = 1'b1;
                 trap_target     = csr_mtvec;
                 trap_cause      = MCAUSE_EXT_IRQ;
                 if (ex_valid)
-                    trap_mepc_value = ex_pc;
+                    trap_mepc_value = wfi_in_ex ? pc_next : ex_pc;
+                else if (exu_valid)
+                    trap_mepc_value = exu_pc;
                 else if (id_valid)
                     trap_mepc_value = id_pc;
                 else if (if_valid)
-                    trap_mepc_value = if_pc;
+                    trap_mepc_value = align_pc;
                 else
-                    trap_mepc_value = pc_fetch;
+                    trap_mepc_value = fetch_resume_pc;
             end
         end
     end
@@ -945,7 +1367,10 @@ module qar_core #(
     // Interrupt detection
     // ------------------------------------------------------------
     wire timer_trigger_level = ((csr_mtime >= csr_mtimecmp) || irq_timer || timer0_irq);
-    wire external_trigger_level = irq_external | uart0_irq | can0_irq | gpio_irq | spi0_irq | i2c0_irq | adc0_irq;
+    // With the PLIC disabled every source is OR-ed onto MEIP (legacy mode);
+    // once enabled, MEIP follows the PLIC's priority/threshold decision.
+    wire legacy_external_level = irq_external | (|uart_irq) | (|can_irq) | gpio_irq | (|spi_irq) | (|i2c_irq) | adc0_irq;
+    wire external_trigger_level = plic0_enabled ? plic0_irq : legacy_external_level;
     wire timer_pending   = csr_mip[7];
     wire external_pending= csr_mip[11];
     
@@ -954,28 +1379,77 @@ module qar_core #(
     wire ext_enabled   = csr_mie[11];
 
     wire timer_can_fire = global_mie && timer_enabled && timer_pending;
+    wire wfi_wake       = (timer_enabled && timer_pending) || (ext_enabled && external_pending);
     wire ext_can_fire   = global_mie && ext_enabled && external_pending;
 
-    wire take_timer_irq = timer_can_fire && (!ext_can_fire || !csr_irq_priority);
-    wire take_ext_irq   = ext_can_fire && (!timer_can_fire || csr_irq_priority);
+    // A peripheral load in its access phase retires this cycle; taking an
+    // interrupt now would replay it and repeat read side effects (FIFO pops,
+    // PLIC claims), so interrupts wait one cycle. An AMO in EX likewise
+    // finishes its read-modify-write before the trap is taken.
+    wire irq_hold       = pb_read_strobe || amo_in_ex;
+    wire take_timer_irq = !irq_hold && timer_can_fire && (!ext_can_fire || !csr_irq_priority);
+    wire take_ext_irq   = !irq_hold && ext_can_fire && (!timer_can_fire || csr_irq_priority);
+
+    // ------------------------------------------------------------
+    // Trace buffer: observes what leaves EX, never stalls the pipeline
+    // ------------------------------------------------------------
+    wire trace_retire = ex_active && !trap_request && (flush_pipe || !stall_ex);
+
+    generate
+        if (TRACE_DEPTH > 0) begin : g_trace
+            qar_trace #(
+                .DEPTH(TRACE_DEPTH)
+            ) trace0 (
+                .clk       (clk),
+                .rst_n     (rst_n),
+                .bus_write (trace0_write_en),
+                .bus_read  (trace0_read_en),
+                .addr_word (trace0_addr_word),
+                .wdata     (pb_wdata),
+                .rdata     (trace0_read_data),
+                .ev_retire (trace_retire),
+                .ev_pc     (ex_pc),
+                .ev_branch (trace_retire && opcode == 7'b1100011),
+                .ev_taken  (branch_taken),
+                .ev_jump   (trace_retire && flush_pipe &&
+                            (opcode == 7'b1100111 || opcode == 7'b1110011)),
+                .ev_target (branch_target),
+                .ev_trap   (trap_request),
+                .ev_cause  (trap_cause),
+                .ev_mepc   (trap_mepc_value),
+                .mtime     (csr_mtime)
+            );
+        end else begin : g_no_trace
+            assign trace0_read_data = 32'b0;
+        end
+    endgenerate
 
     // ------------------------------------------------------------
     // Pipeline + state update
     // ------------------------------------------------------------
     wire ex_can_accept = !ex_valid || !stall_ex;
-    wire id_stall = load_use_hazard || (!ex_can_accept && id_valid);
-    wire id_accept = if_valid && !id_valid && !id_stall;
+    // Five-stage: EX holds on a late-result hazard or a stalled MEM
+    wire exu_advance    = exu_valid && !exu_hazard && ex_can_accept;
+    wire exu_can_accept = !exu_valid || exu_advance;
+    wire id_can_issue   = (PIPELINE_STAGES == 5) ? exu_can_accept : ex_can_accept;
+    wire id_stall = load_use_hazard || (!id_can_issue && id_valid);
+    wire id_accept = align_ready && !id_valid && !id_stall;
+    wire if_pop = id_accept && align_pop;
     wire [1:0] if_buf_count = if_valid ? 2'd1 : 2'd0;
     wire [1:0] slot_buf_count = prefetch_slot_valid ? 2'd1 : 2'd0;
     wire [1:0] fetch_buffer_occupancy = if_buf_count + slot_buf_count;
-    wire slot_to_if = prefetch_slot_valid && (!if_valid || id_accept);
-    wire if_fetch_target = (!if_valid || id_accept) && !slot_to_if;
+    wire slot_to_if = prefetch_slot_valid && (!if_valid || if_pop);
+    wire if_fetch_target = (!if_valid || if_pop) && !slot_to_if;
+    wire [31:0] redirect_pc = trap_request ? trap_target : branch_target;
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             pc_fetch          <= 32'b0;
+            align_off         <= 1'b0;
             fetch_req_pending <= 1'b0;
             fetch_req_addr    <= 32'b0;
+            iload_pending     <= 1'b0;
+            iload_addr        <= 32'b0;
             if_valid          <= 1'b0;
             if_instr          <= 32'b0;
             if_pc             <= 32'b0;
@@ -988,18 +1462,40 @@ module qar_core #(
             id_valid          <= 1'b0;
             id_instr          <= 32'b0;
             id_pc             <= 32'b0;
+            id_is_rvc         <= 1'b0;
             ex_valid          <= 1'b0;
             ex_instr          <= 32'b0;
             ex_pc             <= 32'b0;
+            ex_is_rvc         <= 1'b0;
             ex_rs1_val        <= 32'b0;
             ex_rs2_val        <= 32'b0;
+            ex_result         <= 32'b0;
+            ex_agu_addr       <= 32'b0;
+            ex_branch_cond    <= 1'b0;
+            exu_valid         <= 1'b0;
+            exu_instr         <= 32'b0;
+            exu_pc            <= 32'b0;
+            exu_is_rvc        <= 1'b0;
+            exu_rs1_val       <= 32'b0;
+            exu_rs2_val       <= 32'b0;
+            wb_we             <= 1'b0;
+            wb_waddr          <= 5'd0;
+            wb_wdata          <= 32'b0;
             dmem_pending      <= 1'b0;
             dmem_is_load      <= 1'b0;
             dmem_rd           <= 5'd0;
+            amo_state         <= AMO_IDLE;
+            amo_loaded        <= 32'b0;
+            resv_valid        <= 1'b0;
+            resv_addr         <= 32'b0;
             mem_req_valid     <= 1'b0;
             mem_req_we        <= 1'b0;
             mem_req_addr      <= 32'b0;
             mem_req_wdata     <= {DMEM_DATA_WIDTH{1'b0}};
+            pb_valid          <= 1'b0;
+            pb_write          <= 1'b0;
+            pb_addr           <= 32'b0;
+            pb_wdata          <= 32'b0;
             csr_mstatus       <= 32'b0;
             csr_mtvec         <= 32'h00000100;
             csr_mepc          <= 32'b0;
@@ -1009,6 +1505,7 @@ module qar_core #(
             csr_mtime         <= 32'b0;
             csr_mtimecmp      <= 32'd200;
             csr_irq_priority  <= 1'b0;
+            csr_idle_cycles   <= 32'b0;
             irq_timer_ack     <= 1'b0;
             irq_external_ack  <= 1'b0;
             for (icache_init_idx = 0; icache_init_idx < REAL_ICACHE_ENTRIES; icache_init_idx = icache_init_idx + 1) begin
@@ -1020,6 +1517,8 @@ module qar_core #(
             irq_timer_ack    <= 1'b0;
             irq_external_ack <= 1'b0;
             csr_mtime <= csr_mtime + 32'd1;
+            if (core_sleep)
+                csr_idle_cycles <= csr_idle_cycles + 32'd1;
             if (csr_write_en && csr_write_addr == CSR_ADDR_MIP) begin
                 csr_mip <= csr_write_data;
             end else begin
@@ -1029,15 +1528,44 @@ module qar_core #(
 
             // Fetch management
             if (trap_request || flush_pipe) begin
-                pc_fetch            <= trap_request ? trap_target : branch_target;
+                // Fetch stays word-aligned; a halfword target only moves
+                // the aligner to the upper half of the first word.
+                if (RVC_ENABLE != 0) begin
+                    pc_fetch  <= {redirect_pc[31:2], 2'b00};
+                    align_off <= redirect_pc[1];
+                end else begin
+                    pc_fetch  <= redirect_pc;
+                end
                 fetch_req_pending   <= 1'b0;
                 fetch_req_cacheable <= 1'b0;
                 if_valid            <= 1'b0;
                 prefetch_slot_valid <= 1'b0;
                 id_valid            <= 1'b0;
+                exu_valid           <= 1'b0;
                 ex_valid            <= 1'b0;
             end else begin
-                if (!fetch_req_pending && (fetch_buffer_occupancy < PREFETCH_DEPTH)) begin
+                if (id_accept) begin
+                    id_valid  <= 1'b1;
+                    id_instr  <= align_instr;
+                    id_pc     <= align_pc;
+                    id_is_rvc <= align_is_rvc;
+                    if (align_pop)
+                        if_valid <= 1'b0;
+                    if (align_is_rvc)
+                        align_off <= !align_off;
+                end
+
+                if (slot_to_if) begin
+                    if_valid            <= 1'b1;
+                    if_instr            <= prefetch_slot_instr;
+                    if_pc               <= prefetch_slot_pc;
+                    prefetch_slot_valid <= 1'b0;
+                end
+
+                // Issue after the pop and the slot move above: a hit lands in
+                // IF or the slot in the same edge they are vacated.
+                if (!fetch_req_pending && !iload_pending && !iload_start && !core_sleep &&
+                    (fetch_buffer_occupancy < PREFETCH_DEPTH)) begin
                     if (icache_lookup_hit) begin
                         if (if_fetch_target) begin
                             if_valid <= 1'b1;
@@ -1059,20 +1587,6 @@ module qar_core #(
                     end
                 end
 
-                if (id_accept) begin
-                    id_valid <= 1'b1;
-                    id_instr <= if_instr;
-                    id_pc    <= if_pc;
-                    if_valid <= 1'b0;
-                end
-
-                if (slot_to_if) begin
-                    if_valid            <= 1'b1;
-                    if_instr            <= prefetch_slot_instr;
-                    if_pc               <= prefetch_slot_pc;
-                    prefetch_slot_valid <= 1'b0;
-                end
-
                 if (fetch_req_pending && imem_ready_in) begin
                     fetch_req_pending <= 1'b0;
                     if (if_fetch_target) begin
@@ -1092,10 +1606,43 @@ module qar_core #(
                     fetch_req_cacheable <= 1'b0;
                 end
 
-                if (id_valid && !id_stall && ex_can_accept) begin
+                if (PIPELINE_STAGES == 5) begin
+                    if (exu_advance) begin
+                        ex_valid       <= 1'b1;
+                        ex_instr       <= exu_instr;
+                        ex_pc          <= exu_pc;
+                        ex_is_rvc      <= exu_is_rvc;
+                        ex_rs1_val     <= exu_op1;
+                        ex_rs2_val     <= exu_op2;
+                        ex_result      <= exu_result;
+                        ex_agu_addr    <= exu_agu_addr;
+                        ex_branch_cond <= branch_cond(exu_instr[14:12], exu_op1, exu_op2);
+                        exu_valid      <= 1'b0;
+                    end else begin
+                        if (ex_valid && !stall_ex)
+                            ex_valid <= 1'b0;
+                        // A held instruction keeps collecting forwarded
+                        // values; its producers drain past WB meanwhile.
+                        if (exu_valid) begin
+                            exu_rs1_val <= exu_op1;
+                            exu_rs2_val <= exu_op2;
+                        end
+                    end
+
+                    if (id_valid && !id_stall) begin
+                        exu_valid   <= 1'b1;
+                        exu_instr   <= id_instr;
+                        exu_pc      <= id_pc;
+                        exu_is_rvc  <= id_is_rvc;
+                        exu_rs1_val <= forward_rs1;
+                        exu_rs2_val <= forward_rs2;
+                        id_valid    <= 1'b0;
+                    end
+                end else if (id_valid && !id_stall && ex_can_accept) begin
                     ex_valid   <= 1'b1;
                     ex_instr   <= id_instr;
                     ex_pc      <= id_pc;
+                    ex_is_rvc  <= id_is_rvc;
                     ex_rs1_val <= forward_rs1;
                     ex_rs2_val <= forward_rs2;
                     id_valid   <= 1'b0;
@@ -1104,6 +1651,31 @@ module qar_core #(
                 end
             end
 
+            // Five-stage WB: the MEM write port, one cycle later
+            wb_we    <= rf_we;
+            wb_waddr <= rf_waddr;
+            wb_wdata <= rf_wdata;
+
+            // Peripheral bus stage: one access phase per request. Requests
+            // from an instruction that is being trapped are dropped.
+            pb_valid <= pbus_req && !trap_request;
+            if (pbus_req && !trap_request) begin
+                pb_write <= pbus_req_write;
+                pb_addr  <= pbus_req_addr;
+                pb_wdata <= pbus_req_wdata;
+            end
+
+            // IMEM data port. Reads have no side effects, so a trap simply
+            // abandons the request, as a fetch flush does.
+            if (trap_request) begin
+                iload_pending <= 1'b0;
+            end else if (iload_start) begin
+                iload_pending <= 1'b1;
+                iload_addr    <= addr_load_candidate;
+            end else if (iload_pending && imem_ready_in) begin
+                iload_pending <= 1'b0;
+            end
+
             if (start_mem && !dmem_pending) begin
                 mem_req_valid <= 1'b1;
                 mem_req_we    <= !start_mem_is_load;
@@ -1120,6 +1692,36 @@ module qar_core #(
 `endif
             end
 
+            if (trap_request) begin
+                amo_state  <= AMO_IDLE;
+                resv_valid <= 1'b0;
+            end else if (amo_in_ex && amo_legal) begin
+                case (amo_state)
+                    AMO_IDLE: begin
+                        if (!dmem_pending && amo_is_sc)
+                            resv_valid <= 1'b0;
+                        if (start_mem) begin
+                            amo_state <= amo_is_rmw ? AMO_READ : AMO_DONE;
+                            if (amo_is_lr) begin
+                                resv_valid <= 1'b1;
+                                resv_addr  <= ex_rs1_val;
+                            end
+                        end
+                    end
+                    AMO_READ: begin
+                        if (dmem_pending && mem_ready_in) begin
+                            amo_loaded <= mem_rdata_word;
+                            amo_state  <= AMO_WRITE;
+                        end
+                    end
+                    AMO_WRITE: amo_state <= AMO_DONE;
+                    default: begin
+                        if (!stall_ex)
+                            amo_state <= AMO_IDLE;
+                    end
+                endcase
+            end
+
             if (csr_write_en) begin
                 case (csr_write_addr)
                     CSR_ADDR_MSTATUS:  csr_mstatus <= csr_write_data;
@@ -1130,6 +1732,7 @@ module qar_core #(
                     CSR_ADDR_MTIME:    csr_mtime   <= csr_write_data;
                     CSR_ADDR_MTIMECMP: csr_mtimecmp<= csr_write_data;
                     CSR_ADDR_IRQ_PRIORITY: csr_irq_priority <= csr_write_data[0];
+                    CSR_ADDR_IDLE_CYCLES:  csr_idle_cycles  <= csr_write_data;
                     CSR_ADDR_IRQ_ACK: begin
                         if (csr_write_data[0])
                             irq_timer_ack <= 1'b1;
@@ -1147,7 +1750,7 @@ module qar_core #(
                 csr_mcause <= trap_cause;
                 csr_mstatus[7] <= csr_mstatus[3];
                 csr_mstatus[3] <= 1'b0;
-            end else if (ex_active && opcode == 7'b1110011 && funct3 == 3'b000 && ex_instr[31:20] == 12'h302 && !illegal_instr) begin
+            end else if (ex_active && !stall_ex && opcode == 7'b1110011 && funct3 == 3'b000 && ex_instr[31:20] == 12'h302 && !illegal_instr) begin
                 csr_mstatus[3] <= csr_mstatus[7];
                 csr_mstatus[7] <= 1'b1;
             end
@@ -0,0 +1,114 @@
+`default_nettype none
+
+// RV32C decompressor: maps a 16-bit compressed instruction onto the
+// equivalent 32-bit RV32I/A encoding so the rest of the pipeline only ever
+// sees full-width instructions. Reserved, RV64-only and floating-point
+// encodings expand to an all-ones word, which EX rejects as illegal.
+module qar_rvc_expand (
+    input  wire [15:0] c,
+    output reg  [31:0] instr
+);
+
+    localparam [31:0] ILLEGAL = 32'hFFFF_FFFF;
+
+    localparam [6:0] OP_IMM = 7'b0010011;
+    localparam [6:0] OP     = 7'b0110011;
+    localparam [6:0] LOAD   = 7'b0000011;
+    localparam [6:0] STORE  = 7'b0100011;
+    localparam [6:0] BRANCH = 7'b1100011;
+    localparam [6:0] JAL    = 7'b1101111;
+    localparam [6:0] JALR   = 7'b1100111;
+    localparam [6:0] LUI    = 7'b0110111;
+
+    wire [4:0]  rd     = c[11:7];
+    wire [4:0]  rs2    = c[6:2];
+    wire [4:0]  rd_p   = {2'b01, c[4:2]};
+    wire [4:0]  rs1_p  = {2'b01, c[9:7]};
+    wire [4:0]  shamt  = c[6:2];
+
+    wire [11:0] imm6        = {{6{c[12]}}, c[12], c[6:2]};
+    wire [11:0] addi4spn_imm = {2'b00, c[10:7], c[12:11], c[5], c[6], 2'b00};
+    wire [11:0] addi16sp_imm = {{3{c[12]}}, c[4:3], c[5], c[2], c[6], 4'b0000};
+    wire [11:0] lw_imm      = {5'b0, c[5], c[12:10], c[6], 2'b00};
+    wire [11:0] lwsp_imm    = {4'b0, c[3:2], c[12], c[6:4], 2'b00};
+    wire [11:0] swsp_imm    = {4'b0, c[8:7], c[12:9], 2'b00};
+    wire [19:0] lui_imm     = {{14{c[12]}}, c[12], c[6:2]};
+    wire [20:0] j_imm       = {{10{c[12]}}, c[8], c[10:9], c[6], c[7], c[2], c[11], c[5:3], 1'b0};
+    wire [12:0] b_imm       = {{5{c[12]}}, c[6:5], c[2], c[11:10], c[4:3], 1'b0};
+
+    wire [31:0] j_word = {j_imm[20], j_imm[10:1], j_imm[11], j_imm[19:12], 5'd0, JAL};
+    wire [31:0] b_word = {b_imm[12], b_imm[10:5], 5'd0, rs1_p, 3'b000, b_imm[4:1], b_imm[11], BRANCH};
+
+    always @(*) begin
+        instr = ILLEGAL;
+        case ({c[15:13], c[1:0]})
+            // ---------------- Quadrant 0 ----------------
+            5'b000_00: begin // C.ADDI4SPN
+                if (addi4spn_imm != 12'd0)
+                    instr = {addi4spn_imm, 5'd2, 3'b000, rd_p, OP_IMM};
+            end
+            5'b010_00: instr = {lw_imm, rs1_p, 3'b010, rd_p, LOAD};                          // C.LW
+            5'b110_00: instr = {lw_imm[11:5], rd_p, rs1_p, 3'b010, lw_imm[4:0], STORE};      // C.SW
+
+            // ---------------- Quadrant 1 ----------------
+            5'b000_01: instr = {imm6, rd, 3'b000, rd, OP_IMM};                               // C.ADDI / C.NOP
+            5'b001_01: instr = {j_word[31:12], 5'd1, JAL};                                   // C.JAL
+            5'b010_01: instr = {imm6, 5'd0, 3'b000, rd, OP_IMM};                             // C.LI
+            5'b011_01: begin
+                if (rd == 5'd2) begin                                                        // C.ADDI16SP
+                    if (addi16sp_imm != 12'd0)
+                        instr = {addi16sp_imm, 5'd2, 3'b000, 5'd2, OP_IMM};
+                end else if (imm6 != 12'd0) begin                                            // C.LUI
+                    instr = {lui_imm, rd, LUI};
+                end
+            end
+            5'b100_01: begin
+                case (c[11:10])
+                    2'b00: if (!c[12]) instr = {7'b0000000, shamt, rs1_p, 3'b101, rs1_p, OP_IMM}; // C.SRLI
+                    2'b01: if (!c[12]) instr = {7'b0100000, shamt, rs1_p, 3'b101, rs1_p, OP_IMM}; // C.SRAI
+                    2'b10: instr = {imm6, rs1_p, 3'b111, rs1_p, OP_IMM};                          // C.ANDI
+                    default: begin
+                        if (!c[12]) begin
+                            case (c[6:5])
+                                2'b00: instr = {7'b0100000, rd_p, rs1_p, 3'b000, rs1_p, OP};      // C.SUB
+                                2'b01: instr = {7'b0000000, rd_p, rs1_p, 3'b100, rs1_p, OP};      // C.XOR
+                                2'b10: instr = {7'b0000000, rd_p, rs1_p, 3'b110, rs1_p, OP};      // C.OR
+                                default: instr = {7'b0000000, rd_p, rs1_p, 3'b111, rs1_p, OP};    // C.AND
+                            endcase
+                        end
+                    end
+                endcase
+            end
+            5'b101_01: instr = j_word;                                                       // C.J
+            5'b110_01: instr = b_word;                                                       // C.BEQZ
+            5'b111_01: instr = {b_word[31:15], 3'b001, b_word[11:0]};                        // C.BNEZ
+
+            // ---------------- Quadrant 2 ----------------
+            5'b000_10: if (!c[12]) instr = {7'b0000000, shamt, rd, 3'b001, rd, OP_IMM};      // C.SLLI
+            5'b010_10: if (rd != 5'd0) instr = {lwsp_imm, 5'd2, 3'b010, rd, LOAD};           // C.LWSP
+            5'b100_10: begin
+                if (!c[12]) begin
+                    if (rs2 == 5'd0) begin
+                        if (rd != 5'd0) instr = {12'd0, rd, 3'b000, 5'd0, JALR};             // C.JR
+                    end else begin
+                        instr = {7'b0000000, rs2, 5'd0, 3'b000, rd, OP};                     // C.MV
+                    end
+                end else begin
+                    if (rs2 == 5'd0) begin
+                        if (rd == 5'd0)
+                            instr = 32'h0010_0073;                                           // C.EBREAK
+                        else
+                            instr = {12'd0, rd, 3'b000, 5'd1, JALR};                         // C.JALR
+                    end else begin
+                        instr = {7'b0000000, rs2, rd, 3'b000, rd, OP};                       // C.ADD
+                    end
+                end
+            end
+            5'b110_10: instr = {swsp_imm[11:5], rs2, 5'd2, 3'b010, swsp_imm[4:0], STORE};   // C.SWSP
+            default: instr = ILLEGAL;
+        endcase
+    end
+
+endmodule
+
+`default_nettype wire
@@ -1,7 +1,8 @@
 `default_nettype none
 
 module qar_timer #(
-    parameter CLK_HZ = 50_000_000
+    parameter CLK_HZ = 50_000_000,
+    parameter ICAP_DEPTH = 8
 ) (
     input  wire        clk,
     input  wire        rst_n,
@@ -12,9 +13,28 @@ module qar_timer #(
     output reg  [31:0] rdata,
     output wire        irq,
     output wire        pwm0,
-    output wire        pwm1
+    output wire        pwm1,
+    output reg         evt_cmp0,
+    output reg         evt_cmp1,
+    input  wire        trig_capture0,
+    input  wire        trig_capture1,
+    input  wire        trig_pwm_update,
+    input  wire [31:0] cap_in
 );
 
+    function integer clog2;
+        input integer value;
+        integer i;
+        begin
+            value = value - 1;
+            for (i = 0; value > 0; i = i + 1)
+                value = value >> 1;
+            clog2 = i;
+        end
+    endfunction
+
+    localparam integer ICAP_ADDR_BITS = clog2(ICAP_DEPTH);
+
     reg [31:0] ctrl;
     reg [31:0] prescale;
     reg [31:0] counter;
@@ -31,6 +51,8 @@ module qar_timer #(
     reg [31:0] pwm0_duty;
     reg [31:0] pwm1_period;
     reg [31:0] pwm1_duty;
+    reg [31:0] pwm0_duty_shadow;
+    reg [31:0] pwm1_duty_shadow;
     reg [31:0] capture_ctrl;
     reg [31:0] capture0_value;
     reg [31:0] capture1_value;
@@ -41,9 +63,50 @@ module qar_timer #(
 
     reg [31:0] prescale_cnt;
 
+    // Input capture: pins are double-flopped, then each channel timestamps
+    // the selected edges of one pin into its own FIFO.
+    reg [31:0] cap_sync1;
+    reg [31:0] cap_sync2;
+    reg [31:0] cap_last;
+    reg        icap0_enable;
+    reg [1:0]  icap0_edge;
+    reg [4:0]  icap0_pin;
+    reg [ICAP_ADDR_BITS:0] icap0_watermark;
+    reg        icap0_ovf;
+    reg [ICAP_ADDR_BITS:0] icap0_head, icap0_tail;
+    reg [31:0] icap0_mem [0:ICAP_DEPTH-1];
+    reg        icap1_enable;
+    reg [1:0]  icap1_edge;
+    reg [4:0]  icap1_pin;
+    reg [ICAP_ADDR_BITS:0] icap1_watermark;
+    reg        icap1_ovf;
+    reg [ICAP_ADDR_BITS:0] icap1_head, icap1_tail;
+    reg [31:0] icap1_mem [0:ICAP_DEPTH-1];
+
+    wire [ICAP_ADDR_BITS:0] icap0_level = icap0_head - icap0_tail;
+    wire [ICAP_ADDR_BITS:0] icap1_level = icap1_head - icap1_tail;
+    wire icap0_empty = (icap0_head == icap0_tail);
+    wire icap1_empty = (icap1_head == icap1_tail);
+    wire icap0_full  = (icap0_level == ICAP_DEPTH);
+    wire icap1_full  = (icap1_level == ICAP_DEPTH);
+    wire [4:0] icap0_level_field = icap0_level;
+    wire [4:0] icap1_level_field = icap1_level;
+    wire [3:0] icap0_watermark_field = icap0_watermark;
+    wire [3:0] icap1_watermark_field = icap1_watermark;
+
+    wire icap0_now  = cap_sync2[icap0_pin];
+    wire icap0_prev = cap_last[icap0_pin];
+    wire icap1_now  = cap_sync2[icap1_pin];
+    wire icap1_prev = cap_last[icap1_pin];
+    wire icap0_hit = icap0_enable &&
+        ((icap0_edge[0] && icap0_now && !icap0_prev) || (icap0_edge[1] && !icap0_now && icap0_prev));
+    wire icap1_hit = icap1_enable &&
+        ((icap1_edge[0] && icap1_now && !icap1_prev) || (icap1_edge[1] && !icap1_now && icap1_prev));
+
     wire counter_enable     = ctrl[0];
     wire cmp0_auto_reload   = ctrl[1];
     wire cmp1_auto_reload   = ctrl[2];
+    wire pwm_sync           = ctrl[3];
 
     assign irq = |(status & irq_en);
 
@@ -65,6 +128,10 @@ module qar_timer #(
             pwm0_duty    <= 32'h0;
             pwm1_period  <= 32'h0;
             pwm1_duty    <= 32'h0;
+            pwm0_duty_shadow <= 32'h0;
+            pwm1_duty_shadow <= 32'h0;
+            evt_cmp0     <= 1'b0;
+            evt_cmp1     <= 1'b0;
             capture_ctrl <= 32'h0;
             capture0_value <= 32'h0;
             capture1_value <= 32'h0;
@@ -73,7 +140,30 @@ module qar_timer #(
             pwm0_out     <= 1'b0;
             pwm1_out     <= 1'b0;
             prescale_cnt <= 32'h0;
+            cap_sync1    <= 32'h0;
+            cap_sync2    <= 32'h0;
+            cap_last     <= 32'h0;
+            icap0_enable <= 1'b0;
+            icap0_edge   <= 2'b01;
+            icap0_pin    <= 5'd0;
+            icap0_watermark <= 1;
+            icap0_ovf    <= 1'b0;
+            icap0_head   <= 0;
+            icap0_tail   <= 0;
+            icap1_enable <= 1'b0;
+            icap1_edge   <= 2'b01;
+            icap1_pin    <= 5'd0;
+            icap1_watermark <= 1;
+            icap1_ovf    <= 1'b0;
+            icap1_head   <= 0;
+            icap1_tail   <= 0;
         end else begin
+            evt_cmp0 <= 1'b0;
+            evt_cmp1 <= 1'b0;
+            cap_sync1 <= cap_in;
+            cap_sync2 <= cap_sync1;
+            cap_last  <= cap_sync2;
+
             // Register writes
             if (bus_write) begin
                 case (addr_word)
@@ -108,12 +198,20 @@ module qar_timer #(
                         pwm0_period  <= wdata;
                         pwm0_counter <= 32'h0;
                     end
-                    6'hD: pwm0_duty <= wdata;
+                    6'hD: begin
+                        pwm0_duty_shadow <= wdata;
+                        if (!pwm_sync)
+                            pwm0_duty <= wdata;
+                    end
                     6'hE: begin
                         pwm1_period  <= wdata;
                         pwm1_counter <= 32'h0;
                     end
-                    6'hF: pwm1_duty <= wdata;
+                    6'hF: begin
+                        pwm1_duty_shadow <= wdata;
+                        if (!pwm_sync)
+                            pwm1_duty <= wdata;
+                    end
                     6'h11: begin
                         capture_ctrl <= wdata;
                         if (wdata[0]) begin
@@ -125,10 +223,80 @@ module qar_timer #(
                             status[4] <= 1'b1;
                         end
                     end
+                    6'h14: begin
+                        icap0_enable <= wdata[0];
+                        icap0_edge   <= wdata[2:1];
+                        icap0_pin    <= wdata[8:4];
+                        icap0_watermark <= (wdata[15:12] == 4'd0) ? 1 : wdata[ICAP_ADDR_BITS+12:12];
+                        if (wdata[16]) begin
+                            icap0_tail <= icap0_head;
+                            icap0_ovf  <= 1'b0;
+                        end
+                    end
+                    6'h15: begin
+                        icap1_enable <= wdata[0];
+                        icap1_edge   <= wdata[2:1];
+                        icap1_pin    <= wdata[8:4];
+                        icap1_watermark <= (wdata[15:12] == 4'd0) ? 1 : wdata[ICAP_ADDR_BITS+12:12];
+                        if (wdata[16]) begin
+                            icap1_tail <= icap1_head;
+                            icap1_ovf  <= 1'b0;
+                        end
+                    end
+                    6'h18: begin
+                        if (wdata[16])
+                            icap0_ovf <= 1'b0;
+                        if (wdata[17])
+                            icap1_ovf <= 1'b0;
+                    end
                     default: ;
                 endcase
             end
 
+            // Capture FIFO pops
+            if (bus_read && addr_word == 6'h16 && !icap0_empty)
+                icap0_tail <= icap0_tail + 1;
+            if (bus_read && addr_word == 6'h17 && !icap1_empty)
+                icap1_tail <= icap1_tail + 1;
+
+            // Input capture pushes (timestamp = current counter value)
+            if (icap0_hit) begin
+                if (!icap0_full) begin
+                    icap0_mem[icap0_head[ICAP_ADDR_BITS-1:0]] <= counter;
+                    icap0_head <= icap0_head + 1;
+                    if ((icap0_level + 1'b1) >= icap0_watermark)
+                        status[5] <= 1'b1;
+                end else begin
+                    icap0_ovf <= 1'b1;
+                    status[7] <= 1'b1;
+                end
+            end
+            if (icap1_hit) begin
+                if (!icap1_full) begin
+                    icap1_mem[icap1_head[ICAP_ADDR_BITS-1:0]] <= counter;
+                    icap1_head <= icap1_head + 1;
+                    if ((icap1_level + 1'b1) >= icap1_watermark)
+                        status[6] <= 1'b1;
+                end else begin
+                    icap1_ovf <= 1'b1;
+                    status[7] <= 1'b1;
+                end
+            end
+
+            // Routed event actions
+            if (trig_capture0) begin
+                capture0_value <= counter;
+                status[3] <= 1'b1;
+            end
+            if (trig_capture1) begin
+                capture1_value <= counter;
+                status[4] <= 1'b1;
+            end
+            if (trig_pwm_update) begin
+                pwm0_duty <= pwm0_duty_shadow;
+                pwm1_duty <= pwm1_duty_shadow;
+            end
+
             // Counter tick
             if (counter_enable) begin
                 if (prescale_cnt >= prescale) begin
@@ -144,11 +312,13 @@ module qar_timer #(
 
                     if (cmp0 != 32'h0 && counter == cmp0) begin
                         status[0] <= 1'b1;
+                        evt_cmp0 <= 1'b1;
                         if (cmp0_auto_reload && cmp0_period != 32'h0)
                             cmp0 <= cmp0 + cmp0_period;
                     end
                     if (cmp1 != 32'h0 && counter == cmp1) begin
                         status[1] <= 1'b1;
+                        evt_cmp1 <= 1'b1;
                         if (cmp1_auto_reload && cmp1_period != 32'h0)
                             cmp1 <= cmp1 + cmp1_period;
                     end
@@ -211,6 +381,11 @@ module qar_timer #(
                 6'h11: rdata = capture_ctrl;
                 6'h12: rdata = capture0_value;
                 6'h13: rdata = capture1_value;
+                6'h14: rdata = {16'b0, icap0_watermark_field, 3'b0, icap0_pin, 1'b0, icap0_edge, icap0_enable};
+                6'h15: rdata = {16'b0, icap1_watermark_field, 3'b0, icap1_pin, 1'b0, icap1_edge, icap1_enable};
+                6'h16: rdata = icap0_empty ? 32'h0 : icap0_mem[icap0_tail[ICAP_ADDR_BITS-1:0]];
+                6'h17: rdata = icap1_empty ? 32'h0 : icap1_mem[icap1_tail[ICAP_ADDR_BITS-1:0]];
+                6'h18: rdata = {14'b0, icap1_ovf, icap0_ovf, 3'b0, icap1_level_field, 3'b0, icap0_level_field};
                 default: rdata = 32'h0;
             endcase
         end
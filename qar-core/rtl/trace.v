@@ -0,0 +1,216 @@
+`default_nettype none
+
+// Branch/exception trace buffer. The core reports what leaves EX (MEM at
+// five stages) each cycle; conditional branches are packed as one
+// taken/not-taken bit each, and only events the program image cannot
+// predict get an entry: an indirect jump or MRET target, a trap, a sync
+// point after enable or a trap, or 20 collected branch bits. Entries are
+// three words (control, address, mtime) in a circular buffer that firmware
+// or a debugger reads back over the peripheral bus; recording costs the
+// traced program no instructions and no cycles.
+module qar_trace #(
+    parameter DEPTH = 32
+) (
+    input  wire        clk,
+    input  wire        rst_n,
+    input  wire        bus_write,
+    input  wire        bus_read,
+    input  wire [3:0]  addr_word,
+    input  wire [31:0] wdata,
+    output reg  [31:0] rdata,
+
+    input  wire        ev_retire,   // an instruction left EX without trapping
+    input  wire [31:0] ev_pc,
+    input  wire        ev_branch,   // ... and it was a conditional branch
+    input  wire        ev_taken,
+    input  wire        ev_jump,     // ... or a JALR/MRET, to ev_target
+    input  wire [31:0] ev_target,
+    input  wire        ev_trap,     // a trap is taken this cycle
+    input  wire [31:0] ev_cause,
+    input  wire [31:0] ev_mepc,
+    input  wire [31:0] mtime
+);
+
+    function integer clog2;
+        input integer value;
+        integer i;
+        begin
+            value = value - 1;
+            for (i = 0; value > 0; i = i + 1)
+                value = value >> 1;
+            clog2 = i;
+        end
+    endfunction
+
+    localparam PTR_BITS  = clog2(DEPTH);
+    localparam HIST_BITS = 20;
+
+    localparam KIND_HIST = 2'd0;
+    localparam KIND_JUMP = 2'd1;
+    localparam KIND_TRAP = 2'd2;
+    localparam KIND_SYNC = 2'd3;
+
+    localparam [4:0] HIST_FULL = HIST_BITS;
+
+    reg [31:0] entry_ctrl [0:DEPTH-1];
+    reg [31:0] entry_addr [0:DEPTH-1];
+    reg [31:0] entry_time [0:DEPTH-1];
+
+    reg                enable;
+    reg                oneshot;
+    reg                freeze_on_fault;
+    reg                frozen;
+    reg                wrapped;
+    reg [PTR_BITS-1:0] wr_ptr;
+    reg [PTR_BITS:0]   level;
+    reg [PTR_BITS-1:0] rd_index;
+    // Branch bits not yet written out; bit 0 is the oldest
+    reg [HIST_BITS-1:0] hist;
+    reg [4:0]           hist_count;
+    reg [31:0]          last_branch_pc;
+    // The next retiring instruction is written as a SYNC entry
+    reg                 sync_pending;
+
+    wire ctrl_write   = bus_write && (addr_word == 4'h0);
+    wire stop_request = ctrl_write && enable && !wdata[0];
+    // ECALL is a request, not a fault; interrupts never freeze the trace
+    wire fault        = ev_trap && !ev_cause[31] && (ev_cause[3:0] != 4'd11);
+
+    wire [HIST_BITS-1:0] taken_bit  = {{(HIST_BITS-1){1'b0}}, ev_taken};
+    wire [HIST_BITS-1:0] hist_next  = ev_branch ? (hist | (taken_bit << hist_count)) : hist;
+    wire [4:0]           count_next = ev_branch ? hist_count + 5'd1 : hist_count;
+
+    reg                 rec;
+    reg [31:0]          rec_ctrl;
+    reg [31:0]          rec_addr;
+    reg [HIST_BITS-1:0] hist_after;
+    reg [4:0]           count_after;
+
+    // At most one entry per cycle; any entry carries the pending history
+    always @(*) begin
+        rec         = 1'b0;
+        rec_ctrl    = {KIND_HIST, count_next, hist_next, 5'b0};
+        rec_addr    = ev_branch ? ev_pc : last_branch_pc;
+        hist_after  = hist_next;
+        count_after = count_next;
+        if (enable) begin
+            if (ev_trap) begin
+                rec      = 1'b1;
+                rec_ctrl = {KIND_TRAP, hist_count, hist, ev_cause[31], ev_cause[3:0]};
+                rec_addr = ev_mepc;
+            end else if (ev_jump) begin
+                rec      = 1'b1;
+                rec_ctrl = {KIND_JUMP, hist_count, hist, 5'b0};
+                rec_addr = ev_target;
+            end else if (ev_retire && sync_pending) begin
+                rec      = 1'b1;
+                rec_ctrl = {KIND_SYNC, hist_count, hist, 5'b0};
+                rec_addr = ev_pc;
+            end else if (count_next == HIST_FULL || (stop_request && count_next != 5'd0)) begin
+                rec      = 1'b1;
+            end
+            if (rec) begin
+                // A branch that is itself the sync point starts the new history
+                hist_after  = (sync_pending && ev_branch) ? taken_bit : {HIST_BITS{1'b0}};
+                count_after = (sync_pending && ev_branch) ? 5'd1 : 5'd0;
+            end
+        end
+    end
+
+    wire [PTR_BITS-1:0] oldest    = (level == DEPTH) ? wr_ptr : {PTR_BITS{1'b0}};
+    wire [PTR_BITS-1:0] read_slot = oldest + rd_index;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            enable          <= 1'b0;
+            oneshot         <= 1'b0;
+            freeze_on_fault <= 1'b0;
+            frozen          <= 1'b0;
+            wrapped         <= 1'b0;
+            wr_ptr          <= {PTR_BITS{1'b0}};
+            level           <= {(PTR_BITS+1){1'b0}};
+            rd_index        <= {PTR_BITS{1'b0}};
+            hist            <= {HIST_BITS{1'b0}};
+            hist_count      <= 5'd0;
+            last_branch_pc  <= 32'b0;
+            sync_pending    <= 1'b0;
+        end else begin
+            if (rec) begin
+                if (oneshot && level == DEPTH) begin
+                    enable <= 1'b0;
+                    frozen <= 1'b1;
+                end else begin
+                    entry_ctrl[wr_ptr] <= rec_ctrl;
+                    entry_addr[wr_ptr] <= rec_addr;
+                    entry_time[wr_ptr] <= mtime;
+                    wr_ptr <= wr_ptr + 1'b1;
+                    if (level == DEPTH)
+                        wrapped <= 1'b1;
+                    else
+                        level <= level + 1'b1;
+                end
+            end
+            if (enable) begin
+                hist       <= hist_after;
+                hist_count <= count_after;
+                if (ev_branch)
+                    last_branch_pc <= ev_pc;
+                if (ev_trap)
+                    sync_pending <= 1'b1;
+                else if (ev_jump || ev_retire)
+                    sync_pending <= 1'b0;
+                if (fault && freeze_on_fault) begin
+                    enable <= 1'b0;
+                    frozen <= 1'b1;
+                end
+            end
+            if (bus_write) begin
+                case (addr_word)
+                    4'h0: begin
+                        enable          <= wdata[0];
+                        oneshot         <= wdata[1];
+                        freeze_on_fault <= wdata[2];
+                        if (wdata[0] && !enable) begin
+                            hist         <= {HIST_BITS{1'b0}};
+                            hist_count   <= 5'd0;
+                            sync_pending <= 1'b1;
+                            frozen       <= 1'b0;
+                        end
+                        // Bit3: empty the buffer
+                        if (wdata[3]) begin
+                            wr_ptr  <= {PTR_BITS{1'b0}};
+                            level   <= {(PTR_BITS+1){1'b0}};
+                            wrapped <= 1'b0;
+                            frozen  <= 1'b0;
+                        end
+                    end
+                    4'h3: rd_index <= wdata[PTR_BITS-1:0];
+                    default: ;
+                endcase
+            end
+        end
+    end
+
+    always @(*) begin
+        rdata = 32'b0;
+        if (bus_read) begin
+            case (addr_word)
+                4'h0: rdata = {29'b0, freeze_on_fault, oneshot, enable};
+                4'h1: begin
+                    rdata[PTR_BITS:0] = level;
+                    rdata[16]         = wrapped;
+                    rdata[17]         = frozen;
+                end
+                4'h2: rdata = DEPTH;
+                4'h3: rdata[PTR_BITS-1:0] = rd_index;
+                4'h4: rdata = entry_ctrl[read_slot];
+                4'h5: rdata = entry_addr[read_slot];
+                4'h6: rdata = entry_time[read_slot];
+                default: rdata = 32'b0;
+            endcase
+        end
+    end
+
+endmodule
+
+`default_nettype wire
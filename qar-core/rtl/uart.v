@@ -15,7 +15,9 @@ module qar_uart #(
     input  wire        rx,
     output reg         rs485_de,
     output reg         rs485_re,
-    output wire        irq
+    output wire        irq,
+    output reg         evt_rx,
+    input  wire        lin_tick
 );
 
     function integer clog2;
@@ -31,6 +33,7 @@ module qar_uart #(
 
     localparam FIFO_ADDR_BITS = clog2(FIFO_DEPTH);
     localparam MAX_FRAME_BITS = 12;
+    localparam LIN_SCHED_DEPTH = 8;
 
     function [MAX_FRAME_BITS-1:0] build_tx_frame;
         input [7:0] data_in;
@@ -116,6 +119,21 @@ module qar_uart #(
     reg [7:0]  lin_slave_bytes_remaining;
     reg        lin_slave_underflow;
 
+    // LIN master schedule table: {resp_len[3:0], slot_ticks[7:0], id[7:0]}
+    reg [19:0] lin_sched_table [0:LIN_SCHED_DEPTH-1];
+    reg [31:0] lin_sched_ctrl;
+    reg        lin_sched_running;
+    reg        lin_sched_fire;
+    reg [2:0]  lin_sched_index;
+    reg [7:0]  lin_sched_slot_left;
+    reg [3:0]  lin_sched_resp_len;
+    reg [3:0]  lin_sched_resp_count;
+    reg        lin_sched_resp_wait;
+    reg        lin_sched_resp_ok;
+    reg [3:0]  lin_sched_flags;
+    reg [2:0]  lin_sched_resp_index;
+    reg [7:0]  lin_sched_resp_id;
+
     reg [7:0] tx_fifo [0:FIFO_DEPTH-1];
     reg [FIFO_ADDR_BITS:0] tx_head, tx_tail;
     reg [7:0] rx_fifo [0:FIFO_DEPTH-1];
@@ -163,6 +181,11 @@ module qar_uart #(
     wire [7:0] lin_slave_match_id  = lin_slave_ctrl[15:8];
     wire [7:0] lin_slave_resp_len  = lin_slave_ctrl[7:0];
     wire        lin_slave_gate_block = lin_slave_enable && lin_slave_armed && !lin_slave_tx_pending;
+    wire        lin_sched_one_shot = lin_sched_ctrl[1];
+    wire [2:0]  lin_sched_last     = lin_sched_ctrl[10:8];
+    wire [19:0] lin_sched_entry    = lin_sched_table[lin_sched_index];
+    wire        lin_master_busy    = lin_auto_header_pending || lin_break_active ||
+                                     (lin_auto_state != 2'b00) || lin_sched_resp_wait;
 
 
     always @(posedge clk or negedge rst_n) begin
@@ -190,6 +213,18 @@ module qar_uart #(
             lin_slave_tx_pending <= 1'b0;
             lin_slave_bytes_remaining <= 8'd0;
             lin_slave_underflow <= 1'b0;
+            lin_sched_ctrl <= 32'b0;
+            lin_sched_running <= 1'b0;
+            lin_sched_fire <= 1'b0;
+            lin_sched_index <= 3'd0;
+            lin_sched_slot_left <= 8'd0;
+            lin_sched_resp_len <= 4'd0;
+            lin_sched_resp_count <= 4'd0;
+            lin_sched_resp_wait <= 1'b0;
+            lin_sched_resp_ok <= 1'b0;
+            lin_sched_flags <= 4'b0;
+            lin_sched_resp_index <= 3'd0;
+            lin_sched_resp_id <= 8'h00;
             tx_head     <= 0;
             tx_tail     <= 0;
             rx_head     <= 0;
@@ -219,7 +254,9 @@ module qar_uart #(
             lin_break_tick    <= 32'b0;
             lin_rx_low_counter<= 32'b0;
             lin_rx_tick       <= 32'b0;
+            evt_rx            <= 1'b0;
         end else begin
+            evt_rx   <= 1'b0;
             rx_sync1 <= rx;
             rx_sync2 <= rx_sync1;
 
@@ -300,6 +337,20 @@ module qar_uart #(
                             lin_slave_underflow <= 1'b0;
                         end
                     end
+                    4'hD: begin
+                        lin_sched_ctrl <= wdata;
+                        if (wdata[0] && !lin_sched_running) begin
+                            lin_sched_running <= 1'b1;
+                            lin_sched_fire <= 1'b1;
+                            lin_sched_index <= 3'd0;
+                        end else if (!wdata[0]) begin
+                            lin_sched_running <= 1'b0;
+                            lin_sched_fire <= 1'b0;
+                            lin_sched_resp_wait <= 1'b0;
+                        end
+                    end
+                    4'hE: lin_sched_table[wdata[26:24]] <= wdata[19:0];
+                    4'hF: lin_sched_flags <= lin_sched_flags & ~wdata[11:8];
                 endcase
             end
 
@@ -466,9 +517,19 @@ module qar_uart #(
                         if (rx_start_error || rx_stop_error) begin
                             status[2] <= 1'b1;
                             irq_status[2] <= 1'b1;
+                            if (lin_sched_resp_wait) begin
+                                lin_sched_resp_wait <= 1'b0;
+                                lin_sched_flags[3] <= 1'b1;
+                                irq_status[8] <= 1'b1;
+                            end
                         end else if (!parity_match(rx_data_latch, rx_parity_enable_latch, rx_parity_odd_latch, rx_parity_latch)) begin
                             status[5] <= 1'b1;
                             irq_status[2] <= 1'b1;
+                            if (lin_sched_resp_wait) begin
+                                lin_sched_resp_wait <= 1'b0;
+                                lin_sched_flags[3] <= 1'b1;
+                                irq_status[8] <= 1'b1;
+                            end
                         end else if (ctrl_lin_mode && lin_header_state != 2'b00) begin
                             if (lin_header_state == 2'b01) begin
                                 lin_sync_byte <= rx_data_latch;
@@ -479,6 +540,18 @@ module qar_uart #(
                                 lin_header_valid <= 1'b1;
                                 lin_header_state <= 2'b00;
                                 irq_status[5] <= 1'b1;
+                                if (lin_sched_running && !lin_sched_fire && lin_sched_resp_len != 4'd0 &&
+                                    !lin_sched_resp_ok && lin_auto_state == 2'b00) begin
+                                    lin_sched_resp_index <= lin_sched_index;
+                                    lin_sched_resp_id <= lin_tx_header_id;
+                                    if (lin_sync_error || rx_data_latch != lin_tx_header_id) begin
+                                        lin_sched_flags[3] <= 1'b1;
+                                        irq_status[8] <= 1'b1;
+                                    end else begin
+                                        lin_sched_resp_wait <= 1'b1;
+                                        lin_sched_resp_count <= 4'd0;
+                                    end
+                                end
                                 if (lin_slave_enable && lin_slave_armed && lin_slave_resp_len != 8'd0 &&
                                     rx_data_latch == lin_slave_match_id) begin
                                     lin_slave_tx_pending <= 1'b1;
@@ -491,9 +564,24 @@ module qar_uart #(
                             rx_fifo[rx_head[FIFO_ADDR_BITS-1:0]] <= rx_data_latch;
                             rx_head <= rx_head + 1;
                             irq_status[0] <= 1'b1;
+                            evt_rx <= 1'b1;
+                            if (lin_sched_resp_wait) begin
+                                lin_sched_resp_count <= lin_sched_resp_count + 1;
+                                if (lin_sched_resp_count + 4'd1 == lin_sched_resp_len) begin
+                                    lin_sched_resp_wait <= 1'b0;
+                                    lin_sched_resp_ok <= 1'b1;
+                                    lin_sched_flags[0] <= 1'b1;
+                                    irq_status[7] <= 1'b1;
+                                end
+                            end
                         end else begin
                             status[3] <= 1'b1;
                             irq_status[2] <= 1'b1;
+                            if (lin_sched_resp_wait) begin
+                                lin_sched_resp_wait <= 1'b0;
+                                lin_sched_flags[3] <= 1'b1;
+                                irq_status[8] <= 1'b1;
+                            end
                         end
                     end
                 end else begin
@@ -533,6 +621,51 @@ module qar_uart #(
                 lin_rx_low_counter <= 32'b0;
                 lin_rx_tick <= 32'b0;
             end
+
+            // LIN master schedule: fire the current entry's header, then count
+            // lin_tick pulses (a timer compare routed through the EVR) until its
+            // slot expires and move on. Only completed responses and errors
+            // reach IRQ_STATUS[8:7]; the per-frame break/header bits still latch
+            // but can stay masked.
+            if (lin_sched_running && ctrl_lin_mode && ctrl_enable) begin
+                if (lin_sched_fire) begin
+                    lin_sched_fire <= 1'b0;
+                    if (lin_master_busy) begin
+                        lin_sched_flags[2] <= 1'b1;
+                        irq_status[8] <= 1'b1;
+                    end
+                    lin_tx_header_id <= lin_sched_entry[7:0];
+                    lin_sched_slot_left <= (lin_sched_entry[15:8] == 8'd0) ? 8'd1 : lin_sched_entry[15:8];
+                    lin_sched_resp_len <= lin_sched_entry[19:16];
+                    lin_sched_resp_count <= 4'd0;
+                    lin_sched_resp_wait <= 1'b0;
+                    lin_sched_resp_ok <= 1'b0;
+                    lin_auto_header_pending <= 1'b1;
+                    lin_break_pending <= 1'b1;
+                end else if (lin_tick) begin
+                    if (lin_sched_slot_left <= 8'd1) begin
+                        if (lin_sched_resp_len != 4'd0 && !lin_sched_resp_ok) begin
+                            lin_sched_flags[1] <= 1'b1;
+                            lin_sched_resp_index <= lin_sched_index;
+                            lin_sched_resp_id <= lin_tx_header_id;
+                            irq_status[8] <= 1'b1;
+                        end
+                        lin_sched_resp_wait <= 1'b0;
+                        if (lin_sched_index == lin_sched_last) begin
+                            lin_sched_index <= 3'd0;
+                            if (lin_sched_one_shot)
+                                lin_sched_running <= 1'b0;
+                            else
+                                lin_sched_fire <= 1'b1;
+                        end else begin
+                            lin_sched_index <= lin_sched_index + 1;
+                            lin_sched_fire <= 1'b1;
+                        end
+                    end else begin
+                        lin_sched_slot_left <= lin_sched_slot_left - 1;
+                    end
+                end
+            end
         end
     end
 
@@ -568,6 +701,10 @@ module qar_uart #(
                 4'hA: rdata = {24'b0, lin_tx_header_id};
                 4'hB: rdata = {16'b0, lin_id_byte, lin_sync_byte};
                 4'hC: rdata = lin_slave_ctrl;
+                4'hD: rdata = lin_sched_ctrl;
+                4'hE: rdata = {5'b0, lin_sched_index, 4'b0, lin_sched_entry};
+                4'hF: rdata = {lin_sched_resp_id, 5'b0, lin_sched_resp_index, 4'b0, lin_sched_flags,
+                               3'b0, lin_sched_resp_wait, lin_sched_running, lin_sched_index};
                 default: rdata = 32'b0;
             endcase
         end
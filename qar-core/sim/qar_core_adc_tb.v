@@ -132,6 +132,17 @@ module qar_core_adc_tb();
             $display("ERROR: ADC channel2 mismatch");
             $finish;
         end
+        $display("DMEM[3] = 0x%08h (expect FIFO ch0 average)", dmem[3]);
+        $display("DMEM[4] = 0x%08h (expect FIFO ch1 average)", dmem[4]);
+        $display("DMEM[5] = 0x%08h (expect ch0 above-window crossing)", dmem[5]);
+        if (dmem[3] !== 32'h8000_0145 || dmem[4] !== 32'h8001_02A7) begin
+            $display("ERROR: ADC FIFO mismatch");
+            $finish;
+        end
+        if (dmem[5] !== 32'h0000_1010) begin
+            $display("ERROR: ADC window comparator mismatch");
+            $finish;
+        end
         $display("ADC demo completed.");
         $finish;
     end
@@ -0,0 +1,369 @@
+`timescale 1ns / 1ps
+
+// BENCH_EXPECTED: result pairs the firmware reports (18 for runtime_bench.c,
+// 6 for sched_bench.c, 7 for dsp_bench.c, 0 for boot_bench.c).
+// PRELOAD_DMEM=0 starts with DMEM unloaded, as after a watchdog reset;
+// WARM_RESETS re-runs the firmware that many times without reloading.
+// Build with -DQAR_PROFILE to also write a per-PC cycle profile for
+// `qarsim profile` (see scripts/run_profile.sh). ICACHE_ENTRIES is passed
+// to the core so layouts can be compared against a cache.
+module qar_core_bench_tb #(
+    parameter BENCH_EXPECTED = 18,
+    parameter PRELOAD_DMEM   = 1,
+    parameter WARM_RESETS    = 0,
+    parameter ICACHE_ENTRIES = 0
+) ();
+
+    localparam IMEM_WORDS = 2048;
+    localparam DMEM_WORDS = 2048;
+    localparam IMEM_ADDR_WIDTH = 11;
+    localparam DMEM_ADDR_WIDTH = 11;
+
+    // The bench firmware reports through this address instead of a UART
+    localparam [31:0] MAILBOX_ADDR = 32'h2FFF_FFF0;
+    localparam [31:0] BENCH_DONE   = 32'hFFFF_FFFF;
+    localparam [31:0] BENCH_MAIN   = 32'hFFFF_FFFE;
+    localparam [31:0] BENCH_FAIL   = 32'hFFFF_FFFD;
+
+    reg clk = 0;
+    reg rst_n = 0;
+
+    wire        imem_valid;
+    wire [31:0] imem_addr;
+    reg         imem_ready;
+    reg  [31:0] imem_rdata;
+
+    wire        mem_valid;
+    wire        mem_we;
+    wire [31:0] mem_addr;
+    wire [31:0] mem_wdata;
+    reg         mem_ready;
+    reg  [31:0] mem_rdata;
+
+    wire        irq_timer_ack;
+    wire        irq_external_ack;
+    wire [31:0] gpio_out;
+    wire [31:0] gpio_dir;
+    wire [31:0] gpio_in = 32'b0;
+    wire        gpio_irq;
+    wire        uart_tx;
+    wire        uart_de;
+    wire        uart_re;
+    wire        core_sleep;
+
+    localparam [11:0] ADC_CH0_VAL = 12'h145;
+    localparam [11:0] ADC_CH1_VAL = 12'h2A7;
+    localparam [11:0] ADC_CH2_VAL = 12'h3E1;
+    localparam [11:0] ADC_CH3_VAL = 12'h055;
+
+    qar_core #(
+        .IMEM_DEPTH(IMEM_WORDS),
+        .DMEM_DEPTH(DMEM_WORDS),
+        .USE_INTERNAL_IMEM(0),
+        .USE_INTERNAL_DMEM(0),
+        .IMEM_DATA_LOADS(1),
+        .ICACHE_ENTRIES(ICACHE_ENTRIES)
+    ) uut (
+        .clk(clk),
+        .rst_n(rst_n),
+        .imem_valid(imem_valid),
+        .imem_addr(imem_addr),
+        .imem_ready(imem_ready),
+        .imem_rdata(imem_rdata),
+        .mem_valid(mem_valid),
+        .mem_we(mem_we),
+        .mem_addr(mem_addr),
+        .mem_wdata(mem_wdata),
+        .mem_ready(mem_ready),
+        .mem_rdata(mem_rdata),
+        .irq_timer(1'b0),
+        .irq_external(1'b0),
+        .irq_timer_ack(irq_timer_ack),
+        .irq_external_ack(irq_external_ack),
+        .core_sleep(core_sleep),
+        .gpio_in(gpio_in),
+        .gpio_out(gpio_out),
+        .gpio_dir(gpio_dir),
+        .gpio_irq(gpio_irq),
+        .uart_tx(uart_tx),
+        .uart_rx(uart_tx),
+        .uart_de(uart_de),
+        .uart_re(uart_re),
+        .spi_sck(),
+        .spi_mosi(),
+        .spi_miso(1'b1),
+        .spi_cs_n(),
+        .i2c_scl(),
+        .i2c_sda_out(),
+        .i2c_sda_in(1'b1),
+        .i2c_sda_oe(),
+        .adc_ch0(ADC_CH0_VAL),
+        .adc_ch1(ADC_CH1_VAL),
+        .adc_ch2(ADC_CH2_VAL),
+        .adc_ch3(ADC_CH3_VAL)
+    );
+
+    reg [31:0] imem [0:IMEM_WORDS-1];
+    reg [31:0] dmem [0:DMEM_WORDS-1];
+
+    initial begin
+        $display("=== QAR-Core Firmware Benchmark ===");
+        $readmemh("program_bench.hex", imem);
+        if (PRELOAD_DMEM)
+            $readmemh("data_bench.hex", dmem);
+        imem_ready = 0;
+        mem_ready  = 0;
+        rst_n = 0;
+        #40;
+        rst_n = 1;
+    end
+
+    always #5 clk = ~clk;
+
+    always @(*) begin
+        imem_ready = imem_valid;
+        if (imem_valid)
+            imem_rdata = imem[imem_addr[IMEM_ADDR_WIDTH+1:2]];
+    end
+
+    always @(*) begin
+        mem_ready = mem_valid;
+        if (mem_valid && !mem_we)
+            mem_rdata = dmem[mem_addr[DMEM_ADDR_WIDTH+1:2]];
+    end
+
+    // Mailbox: a header word (id << 16 | bytes) followed by a cycle count
+    reg        have_header = 1'b0;
+    reg [31:0] header;
+    integer    done_count = 0;
+    integer    reports = 0;
+    integer    cycles_since_reset = 0;
+
+    always @(posedge clk) begin
+        if (!rst_n)
+            cycles_since_reset <= 0;
+        else
+            cycles_since_reset <= cycles_since_reset + 1;
+    end
+
+    function [8*16-1:0] bench_name;
+        input [15:0] id;
+        begin
+            case (id)
+                16'd0: bench_name = "memcpy aligned";
+                16'd1: bench_name = "memcpy skewed";
+                16'd2: bench_name = "memmove overlap";
+                16'd3: bench_name = "memset";
+                16'd4: bench_name = "memcmp equal";
+                16'd5: bench_name = "__mulsi3";
+                16'd6: bench_name = "__udivsi3";
+                16'd7: bench_name = "__divsi3";
+                16'd8: bench_name = "switch min";
+                16'd9: bench_name = "switch max";
+                16'd10: bench_name = "post->run min";
+                16'd11: bench_name = "post->run max";
+                16'd12: bench_name = "tick->run min";
+                16'd13: bench_name = "tick->run max";
+                16'd14: bench_name = "fir16 C multiply";
+                16'd15: bench_name = "fir16 q15";
+                16'd16: bench_name = "fir16 q31";
+                16'd17: bench_name = "biquad x2 q15";
+                16'd18: bench_name = "biquad x2 q31";
+                16'd19: bench_name = "mavg16 q15";
+                16'd20: bench_name = "fir16 decim4 q15";
+                default: bench_name = "unknown";
+            endcase
+        end
+    endfunction
+
+    always @(posedge clk) begin
+        if (mem_valid && mem_we) begin
+            if (mem_addr == MAILBOX_ADDR) begin
+                if (mem_wdata == BENCH_DONE && !have_header) begin
+                    done_count = done_count + 1;
+                end else if (mem_wdata == BENCH_MAIN && !have_header) begin
+                    $display("reset to main: %0d cycles", cycles_since_reset);
+                end else if (mem_wdata == BENCH_FAIL && !have_header) begin
+                    $display("ERROR: firmware self-check failed (.data/.bss init, runtime or filter results)");
+                    bench_finish;
+                end else if (!have_header) begin
+                    header      <= mem_wdata;
+                    have_header <= 1'b1;
+                end else begin
+                    have_header <= 1'b0;
+                    reports = reports + 1;
+                    if (header[15:0] != 0 && header[31:16] >= 16'd14)
+                        $display("%16s %4d samples: %7d cycles, %0d.%02d cycles/sample",
+                                 bench_name(header[31:16]), header[15:0], mem_wdata,
+                                 mem_wdata / header[15:0], (mem_wdata * 100 / header[15:0]) % 100);
+                    else if (header[15:0] != 0)
+                        $display("%16s %4d B: %6d cycles, %0d.%02d cycles/byte",
+                                 bench_name(header[31:16]), header[15:0], mem_wdata,
+                                 mem_wdata / header[15:0], (mem_wdata * 100 / header[15:0]) % 100);
+                    else if (header[31:16] >= 16'd8)
+                        $display("%16s      : %6d cycles", bench_name(header[31:16]), mem_wdata);
+                    else
+                        $display("%16s      : %6d cycles/call", bench_name(header[31:16]), mem_wdata);
+                end
+            end else begin
+                dmem[mem_addr[DMEM_ADDR_WIDTH+1:2]] <= mem_wdata;
+            end
+        end
+    end
+
+`ifdef QAR_PROFILE
+    // PC-sampling profile: every cycle after reset is charged to one PC and
+    // one cause. retired: the instruction leaves EX. mem: EX waits on a
+    // load, store or AMO (DMEM, IMEM data port or peripheral bus). other: EX
+    // held for any other reason. When EX is empty the bubble is charged to
+    // the consumer of a load (loaduse), or to the last instruction through
+    // EX after a taken branch/trap refill (branch) or a fetch gap (fetch).
+    // sleep: WFI. A last column counts the cycles spent between a trap and
+    // its MRET, and the header the IMEM instruction fetches (I-cache
+    // misses when ICACHE_ENTRIES is set). +profile=<path> overrides the
+    // output file.
+    localparam PROF_SLOTS   = IMEM_WORDS * 2;   // one per halfword (RVC)
+    localparam PROF_CAUSES  = 7;
+    localparam PROF_RETIRED = 0;
+    localparam PROF_MEM     = 1;
+    localparam PROF_LOADUSE = 2;
+    localparam PROF_BRANCH  = 3;
+    localparam PROF_FETCH   = 4;
+    localparam PROF_SLEEP   = 5;
+    localparam PROF_OTHER   = 6;
+
+    integer    prof_count [0:PROF_SLOTS*PROF_CAUSES-1];
+    integer    prof_trap [0:PROF_SLOTS-1];
+    integer    prof_cycles = 0;
+    integer    prof_fetches = 0;
+    reg        prof_in_trap = 1'b0;
+    integer    prof_gap = PROF_FETCH;
+    reg [31:0] prof_gap_pc = 32'b0;
+    integer    prof_i;
+
+    initial begin
+        for (prof_i = 0; prof_i < PROF_SLOTS * PROF_CAUSES; prof_i = prof_i + 1)
+            prof_count[prof_i] = 0;
+        for (prof_i = 0; prof_i < PROF_SLOTS; prof_i = prof_i + 1)
+            prof_trap[prof_i] = 0;
+    end
+
+    wire prof_mem_op = (uut.ex_instr[6:0] == 7'b0000011) || (uut.ex_instr[6:0] == 7'b0100011) ||
+                       (uut.ex_instr[6:0] == 7'b0101111);
+
+    task profile_charge;
+        input [31:0] pc;
+        input integer cause;
+        integer idx;
+        begin
+            idx = pc[IMEM_ADDR_WIDTH+1:1] * PROF_CAUSES + cause;
+            prof_count[idx] = prof_count[idx] + 1;
+            if (prof_in_trap)
+                prof_trap[pc[IMEM_ADDR_WIDTH+1:1]] = prof_trap[pc[IMEM_ADDR_WIDTH+1:1]] + 1;
+        end
+    endtask
+
+    // Samples are taken before this edge's updates land, so they describe
+    // the cycle that is ending.
+    always @(posedge clk) begin
+        if (rst_n) begin
+            prof_cycles = prof_cycles + 1;
+            if (imem_valid && imem_ready && !uut.iload_pending)
+                prof_fetches = prof_fetches + 1;
+            if (core_sleep)
+                profile_charge(uut.ex_pc, PROF_SLEEP);
+            else if (uut.ex_valid && !uut.stall_ex)
+                profile_charge(uut.ex_pc, PROF_RETIRED);
+            else if (uut.ex_valid)
+                profile_charge(uut.ex_pc, prof_mem_op ? PROF_MEM : PROF_OTHER);
+            else
+                profile_charge(prof_gap_pc, prof_gap);
+
+            // Why EX is empty next cycle, if it is
+            if (uut.trap_request || uut.flush_pipe) begin
+                prof_gap    = PROF_BRANCH;
+                prof_gap_pc = uut.ex_pc;
+            end else if (uut.load_use_hazard) begin
+                prof_gap    = PROF_LOADUSE;
+                prof_gap_pc = uut.id_pc;
+            end else if (uut.ex_valid) begin
+                prof_gap    = PROF_FETCH;
+                prof_gap_pc = uut.ex_pc;
+            end
+
+            if (uut.trap_request)
+                prof_in_trap = 1'b1;
+            else if (uut.ex_valid && !uut.stall_ex && uut.ex_instr == 32'h3020_0073)
+                prof_in_trap = 1'b0;    // MRET
+        end else begin
+            prof_in_trap = 1'b0;
+        end
+    end
+
+    task profile_dump;
+        reg [8*256-1:0] path;
+        reg [31:0]      pc;
+        integer         fd;
+        integer         slot;
+        integer         base;
+        begin
+            if (!$value$plusargs("profile=%s", path))
+                path = "profile_bench.txt";
+            fd = $fopen(path, "w");
+            $fdisplay(fd, "# qar profile: %0d cycles, %0d imem fetches", prof_cycles, prof_fetches);
+            $fdisplay(fd, "# pc retired mem loaduse branch fetch sleep other trap");
+            for (slot = 0; slot < PROF_SLOTS; slot = slot + 1) begin
+                base = slot * PROF_CAUSES;
+                if (prof_count[base] || prof_count[base+1] || prof_count[base+2] ||
+                    prof_count[base+3] || prof_count[base+4] || prof_count[base+5] ||
+                    prof_count[base+6]) begin
+                    pc = slot * 2;
+                    $fdisplay(fd, "%08h %0d %0d %0d %0d %0d %0d %0d %0d", pc,
+                              prof_count[base+PROF_RETIRED], prof_count[base+PROF_MEM],
+                              prof_count[base+PROF_LOADUSE], prof_count[base+PROF_BRANCH],
+                              prof_count[base+PROF_FETCH], prof_count[base+PROF_SLEEP],
+                              prof_count[base+PROF_OTHER], prof_trap[slot]);
+                end
+            end
+            $fclose(fd);
+            $display("profile: %0d cycles written to %0s", prof_cycles, path);
+        end
+    endtask
+`endif
+
+    task bench_finish;
+        begin
+`ifdef QAR_PROFILE
+            profile_dump;
+`endif
+            $finish;
+        end
+    endtask
+
+    integer r;
+
+    initial begin
+        for (r = 0; r < WARM_RESETS; r = r + 1) begin
+            wait (done_count == r + 1);
+            $display("warm reset %0d", r + 1);
+            @(negedge clk) rst_n = 0;
+            #40;
+            rst_n = 1;
+        end
+        wait (done_count == WARM_RESETS + 1);
+        $display("%0d results reported.", reports);
+        if (reports != BENCH_EXPECTED * (WARM_RESETS + 1)) begin
+            $display("ERROR: expected %0d benchmark results", BENCH_EXPECTED * (WARM_RESETS + 1));
+            bench_finish;
+        end
+        $display("Benchmark completed.");
+        bench_finish;
+    end
+
+    initial begin
+        #5000000;
+        $display("ERROR: benchmark did not finish");
+        bench_finish;
+    end
+
+endmodule
@@ -137,6 +137,13 @@ module qar_core_cache_tb();
             $finish;
         end
 
+        // A hit issued while ID pops IF (or the slot moves up) must not be lost
+        $display("DMEM[0] = %0d (expected 140)", dmem[0]);
+        if (dmem[0] !== 32'd140) begin
+            $display("ERROR: cached loop skipped instructions");
+            $finish;
+        end
+
         $display("IMEM request count = %0d (cache valids %0d %0d %0d %0d)", imem_req_count, uut.icache_valid[0], uut.icache_valid[1], uut.icache_valid[2], uut.icache_valid[3]);
 
         $display("Cache regression completed.");
@@ -1,6 +1,8 @@
 `timescale 1ns / 1ps
 
-module qar_core_exec_tb();
+module qar_core_exec_tb #(
+    parameter PIPELINE_STAGES = 3
+) ();
 
     localparam IMEM_WORDS      = 128;
     localparam DMEM_WORDS      = 256;
@@ -56,7 +58,8 @@ module qar_core_exec_tb();
         .IMEM_DEPTH(IMEM_WORDS),
         .DMEM_DEPTH(DMEM_WORDS),
         .USE_INTERNAL_IMEM(0),
-        .USE_INTERNAL_DMEM(0)
+        .USE_INTERNAL_DMEM(0),
+        .PIPELINE_STAGES(PIPELINE_STAGES)
     ) uut (
         .clk(clk),
         .rst_n(rst_n),
@@ -2,9 +2,9 @@
 
 module qar_core_i2c_tb();
 
-    localparam IMEM_WORDS = 64;
+    localparam IMEM_WORDS = 128;
     localparam DMEM_WORDS = 64;
-    localparam IMEM_ADDR_WIDTH = 6;
+    localparam IMEM_ADDR_WIDTH = 7;
     localparam DMEM_ADDR_WIDTH = 6;
 
     reg clk = 0;
@@ -128,6 +128,26 @@ module qar_core_i2c_tb();
             $display("ERROR: I2C status mismatch");
             $finish;
         end
+        $display("DMEM[1] = 0x%08h (expected 0x00000040)", dmem[1]);
+        $display("DMEM[2] = 0x%08h (expected 0x00020002)", dmem[2]);
+        if (dmem[1] !== 32'h0000_0040 || dmem[2] !== 32'h0002_0002) begin
+            $display("ERROR: I2C sequencer mismatch");
+            $finish;
+        end
+        $display("DMEM[3] = 0x%08h (expected 0x00000002)", dmem[3]);
+        if (dmem[3] !== 32'h0000_0002) begin
+            $display("ERROR: zero-length READ clocked a byte");
+            $finish;
+        end
+        $display("DMEM[4] = 0x%08h (expected 0x00080101)", dmem[4]);
+        $display("DMEM[5] = 0x%08h (expected 0x0000000c)", dmem[5]);
+        $display("DMEM[6] = 0x%08h (expected 0x000c0002)", dmem[6]);
+        $display("DMEM[7] = 0x%08h (expected 0x00000004)", dmem[7]);
+        if (dmem[4] !== 32'h0008_0101 || dmem[5] !== 32'd12 ||
+            dmem[6] !== 32'h000C_0002 || dmem[7] !== 32'h0000_0004) begin
+            $display("ERROR: I2C sequencer did not stall on a full RX FIFO");
+            $finish;
+        end
         $display("I2C demo completed.");
         $finish;
     end
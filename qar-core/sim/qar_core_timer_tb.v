@@ -26,7 +26,7 @@ module qar_core_timer_tb();
     wire        irq_external_ack;
     wire [31:0] gpio_out;
     wire [31:0] gpio_dir;
-    wire [31:0] gpio_in = 32'b0;
+    reg  [31:0] gpio_in = 32'b0;
     wire        gpio_irq;
     wire        uart_tx;
     wire        uart_rx_loop = 1'b1;
@@ -120,12 +120,17 @@ module qar_core_timer_tb();
             dmem[mem_addr[DMEM_ADDR_WIDTH+1:2]] <= mem_wdata;
     end
 
+    // 40-cycle pulse train on GPIO4 for the input-capture FIFO
+    always #200 gpio_in[4] = ~gpio_in[4];
+
     initial begin
         #400000;
         $display("DMEM[0] = 0x%08h (expected 0x00000001)", dmem[0]);
         $display("DMEM[1] = 0x%08h (expected 0x00000004)", dmem[1]);
         $display("DMEM[2] = 0x%08h (expected 0x00000064)", dmem[2]);
         $display("DMEM[3] = 0x%08h (expected 0x00000001)", dmem[3]);
+        $display("DMEM[4] = 0x%08h (expected 0x00000028)", dmem[4]);
+        $display("DMEM[5] = 0x%08h (expected 0x00000020)", dmem[5]);
         if (dmem[0] !== 32'h0000_0001) begin
             $display("ERROR: Timer status mismatch");
             $finish;
@@ -142,6 +147,14 @@ module qar_core_timer_tb();
             $display("ERROR: PWM status mismatch");
             $finish;
         end
+        if (dmem[4] !== 32'h0000_0028) begin
+            $display("ERROR: Input capture period mismatch");
+            $finish;
+        end
+        if (dmem[5] !== 32'h0000_0020) begin
+            $display("ERROR: Input capture watermark mismatch");
+            $finish;
+        end
         $display("Timer demo completed.");
         $finish;
     end
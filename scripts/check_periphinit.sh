@@ -0,0 +1,22 @@
+#!/bin/bash
+
+set -euo pipefail
+
+# The generated init tables (devkit/cli/periphinit.go) must write exactly
+# what the hand-written qar_sdk_init() in devkit/sdk/hal_init.c does.
+# Needs only the host C++ compiler and Go.
+
+cleanup() {
+    rm -f periphinit_go.txt periphinit_c.txt
+}
+trap cleanup EXIT
+
+make -s -C devkit/tools/initcheck
+devkit/tools/initcheck/initcheck > periphinit_c.txt
+go run ./devkit/cli periphinit | cut -d' ' -f1,2 > periphinit_go.txt
+
+if ! diff -u periphinit_c.txt periphinit_go.txt; then
+    echo "ERROR: periphinit.go init sequences differ from hal_init.c (-C, +Go)"
+    exit 1
+fi
+echo "periphinit: $(wc -l < periphinit_go.txt) stores match hal_init.c"
@@ -0,0 +1,56 @@
+#!/bin/bash
+
+set -euo pipefail
+
+cleanup() {
+    rm -f qar_core_boot_tb.out program_bench.hex data_bench.hex
+}
+trap cleanup EXIT
+
+# Needs riscv32-unknown-elf-gcc (or QAR_CC) and devkit/tools/elf2qar
+build_boot() {
+    go run ./devkit/cli build \
+        --c devkit/examples/c/boot_bench.c \
+        --march rv32i \
+        --imem 2048 \
+        --dmem 2048 \
+        --program program_bench.hex \
+        --data-out data_bench.hex \
+        "$@"
+}
+
+sim_boot() {
+    iverilog -o qar_core_boot_tb.out "$@" \
+        qar-core/rtl/regfile.v \
+        qar-core/rtl/alu.v \
+        qar-core/rtl/gpio.v \
+        qar-core/rtl/uart.v \
+        qar-core/rtl/spi.v \
+        qar-core/rtl/i2c.v \
+        qar-core/rtl/can.v \
+        qar-core/rtl/timer.v \
+        qar-core/rtl/adc.v \
+        qar-core/rtl/event_router.v \
+        qar-core/rtl/plic.v \
+        qar-core/rtl/crc.v \
+        qar-core/rtl/trace.v \
+        qar-core/rtl/rvc_expand.v \
+        qar-core/rtl/qar_core.v \
+        qar-core/sim/qar_core_bench_tb.v
+    vvp qar_core_boot_tb.out
+}
+
+echo "--- crt0 copies .data from IMEM; cold boot, then a warm reset ---"
+build_boot
+sim_boot -P qar_core_bench_tb.BENCH_EXPECTED=0 \
+    -P qar_core_bench_tb.PRELOAD_DMEM=0 \
+    -P qar_core_bench_tb.WARM_RESETS=1
+
+echo "--- .data preloaded from data.hex (--data-preloaded) ---"
+build_boot --data-preloaded
+sim_boot -P qar_core_bench_tb.BENCH_EXPECTED=0
+
+echo "--- generated init table (gpio0, timer0, uart0 only) ---"
+./scripts/check_periphinit.sh
+build_boot --periph-config devkit/examples/c/boot_bench.periph.json
+sim_boot -P qar_core_bench_tb.BENCH_EXPECTED=0
@@ -26,6 +26,11 @@ iverilog -o qar_core_cache_tb.out \
     qar-core/rtl/can.v \
     qar-core/rtl/timer.v \
     qar-core/rtl/adc.v \
+    qar-core/rtl/event_router.v \
+    qar-core/rtl/plic.v \
+    qar-core/rtl/crc.v \
+    qar-core/rtl/trace.v \
+    qar-core/rtl/rvc_expand.v \
     qar-core/rtl/qar_core.v \
     qar-core/sim/qar_core_cache_tb.v
 
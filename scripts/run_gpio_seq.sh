@@ -0,0 +1,36 @@
+#!/bin/bash
+
+set -euo pipefail
+
+cleanup() {
+    rm -f qar_core_gpio_seq_tb.out program_gpio_seq.hex data_gpio_seq.hex
+}
+trap cleanup EXIT
+
+go run ./devkit/cli build \
+    --asm devkit/examples/gpio_seq.qar \
+    --data devkit/examples/gpio_seq.data \
+    --imem 64 \
+    --dmem 64 \
+    --program program_gpio_seq.hex \
+    --data-out data_gpio_seq.hex
+
+iverilog -o qar_core_gpio_seq_tb.out \
+    qar-core/rtl/regfile.v \
+    qar-core/rtl/alu.v \
+    qar-core/rtl/gpio.v \
+    qar-core/rtl/uart.v \
+    qar-core/rtl/spi.v \
+    qar-core/rtl/i2c.v \
+    qar-core/rtl/can.v \
+    qar-core/rtl/timer.v \
+    qar-core/rtl/adc.v \
+    qar-core/rtl/event_router.v \
+    qar-core/rtl/plic.v \
+    qar-core/rtl/crc.v \
+    qar-core/rtl/trace.v \
+    qar-core/rtl/rvc_expand.v \
+    qar-core/rtl/qar_core.v \
+    qar-core/sim/qar_core_gpio_seq_tb.v
+
+vvp qar_core_gpio_seq_tb.out
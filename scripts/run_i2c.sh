@@ -10,7 +10,7 @@ trap cleanup EXIT
 go run ./devkit/cli build \
     --asm devkit/examples/i2c_loopback.qar \
     --data devkit/examples/i2c_loopback.data \
-    --imem 64 \
+    --imem 128 \
     --dmem 64 \
     --program program_i2c.hex \
     --data-out data_i2c.hex
@@ -25,6 +25,11 @@ iverilog -o qar_core_i2c_tb.out \
     qar-core/rtl/can.v \
     qar-core/rtl/timer.v \
     qar-core/rtl/adc.v \
+    qar-core/rtl/event_router.v \
+    qar-core/rtl/plic.v \
+    qar-core/rtl/crc.v \
+    qar-core/rtl/trace.v \
+    qar-core/rtl/rvc_expand.v \
     qar-core/rtl/qar_core.v \
     qar-core/sim/qar_core_i2c_tb.v
 
@@ -0,0 +1,36 @@
+#!/bin/bash
+
+set -euo pipefail
+
+cleanup() {
+    rm -f qar_core_lin_schedule_tb.out program_lin_schedule.hex data_lin_schedule.hex
+}
+trap cleanup EXIT
+
+go run ./devkit/cli build \
+    --asm devkit/examples/lin_schedule.qar \
+    --data devkit/examples/lin_schedule.data \
+    --imem 64 \
+    --dmem 64 \
+    --program program_lin_schedule.hex \
+    --data-out data_lin_schedule.hex
+
+iverilog -o qar_core_lin_schedule_tb.out \
+    qar-core/rtl/regfile.v \
+    qar-core/rtl/alu.v \
+    qar-core/rtl/gpio.v \
+    qar-core/rtl/uart.v \
+    qar-core/rtl/spi.v \
+    qar-core/rtl/i2c.v \
+    qar-core/rtl/can.v \
+    qar-core/rtl/timer.v \
+    qar-core/rtl/adc.v \
+    qar-core/rtl/event_router.v \
+    qar-core/rtl/plic.v \
+    qar-core/rtl/crc.v \
+    qar-core/rtl/trace.v \
+    qar-core/rtl/rvc_expand.v \
+    qar-core/rtl/qar_core.v \
+    qar-core/sim/qar_core_lin_schedule_tb.v
+
+vvp qar_core_lin_schedule_tb.out
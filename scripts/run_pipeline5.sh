@@ -0,0 +1,57 @@
+#!/bin/bash
+
+set -euo pipefail
+
+# Re-runs the randomized load/store regression and the interrupt/trap
+# program on the five-stage build (PIPELINE_STAGES=5).
+
+cleanup() {
+    rm -f qar_core_random_tb.out qar_core_exec_tb.out
+}
+trap cleanup EXIT
+
+RTL=(
+    qar-core/rtl/regfile.v
+    qar-core/rtl/alu.v
+    qar-core/rtl/gpio.v
+    qar-core/rtl/uart.v
+    qar-core/rtl/spi.v
+    qar-core/rtl/i2c.v
+    qar-core/rtl/can.v
+    qar-core/rtl/timer.v
+    qar-core/rtl/adc.v
+    qar-core/rtl/event_router.v
+    qar-core/rtl/plic.v
+    qar-core/rtl/crc.v
+    qar-core/rtl/trace.v
+    qar-core/rtl/rvc_expand.v
+    qar-core/rtl/qar_core.v
+)
+
+go run ./devkit/cli build \
+    --asm devkit/examples/sum_positive.qar \
+    --data devkit/examples/sum_positive.data \
+    --imem 128 \
+    --dmem 256 \
+    --program program.hex \
+    --data-out data.hex
+
+iverilog -P qar_core_random_tb.PIPELINE_STAGES=5 -o qar_core_random_tb.out \
+    "${RTL[@]}" \
+    qar-core/sim/qar_core_random_tb.v
+
+vvp qar_core_random_tb.out
+
+go run ./devkit/cli build \
+    --asm devkit/examples/irq_demo.qar \
+    --data devkit/examples/irq_demo.data \
+    --imem 128 \
+    --dmem 256 \
+    --program program.hex \
+    --data-out data.hex
+
+iverilog -P qar_core_exec_tb.PIPELINE_STAGES=5 -o qar_core_exec_tb.out \
+    "${RTL[@]}" \
+    qar-core/sim/qar_core_exec_tb.v
+
+vvp qar_core_exec_tb.out
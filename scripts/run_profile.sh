@@ -0,0 +1,61 @@
+#!/bin/bash
+
+set -euo pipefail
+
+cleanup() {
+    rm -f qar_core_profile_tb.out program_bench.hex data_bench.hex profile_bench.sym
+}
+trap cleanup EXIT
+
+# Profiles bench firmware (the DSP bench by default) and prints the flat
+# profile, cycle causes and hot basic blocks. Arguments go to
+# `qarsim profile`, e.g. --annotate qar_dsp_fir_run_q15. Another bench:
+#   PROFILE_C=devkit/examples/c/runtime_bench.c PROFILE_FLAGS= BENCH_EXPECTED=18
+# Profile-guided layout, on a core with a 64-entry I-cache:
+#   ICACHE_ENTRIES=64 ./scripts/run_profile.sh --layout-out hot.layout
+#   ICACHE_ENTRIES=64 PROFILE_FLAGS="--dsp --layout hot.layout --icache-entries 64" \
+#       ./scripts/run_profile.sh
+PROFILE_C=${PROFILE_C:-devkit/examples/c/dsp_bench.c}
+PROFILE_FLAGS=${PROFILE_FLAGS---dsp}
+BENCH_EXPECTED=${BENCH_EXPECTED:-7}
+ICACHE_ENTRIES=${ICACHE_ENTRIES:-0}
+
+# Needs riscv32-unknown-elf-gcc (or QAR_CC) and devkit/tools/elf2qar
+go run ./devkit/cli build \
+    --c "$PROFILE_C" \
+    $PROFILE_FLAGS \
+    --march rv32i \
+    --imem 2048 \
+    --dmem 2048 \
+    --symbols profile_bench.sym \
+    --program program_bench.hex \
+    --data-out data_bench.hex
+
+iverilog -o qar_core_profile_tb.out \
+    -DQAR_PROFILE \
+    -P qar_core_bench_tb.BENCH_EXPECTED="$BENCH_EXPECTED" \
+    -P qar_core_bench_tb.ICACHE_ENTRIES="$ICACHE_ENTRIES" \
+    qar-core/rtl/regfile.v \
+    qar-core/rtl/alu.v \
+    qar-core/rtl/gpio.v \
+    qar-core/rtl/uart.v \
+    qar-core/rtl/spi.v \
+    qar-core/rtl/i2c.v \
+    qar-core/rtl/can.v \
+    qar-core/rtl/timer.v \
+    qar-core/rtl/adc.v \
+    qar-core/rtl/event_router.v \
+    qar-core/rtl/plic.v \
+    qar-core/rtl/crc.v \
+    qar-core/rtl/trace.v \
+    qar-core/rtl/rvc_expand.v \
+    qar-core/rtl/qar_core.v \
+    qar-core/sim/qar_core_bench_tb.v
+
+vvp qar_core_profile_tb.out +profile=profile_bench.txt
+
+go run ./devkit/cli profile \
+    --profile profile_bench.txt \
+    --symbols profile_bench.sym \
+    --program program_bench.hex \
+    "$@"
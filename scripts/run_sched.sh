@@ -0,0 +1,39 @@
+#!/bin/bash
+
+set -euo pipefail
+
+cleanup() {
+    rm -f qar_core_sched_tb.out program_bench.hex data_bench.hex
+}
+trap cleanup EXIT
+
+# Needs riscv32-unknown-elf-gcc (or QAR_CC) and devkit/tools/elf2qar
+go run ./devkit/cli build \
+    --c devkit/examples/c/sched_bench.c \
+    --sched \
+    --march rv32i \
+    --imem 2048 \
+    --dmem 2048 \
+    --program program_bench.hex \
+    --data-out data_bench.hex
+
+iverilog -o qar_core_sched_tb.out \
+    -P qar_core_bench_tb.BENCH_EXPECTED=6 \
+    qar-core/rtl/regfile.v \
+    qar-core/rtl/alu.v \
+    qar-core/rtl/gpio.v \
+    qar-core/rtl/uart.v \
+    qar-core/rtl/spi.v \
+    qar-core/rtl/i2c.v \
+    qar-core/rtl/can.v \
+    qar-core/rtl/timer.v \
+    qar-core/rtl/adc.v \
+    qar-core/rtl/event_router.v \
+    qar-core/rtl/plic.v \
+    qar-core/rtl/crc.v \
+    qar-core/rtl/trace.v \
+    qar-core/rtl/rvc_expand.v \
+    qar-core/rtl/qar_core.v \
+    qar-core/sim/qar_core_bench_tb.v
+
+vvp qar_core_sched_tb.out
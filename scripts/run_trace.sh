@@ -0,0 +1,46 @@
+#!/bin/bash
+
+set -euo pipefail
+
+cleanup() {
+    rm -f qar_core_trace_tb.out program_trace.hex data_trace.hex trace_demo.sym
+}
+trap cleanup EXIT
+
+# Records trace_demo on the core with a 16-entry trace buffer, then
+# rebuilds the executed path from the dump with `qarsim trace`. Arguments
+# go to the decoder, e.g. --quiet for the summary only.
+go run ./devkit/cli build \
+    --asm devkit/examples/trace_demo.qar \
+    --data devkit/examples/trace_demo.data \
+    --imem 64 \
+    --dmem 64 \
+    --symbols trace_demo.sym \
+    --program program_trace.hex \
+    --data-out data_trace.hex
+
+iverilog -o qar_core_trace_tb.out \
+    qar-core/rtl/regfile.v \
+    qar-core/rtl/alu.v \
+    qar-core/rtl/gpio.v \
+    qar-core/rtl/uart.v \
+    qar-core/rtl/spi.v \
+    qar-core/rtl/i2c.v \
+    qar-core/rtl/can.v \
+    qar-core/rtl/timer.v \
+    qar-core/rtl/adc.v \
+    qar-core/rtl/event_router.v \
+    qar-core/rtl/plic.v \
+    qar-core/rtl/crc.v \
+    qar-core/rtl/trace.v \
+    qar-core/rtl/rvc_expand.v \
+    qar-core/rtl/qar_core.v \
+    qar-core/sim/qar_core_trace_tb.v
+
+vvp qar_core_trace_tb.out +trace=trace_demo.txt
+
+go run ./devkit/cli trace \
+    --trace trace_demo.txt \
+    --program program_trace.hex \
+    --symbols trace_demo.sym \
+    "$@"
@@ -0,0 +1,30 @@
+#!/bin/bash
+
+set -euo pipefail
+
+cleanup() {
+    rm -f program_wcet.hex data_wcet.hex wcet.sym
+}
+trap cleanup EXIT
+
+# Static best/worst-case cycles for the UART ISR example (its RX drain loop
+# carries a QAR_LOOP_BOUND). Arguments go to `qarsim wcet`, e.g.
+#   ./scripts/run_wcet.sh --icache-entries 64 --imem-wait 1 --budget uart_isr=400
+# Other firmware: WCET_C=... WCET_FUNCTION=f1,f2 (empty for all functions).
+WCET_C=${WCET_C:-devkit/examples/c/uart_rs485_isr.c}
+WCET_FLAGS=${WCET_FLAGS-}
+WCET_FUNCTION=${WCET_FUNCTION-uart_isr}
+
+# Needs riscv32-unknown-elf-gcc (or QAR_CC) and devkit/tools/elf2qar
+go run ./devkit/cli build \
+    --c "$WCET_C" \
+    $WCET_FLAGS \
+    --symbols wcet.sym \
+    --program program_wcet.hex \
+    --data-out data_wcet.hex
+
+go run ./devkit/cli wcet \
+    --program program_wcet.hex \
+    --symbols wcet.sym \
+    ${WCET_FUNCTION:+--function "$WCET_FUNCTION"} \
+    "$@"
@@ -0,0 +1,44 @@
+#!/bin/bash
+
+set -euo pipefail
+
+# Generic-gate Yosys synthesis of qar_core for the three- and five-stage
+# pipelines. Reports the cell count and the longest combinational path
+# (in gate levels, flip-flop to flip-flop) as a technology-independent
+# estimate of the critical path. Logs land in build/synth/.
+
+OUT_DIR=${OUT_DIR:-build/synth}
+mkdir -p "$OUT_DIR"
+
+RTL="qar-core/rtl/regfile.v \
+qar-core/rtl/alu.v \
+qar-core/rtl/gpio.v \
+qar-core/rtl/uart.v \
+qar-core/rtl/spi.v \
+qar-core/rtl/i2c.v \
+qar-core/rtl/can.v \
+qar-core/rtl/timer.v \
+qar-core/rtl/adc.v \
+qar-core/rtl/event_router.v \
+qar-core/rtl/plic.v \
+qar-core/rtl/crc.v \
+qar-core/rtl/trace.v \
+qar-core/rtl/rvc_expand.v \
+qar-core/rtl/qar_core.v"
+
+for stages in 3 5; do
+    log="$OUT_DIR/qar_core_${stages}stage.log"
+    yosys -q -l "$log" -p "
+        read_verilog $RTL
+        hierarchy -top qar_core -chparam PIPELINE_STAGES $stages
+        synth -flatten -top qar_core
+        abc -g AND,NAND,OR,NOR,XOR,XNOR,MUX
+        opt_clean
+        tee -o $OUT_DIR/stat_${stages}stage.txt stat
+        tee -o $OUT_DIR/ltp_${stages}stage.txt ltp -noff
+    " > /dev/null
+
+    cells=$(grep -E "Number of cells|^ +[0-9]+ +cells$" "$OUT_DIR/stat_${stages}stage.txt" | tail -n 1 | grep -oE "[0-9]+" | tail -n 1)
+    depth=$(grep -oE "length=[0-9]+" "$OUT_DIR/ltp_${stages}stage.txt" | tail -n 1 | cut -d= -f2)
+    printf "PIPELINE_STAGES=%s  cells=%s  longest path=%s gate levels\n" "$stages" "$cells" "$depth"
+done